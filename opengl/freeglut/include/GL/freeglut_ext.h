@@ -86,6 +86,35 @@
 
 #define  GLUT_SKIP_STALE_MOTION_EVENTS      0x0204
 
+/*
+ * The solid sphere, cone, cylinder, torus and both teapots keep their meshes
+ * in buffer objects (GL_TRUE, the default) instead of being re-emitted in
+ * immediate mode or through evaluators
+ */
+#define  GLUT_GEOMETRY_CACHE                0x0205
+
+/*
+ * Runs of motion or configure events for one window are merged into the
+ * last of them, and exposes into one redisplay (GL_TRUE, the default).
+ * The counters give the events the window system sent and the ones that
+ * reached the program; glutSetOption on a counter sets it, e.g. back to 0
+ */
+#define  GLUT_COALESCE_EVENTS               0x0206
+#define  GLUT_MOTION_EVENTS_RAW             0x0207
+#define  GLUT_MOTION_EVENTS_DELIVERED       0x0208
+#define  GLUT_CONFIGURE_EVENTS_RAW          0x0209
+#define  GLUT_CONFIGURE_EVENTS_DELIVERED    0x020A
+#define  GLUT_EXPOSE_EVENTS_RAW             0x020B
+#define  GLUT_EXPOSE_EVENTS_DELIVERED       0x020C
+
+/*
+ * Under X, glutGet answers the window position and size queries from what
+ * ConfigureNotify last said, asking the server only when that is not
+ * enough. GL_TRUE asks it every time, so the answer reflects requests the
+ * server has carried out but not told us about yet
+ */
+#define  GLUT_GEOMETRY_EXACT                0x020D
+
 /*
  * New tokens for glutInitDisplayMode.
  * Only one GLUT_AUXn bit may be used at a time.
@@ -146,12 +175,32 @@ FGAPI void    FGAPIENTRY glutMenuDestroyFunc( void (* callback)( void ) );
  */
 FGAPI void    FGAPIENTRY glutSetOption ( GLenum option_flag, int value );
 FGAPI int *   FGAPIENTRY glutGetModeValues(GLenum mode, int * size);
+FGAPI unsigned long long FGAPIENTRY glutGetElapsedTimeNs( void );
 /* A.Donev: User-data manipulation */
 FGAPI void*   FGAPIENTRY glutGetWindowData( void );
 FGAPI void    FGAPIENTRY glutSetWindowData(void* data);
 FGAPI void*   FGAPIENTRY glutGetMenuData( void );
 FGAPI void    FGAPIENTRY glutSetMenuData(void* data);
 
+/*
+ * Periodic timers, see freeglut_callbacks.c
+ */
+#define  GLUT_TIMER_CATCH_UP                0x0001
+#define  GLUT_TIMER_SKIP                    0x0002
+
+FGAPI int     FGAPIENTRY glutPeriodicTimerFunc( unsigned int period, void (* callback)( int ), int value, int policy );
+FGAPI void    FGAPIENTRY glutCancelTimer( int handle );
+
+/*
+ * File descriptors glutMainLoop waits on, see freeglut_callbacks.c
+ */
+FGAPI void    FGAPIENTRY glutFdFunc( int fd, void (* readCallback)( int ), void (* writeCallback)( int ) );
+
+/*
+ * The last frame a headless (OSMesa) window swapped, see freeglut_display.c
+ */
+FGAPI const void* FGAPIENTRY glutGetFrameBuffer( int *width, int *height );
+
 /*
  * Font stuff, see freeglut_font.c
  */
@@ -159,6 +208,9 @@ FGAPI int     FGAPIENTRY glutBitmapHeight( void* font );
 FGAPI GLfloat FGAPIENTRY glutStrokeHeight( void* font );
 FGAPI void    FGAPIENTRY glutBitmapString( void* font, const unsigned char *string );
 FGAPI void    FGAPIENTRY glutStrokeString( void* font, const unsigned char *string );
+FGAPI void    FGAPIENTRY glutTextBatchBegin( void* font, GLfloat scale );
+FGAPI void    FGAPIENTRY glutTextBatchString( GLfloat x, GLfloat y, GLfloat z, const unsigned char *string );
+FGAPI void    FGAPIENTRY glutTextBatchEnd( void );
 
 /*
  * Geometry functions, see freeglut_geometry.c
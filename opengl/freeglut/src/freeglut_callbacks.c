@@ -91,14 +91,11 @@ void FGAPIENTRY glutIdleFunc( void (* callback)( void ) )
 }
 
 /*
- * Sets the Timer callback for the current window
+ * Takes a timer hook off the unused list, or allocates a new one
  */
-void FGAPIENTRY glutTimerFunc( unsigned int timeOut, void (* callback)( int ),
-                               int timerID )
+static SFG_Timer *fghNewTimer( const char *caller )
 {
-    SFG_Timer *timer, *node;
-
-    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFunc" );
+    SFG_Timer *timer;
 
     if( (timer = fgState.FreeTimers.Last) )
     {
@@ -108,20 +105,115 @@ void FGAPIENTRY glutTimerFunc( unsigned int timeOut, void (* callback)( int ),
     {
         if( ! (timer = malloc(sizeof(SFG_Timer))) )
             fgError( "Fatal error: "
-                     "Memory allocation failure in glutTimerFunc()" );
+                     "Memory allocation failure in %s()", caller );
+    }
+
+    timer->Handle = 0;
+    timer->Period = 0;
+    timer->Policy = GLUT_TIMER_CATCH_UP;
+
+    return timer;
+}
+
+/*
+ * Sets the Timer callback for the current window
+ */
+void FGAPIENTRY glutTimerFunc( unsigned int timeOut, void (* callback)( int ),
+                               int timerID )
+{
+    SFG_Timer *timer;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFunc" );
+
+    timer = fghNewTimer( "glutTimerFunc" );
+    timer->Callback  = callback;
+    timer->ID        = timerID;
+    timer->TriggerTime = fgElapsedTimeNs() + (unsigned long long) timeOut * 1000000;
+
+    fgTimerHeapInsert( &fgState.Timers, timer );
+}
+
+/*
+ * Sets up a timer that fires every "period" milliseconds until it is
+ * cancelled. Each deadline is the previous deadline plus the period, so
+ * the time spent in the callback does not make the timer drift. When
+ * deadlines have been missed, GLUT_TIMER_CATCH_UP fires once for each of
+ * them and GLUT_TIMER_SKIP drops them and waits for the next one.
+ * Returns a handle for glutCancelTimer.
+ */
+int FGAPIENTRY glutPeriodicTimerFunc( unsigned int period, void (* callback)( int ),
+                                      int timerID, int policy )
+{
+    SFG_Timer *timer;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPeriodicTimerFunc" );
+    freeglut_return_val_if_fail( callback, 0 );
+
+    if( policy != GLUT_TIMER_CATCH_UP && policy != GLUT_TIMER_SKIP )
+    {
+        fgWarning( "glutPeriodicTimerFunc(): unknown policy %d", policy );
+        policy = GLUT_TIMER_SKIP;
     }
 
+    timer = fghNewTimer( "glutPeriodicTimerFunc" );
     timer->Callback  = callback;
     timer->ID        = timerID;
-    timer->TriggerTime = fgElapsedTime() + timeOut;
+    timer->Period    = (unsigned long long) ( period ? period : 1 ) * 1000000;
+    timer->Policy    = policy;
+    timer->Handle    = ++fgState.Timers.LastHandle;
+    timer->TriggerTime = fgElapsedTimeNs() + timer->Period;
+
+    fgTimerHeapInsert( &fgState.Timers, timer );
+
+    return timer->Handle;
+}
 
-    for( node = fgState.Timers.First; node; node = node->Node.Next )
+/*
+ * Stops a periodic timer, also from within its own callback
+ */
+void FGAPIENTRY glutCancelTimer( int handle )
+{
+    SFG_Timer *timer = fgState.Timers.Firing;
+    int i;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutCancelTimer" );
+    freeglut_return_if_fail( handle > 0 );
+
+    /* fghCheckTimers recycles it once the callback returns */
+    if( timer && timer->Handle == handle )
+    {
+        timer->Handle = 0;
+        return;
+    }
+
+    for( i = 0; i < fgState.Timers.Number; i++ )
     {
-        if( node->TriggerTime > timer->TriggerTime )
-            break;
+        timer = fgState.Timers.Timers[ i ];
+
+        if( timer->Handle == handle )
+        {
+            fgTimerHeapRemove( &fgState.Timers, timer );
+            fgListAppend( &fgState.FreeTimers, &timer->Node );
+            return;
+        }
     }
+}
+
+/*
+ * Has glutMainLoop wait on "fd" alongside the window system: readCallback
+ * is called with the descriptor whenever it is readable, writeCallback
+ * whenever it is writable. Either may be NULL, and both NULL removes the
+ * descriptor. The callbacks are dispatched as soon as the wait returns, so
+ * there is no need to poll from the idle callback. On Windows they are
+ * never called, the loop only waits on its message queue there.
+ */
+void FGAPIENTRY glutFdFunc( int fd, void (* readCallback)( int ),
+                            void (* writeCallback)( int ) )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutFdFunc" );
+    freeglut_return_if_fail( fd >= 0 );
 
-    fgListInsert( &fgState.Timers, &node->Node, &timer->Node );
+    fgWatchFd( fd, readCallback, writeCallback );
 }
 
 /*
@@ -275,6 +275,29 @@ void fghGetCursorPos(SFG_XYUse *mouse_pos)
 #endif
 
 
+#if TARGET_HOST_OSMESA
+/* Offscreen windows have no pointer; the cursor and warps are ignored */
+static void fghSetCursor ( SFG_Window *window, int cursorID )
+{
+    (void)window;
+    (void)cursorID;
+}
+
+static void fghWarpPointer ( int x, int y )
+{
+    (void)x;
+    (void)y;
+}
+
+void fghGetCursorPos(SFG_XYUse *mouse_pos)
+{
+    mouse_pos->X = fgStructure.CurrentWindow ? fgStructure.CurrentWindow->State.MouseX : 0;
+    mouse_pos->Y = fgStructure.CurrentWindow ? fgStructure.CurrentWindow->State.MouseY : 0;
+    mouse_pos->Use = GL_TRUE;
+}
+#endif
+
+
 /* -- INTERNAL FUNCTIONS ---------------------------------------------------- */
 void fgSetCursor ( SFG_Window *window, int cursorID )
 {
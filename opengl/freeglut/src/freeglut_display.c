@@ -65,6 +65,13 @@ void FGAPIENTRY glutSwapBuffers( void )
     glXSwapBuffers( fgDisplay.Display, fgStructure.CurrentWindow->Window.Handle );
 #elif TARGET_HOST_MS_WINDOWS
     SwapBuffers( fgStructure.CurrentWindow->Window.Device );
+#elif TARGET_HOST_OSMESA
+    /* The frame is only finished when the rendering has caught up */
+    glFinish( );
+    memcpy( fgStructure.CurrentWindow->Window.FrontBuffer,
+            fgStructure.CurrentWindow->Window.BackBuffer,
+            ( size_t )fgStructure.CurrentWindow->Window.BufferWidth *
+            fgStructure.CurrentWindow->Window.BufferHeight * 4 );
 #endif
 
     /* GLUT_FPS env var support */
@@ -87,6 +94,34 @@ void FGAPIENTRY glutSwapBuffers( void )
     }
 }
 
+/*
+ * Returns the current window's front buffer under OSMesa: RGBA bytes, the
+ * bottom row first as glReadPixels() has them, holding the last frame
+ * glutSwapBuffers() finished (or whatever has been drawn, single buffered).
+ * Real windows keep their pixels to themselves, so elsewhere it is NULL.
+ */
+const void* FGAPIENTRY glutGetFrameBuffer( int *width, int *height )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetFrameBuffer" );
+    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutGetFrameBuffer" );
+
+#if TARGET_HOST_OSMESA
+    if( width )
+        *width = fgStructure.CurrentWindow->Window.BufferWidth;
+    if( height )
+        *height = fgStructure.CurrentWindow->Window.BufferHeight;
+
+    return fgStructure.CurrentWindow->Window.FrontBuffer;
+#else
+    if( width )
+        *width = 0;
+    if( height )
+        *height = 0;
+
+    return NULL;
+#endif
+}
+
 /*
  * Mark appropriate window to be displayed
  */
@@ -169,14 +169,22 @@ static GLUTproc fghGetGLUTProcAddress( const char* procName )
     CHECK_NAME(glutLeaveFullScreen);
     CHECK_NAME(glutSetOption);
     CHECK_NAME(glutGetModeValues);
+    CHECK_NAME(glutGetElapsedTimeNs);
     CHECK_NAME(glutSetWindowData);
     CHECK_NAME(glutGetWindowData);
     CHECK_NAME(glutSetMenuData);
     CHECK_NAME(glutGetMenuData);
+    CHECK_NAME(glutPeriodicTimerFunc);
+    CHECK_NAME(glutCancelTimer);
+    CHECK_NAME(glutFdFunc);
+    CHECK_NAME(glutGetFrameBuffer);
     CHECK_NAME(glutBitmapHeight);
     CHECK_NAME(glutStrokeHeight);
     CHECK_NAME(glutBitmapString);
     CHECK_NAME(glutStrokeString);
+    CHECK_NAME(glutTextBatchBegin);
+    CHECK_NAME(glutTextBatchString);
+    CHECK_NAME(glutTextBatchEnd);
     CHECK_NAME(glutWireRhombicDodecahedron);
     CHECK_NAME(glutSolidRhombicDodecahedron);
     CHECK_NAME(glutWireSierpinskiSponge);
@@ -215,6 +223,8 @@ SFG_Proc fghGetProcAddress( const char *procName )
     return (SFG_Proc)wglGetProcAddress( ( LPCSTR )procName );
 #elif TARGET_HOST_POSIX_X11 && defined( GLX_ARB_get_proc_address )
     return (SFG_Proc)glXGetProcAddressARB( ( const GLubyte * )procName );
+#elif TARGET_HOST_OSMESA
+    return (SFG_Proc)OSMesaGetProcAddress( procName );
 #else
     return NULL;
 #endif
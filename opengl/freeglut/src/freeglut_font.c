@@ -92,6 +92,476 @@ static SFG_StrokeFont* fghStrokeByID( void* font )
     return 0;
 }
 
+/*
+ * Per-font data built on first use: the advance widths, shared by the
+ * measurement functions and the text batches, the stroke glyphs as
+ * GL_LINES segments and the bitmap glyphs packed into an alpha texture.
+ */
+#define  FREEGLUT_BITMAP_FONTS  7
+#define  FREEGLUT_STROKE_FONTS  2
+#define  FREEGLUT_ATLAS_WIDTH   256
+
+typedef struct tagSFG_FontCache SFG_FontCache;
+struct tagSFG_FontCache
+{
+    GLboolean        Metrics;           /* Advance[] has been filled in     */
+    GLfloat          Advance[ 256 ];    /* Per character, 0 if missing      */
+
+    GLfloat         *Lines;             /* Stroke: x,y of the GL_LINES      */
+    int              First[ 256 ];      /* First line vertex of a glyph     */
+    int              Count[ 256 ];      /* Number of line vertices          */
+
+    GLubyte         *Atlas;             /* Bitmap: GL_ALPHA texels          */
+    int              AtlasHeight;       /* The width is fixed               */
+    int              Cell[ 256 ][ 2 ];  /* Lower left texel of each glyph   */
+    SFG_WindowContextType Context;      /* The context owning the texture   */
+    GLuint           Texture;
+};
+
+static SFG_Font* const fghBitmapFonts[ FREEGLUT_BITMAP_FONTS ] =
+{
+    &fgFontFixed8x13, &fgFontFixed9x15, &fgFontHelvetica10, &fgFontHelvetica12,
+    &fgFontHelvetica18, &fgFontTimesRoman10, &fgFontTimesRoman24
+};
+static SFG_StrokeFont* const fghStrokeFonts[ FREEGLUT_STROKE_FONTS ] =
+{
+    &fgStrokeRoman, &fgStrokeMonoRoman
+};
+
+static SFG_FontCache fghBitmapCaches[ FREEGLUT_BITMAP_FONTS ];
+static SFG_FontCache fghStrokeCaches[ FREEGLUT_STROKE_FONTS ];
+
+/*
+ * Returns the cache of a bitmap font with its metrics filled in
+ */
+static SFG_FontCache* fghBitmapMetrics( SFG_Font* font )
+{
+    SFG_FontCache* cache = NULL;
+    int i;
+
+    for( i = 0; i < FREEGLUT_BITMAP_FONTS; i++ )
+        if( fghBitmapFonts[ i ] == font )
+            cache = &fghBitmapCaches[ i ];
+
+    if( cache && !cache->Metrics )
+    {
+        for( i = 0; i < 256 && i < font->Quantity; i++ )
+            cache->Advance[ i ] = font->Characters[ i ] ? font->Characters[ i ][ 0 ] : 0.0f;
+        cache->Metrics = GL_TRUE;
+    }
+
+    return cache;
+}
+
+/*
+ * Returns the cache of a stroke font with its metrics filled in
+ */
+static SFG_FontCache* fghStrokeMetrics( SFG_StrokeFont* font )
+{
+    SFG_FontCache* cache = NULL;
+    int i;
+
+    for( i = 0; i < FREEGLUT_STROKE_FONTS; i++ )
+        if( fghStrokeFonts[ i ] == font )
+            cache = &fghStrokeCaches[ i ];
+
+    if( cache && !cache->Metrics )
+    {
+        for( i = 0; i < 256 && i < font->Quantity; i++ )
+            cache->Advance[ i ] = font->Characters[ i ] ? font->Characters[ i ]->Right : 0.0f;
+        cache->Metrics = GL_TRUE;
+    }
+
+    return cache;
+}
+
+/*
+ * Breaks every strip of every stroke glyph into GL_LINES segments
+ */
+static void fghBuildStrokeLines( SFG_FontCache* cache, SFG_StrokeFont* font )
+{
+    int c, i, j, total = 0;
+    GLfloat* line;
+
+    for( c = 0; c < 256 && c < font->Quantity; c++ )
+        if( font->Characters[ c ] )
+            for( i = 0; i < font->Characters[ c ]->Number; i++ )
+                if( font->Characters[ c ]->Strips[ i ].Number > 1 )
+                    total += 2 * ( font->Characters[ c ]->Strips[ i ].Number - 1 );
+
+    line = cache->Lines = (GLfloat *) malloc( sizeof( GLfloat ) * 2 * ( total ? total : 1 ) );
+    if( !cache->Lines )
+        fgError( "Failed to allocate memory in fghBuildStrokeLines" );
+
+    total = 0;
+    for( c = 0; c < 256 && c < font->Quantity; c++ )
+    {
+        cache->First[ c ] = total;
+
+        if( font->Characters[ c ] )
+            for( i = 0; i < font->Characters[ c ]->Number; i++ )
+            {
+                const SFG_StrokeStrip* strip = &font->Characters[ c ]->Strips[ i ];
+
+                for( j = 1; j < strip->Number; j++ )
+                {
+                    *line++ = strip->Vertices[ j - 1 ].X;
+                    *line++ = strip->Vertices[ j - 1 ].Y;
+                    *line++ = strip->Vertices[ j ].X;
+                    *line++ = strip->Vertices[ j ].Y;
+                    total += 2;
+                }
+            }
+
+        cache->Count[ c ] = total - cache->First[ c ];
+    }
+}
+
+/*
+ * Unpacks the glBitmap glyphs, one bit per pixel and bottom row first,
+ * into rows of cells in an alpha texture with a texel of space around them
+ */
+static void fghBuildBitmapAtlas( SFG_FontCache* cache, SFG_Font* font )
+{
+    int c, x = 1, y = 1, height, row, col;
+
+    /* Lay the cells out first to find how tall the texture has to be */
+    for( c = 1; c < 256 && c < font->Quantity; c++ )
+    {
+        int width = font->Characters[ c ] ? font->Characters[ c ][ 0 ] : 0;
+
+        if( x + width + 1 > FREEGLUT_ATLAS_WIDTH )
+        {
+            x = 1;
+            y += font->Height + 1;
+        }
+        cache->Cell[ c ][ 0 ] = x;
+        cache->Cell[ c ][ 1 ] = y;
+        x += width + 1;
+    }
+
+    for( height = 1; height < y + font->Height + 1; height *= 2 )
+        ;
+
+    cache->AtlasHeight = height;
+    cache->Atlas = (GLubyte *) calloc( FREEGLUT_ATLAS_WIDTH * height, 1 );
+    if( !cache->Atlas )
+        fgError( "Failed to allocate memory in fghBuildBitmapAtlas" );
+
+    for( c = 1; c < 256 && c < font->Quantity; c++ )
+    {
+        const GLubyte* face = font->Characters[ c ];
+        int pitch;
+
+        if( !face )
+            continue;
+
+        pitch = ( face[ 0 ] + 7 ) / 8;
+        for( row = 0; row < font->Height; row++ )
+            for( col = 0; col < face[ 0 ]; col++ )
+                if( face[ 1 + row * pitch + col / 8 ] & ( 0x80 >> ( col % 8 ) ) )
+                    cache->Atlas[ ( cache->Cell[ c ][ 1 ] + row ) * FREEGLUT_ATLAS_WIDTH +
+                                  cache->Cell[ c ][ 0 ] + col ] = 255;
+    }
+}
+
+/*
+ * Creates a texture from the atlas in the current context
+ */
+static GLuint fghUploadBitmapAtlas( SFG_FontCache* cache )
+{
+    GLuint texture;
+
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP );
+
+    glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH,  0 );
+    glPixelStorei( GL_UNPACK_SKIP_ROWS,   0 );
+    glPixelStorei( GL_UNPACK_SKIP_PIXELS, 0 );
+    glPixelStorei( GL_UNPACK_ALIGNMENT,   1 );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_ALPHA, FREEGLUT_ATLAS_WIDTH, cache->AtlasHeight, 0,
+                  GL_ALPHA, GL_UNSIGNED_BYTE, cache->Atlas );
+    glPopClientAttrib( );
+
+    return texture;
+}
+
+/*
+ * The text batch: strings are laid out into one client-side vertex stream
+ * as they come in and drawn with a single call at glutTextBatchEnd. The
+ * stream is kept between batches so steady state drawing allocates nothing.
+ */
+typedef struct tagSFG_StrokeTextVertex SFG_StrokeTextVertex;
+struct tagSFG_StrokeTextVertex          /* GL_C4UB_V3F */
+{
+    GLubyte          Color[ 4 ];
+    GLfloat          Position[ 3 ];
+};
+
+typedef struct tagSFG_BitmapTextVertex SFG_BitmapTextVertex;
+struct tagSFG_BitmapTextVertex          /* GL_T2F_C4UB_V3F */
+{
+    GLfloat          TexCoord[ 2 ];
+    GLubyte          Color[ 4 ];
+    GLfloat          Position[ 3 ];
+};
+
+typedef struct tagSFG_TextBatch SFG_TextBatch;
+struct tagSFG_TextBatch
+{
+    SFG_Font*        Font;              /* Exactly one of these two is set  */
+    SFG_StrokeFont*  Stroke;            /* while a batch is open            */
+    SFG_FontCache*   Cache;
+    GLfloat          Scale;
+
+    GLdouble         Modelview[ 16 ];   /* Bitmap text is placed like       */
+    GLdouble         Projection[ 16 ];  /* glRasterPos would place it       */
+    GLint            Viewport[ 4 ];
+
+    void*            Vertices;
+    int              NumVertices, MaxVertices;
+    size_t           VertexSize;
+};
+
+static SFG_TextBatch fghTextBatch;
+
+/*
+ * Makes room for count more vertices in the stream, returning the first
+ */
+static void* fghTextVertices( int count )
+{
+    void* first;
+
+    if( fghTextBatch.NumVertices + count > fghTextBatch.MaxVertices )
+    {
+        while( fghTextBatch.NumVertices + count > fghTextBatch.MaxVertices )
+            fghTextBatch.MaxVertices = fghTextBatch.MaxVertices ? fghTextBatch.MaxVertices * 2 : 1024;
+
+        /* Sized for the larger vertex, so the stream serves both kinds of font */
+        fghTextBatch.Vertices = realloc( fghTextBatch.Vertices,
+                                         sizeof( SFG_BitmapTextVertex ) * fghTextBatch.MaxVertices );
+        if( !fghTextBatch.Vertices )
+            fgError( "Failed to allocate memory in fghTextVertices" );
+    }
+
+    first = (GLubyte *) fghTextBatch.Vertices + fghTextBatch.VertexSize * fghTextBatch.NumVertices;
+    fghTextBatch.NumVertices += count;
+
+    return first;
+}
+
+static void fghTextColor( GLubyte color[ 4 ] )
+{
+    GLfloat current[ 4 ];
+    int i;
+
+    glGetFloatv( GL_CURRENT_COLOR, current );
+    for( i = 0; i < 4; i++ )
+        color[ i ] = (GLubyte) ( current[ i ] <= 0.0f ? 0 : current[ i ] >= 1.0f ? 255 : current[ i ] * 255.0f + 0.5f );
+}
+
+static void fghStrokeBatchString( GLfloat x, GLfloat y, GLfloat z, const unsigned char* string )
+{
+    SFG_StrokeFont* font = fghTextBatch.Stroke;
+    SFG_FontCache* cache = fghTextBatch.Cache;
+    const GLfloat scale = fghTextBatch.Scale;
+    GLfloat pen = 0.0f, line = 0.0f;
+    GLubyte color[ 4 ];
+    unsigned char c;
+    int i;
+
+    fghTextColor( color );
+
+    while( ( c = *string++) )
+        if( c < font->Quantity )
+        {
+            if( c == '\n' )
+            {
+                pen = 0.0f;
+                line -= font->Height;
+            }
+            else
+            {
+                const GLfloat* glyph = cache->Lines + 2 * cache->First[ c ];
+                SFG_StrokeTextVertex* vertex = (SFG_StrokeTextVertex *) fghTextVertices( cache->Count[ c ] );
+
+                for( i = 0; i < cache->Count[ c ]; i++, vertex++, glyph += 2 )
+                {
+                    memcpy( vertex->Color, color, 4 );
+                    vertex->Position[ 0 ] = x + ( pen  + glyph[ 0 ] ) * scale;
+                    vertex->Position[ 1 ] = y + ( line + glyph[ 1 ] ) * scale;
+                    vertex->Position[ 2 ] = z;
+                }
+
+                pen += cache->Advance[ c ];
+            }
+        }
+}
+
+static void fghBitmapBatchString( GLfloat x, GLfloat y, GLfloat z, const unsigned char* string )
+{
+    SFG_Font* font = fghTextBatch.Font;
+    SFG_FontCache* cache = fghTextBatch.Cache;
+    const GLfloat scale = fghTextBatch.Scale;
+    const GLdouble* m = fghTextBatch.Modelview;
+    const GLdouble* p = fghTextBatch.Projection;
+    const GLint* viewport = fghTextBatch.Viewport;
+    GLdouble eye[ 4 ], clip[ 4 ];
+    GLfloat left, bottom, depth, pen = 0.0f, line = 0.0f;
+    GLubyte color[ 4 ];
+    unsigned char c;
+    int i;
+
+    /* Project the origin the way glRasterPos does, dropping the string if it is clipped */
+    for( i = 0; i < 4; i++ )
+        eye[ i ] = m[ i ] * x + m[ 4 + i ] * y + m[ 8 + i ] * z + m[ 12 + i ];
+    for( i = 0; i < 4; i++ )
+        clip[ i ] = p[ i ] * eye[ 0 ] + p[ 4 + i ] * eye[ 1 ] + p[ 8 + i ] * eye[ 2 ] + p[ 12 + i ] * eye[ 3 ];
+
+    for( i = 0; i < 3; i++ )
+        if( clip[ i ] < -clip[ 3 ] || clip[ i ] > clip[ 3 ] )
+            return;
+    if( clip[ 3 ] <= 0.0 )
+        return;
+
+    left   = (GLfloat) floor( viewport[ 0 ] + ( clip[ 0 ] / clip[ 3 ] + 1.0 ) * 0.5 * viewport[ 2 ] - font->xorig );
+    bottom = (GLfloat) floor( viewport[ 1 ] + ( clip[ 1 ] / clip[ 3 ] + 1.0 ) * 0.5 * viewport[ 3 ] - font->yorig );
+    depth  = (GLfloat) -( clip[ 2 ] / clip[ 3 ] + 1.0 ) * 0.5f;
+
+    fghTextColor( color );
+
+    while( ( c = *string++) )
+        if( c == '\n' )
+        {
+            pen = 0.0f;
+            line -= font->Height * scale;
+        }
+        else if( c < font->Quantity && cache->Advance[ c ] > 0.0f )
+        {
+            SFG_BitmapTextVertex* vertex = (SFG_BitmapTextVertex *) fghTextVertices( 4 );
+            const GLfloat s0 = (GLfloat) cache->Cell[ c ][ 0 ] / FREEGLUT_ATLAS_WIDTH;
+            const GLfloat t0 = (GLfloat) cache->Cell[ c ][ 1 ] / cache->AtlasHeight;
+            const GLfloat s1 = s0 + cache->Advance[ c ] / FREEGLUT_ATLAS_WIDTH;
+            const GLfloat t1 = t0 + (GLfloat) font->Height / cache->AtlasHeight;
+            const GLfloat x0 = left + pen, x1 = x0 + cache->Advance[ c ] * scale;
+            const GLfloat y0 = bottom + line, y1 = y0 + font->Height * scale;
+
+#           define  Q(n,s,t,px,py) vertex[n].TexCoord[0] = s; vertex[n].TexCoord[1] = t; \
+                                   memcpy( vertex[n].Color, color, 4 ); \
+                                   vertex[n].Position[0] = px; vertex[n].Position[1] = py; vertex[n].Position[2] = depth;
+            Q( 0, s0, t0, x0, y0 );
+            Q( 1, s1, t0, x1, y0 );
+            Q( 2, s1, t1, x1, y1 );
+            Q( 3, s0, t1, x0, y1 );
+#           undef Q
+
+            pen += cache->Advance[ c ] * scale;
+        }
+}
+
+static void fghStrokeBatchDraw( void )
+{
+    glPushAttrib( GL_CURRENT_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    fgBindClientArrays( );
+    glInterleavedArrays( GL_C4UB_V3F, 0, fghTextBatch.Vertices );
+    glDrawArrays( GL_LINES, 0, fghTextBatch.NumVertices );
+    glPopClientAttrib( );
+    glPopAttrib( );
+}
+
+static void fghBitmapBatchDraw( void )
+{
+    SFG_FontCache* cache = fghTextBatch.Cache;
+    SFG_WindowContextType context = fgCurrentContext( );
+    const GLint* viewport = fghTextBatch.Viewport;
+    GLuint texture;
+
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT | GL_TRANSFORM_BIT | GL_CURRENT_BIT );
+
+    /* The texture lives in the context that first drew the font, others get a temporary one */
+    if( !cache->Texture )
+    {
+        cache->Texture = fghUploadBitmapAtlas( cache );
+        cache->Context = context;
+    }
+    if( cache->Context == context )
+    {
+        texture = cache->Texture;
+        glBindTexture( GL_TEXTURE_2D, texture );
+    }
+    else
+        texture = fghUploadBitmapAtlas( cache );
+
+    /* glBitmap only ever writes the raster colour where a bit is set */
+    glDisable( GL_LIGHTING );
+    glDisable( GL_FOG );
+    glDisable( GL_CULL_FACE );
+    glDisable( GL_TEXTURE_GEN_S );
+    glDisable( GL_TEXTURE_GEN_T );
+    glEnable( GL_TEXTURE_2D );
+    glEnable( GL_ALPHA_TEST );
+    glAlphaFunc( GL_GREATER, 0.5f );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+
+    /* Window coordinates, with the depth of each string's origin in -z */
+    glMatrixMode( GL_TEXTURE );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glOrtho( viewport[ 0 ], viewport[ 0 ] + viewport[ 2 ], viewport[ 1 ], viewport[ 1 ] + viewport[ 3 ], 0.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix( );
+    glLoadIdentity( );
+
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    fgBindClientArrays( );
+    glInterleavedArrays( GL_T2F_C4UB_V3F, 0, fghTextBatch.Vertices );
+    glDrawArrays( GL_QUADS, 0, fghTextBatch.NumVertices );
+    glPopClientAttrib( );
+
+    glPopMatrix( );
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix( );
+    glMatrixMode( GL_TEXTURE );
+    glPopMatrix( );
+
+    if( texture != cache->Texture )
+        glDeleteTextures( 1, &texture );
+
+    glPopAttrib( );
+}
+
+/*
+ * Frees the font caches and the text batch stream. The atlas textures
+ * went away with their contexts.
+ */
+void fgDestroyFontCache( void )
+{
+    int i;
+
+    for( i = 0; i < FREEGLUT_BITMAP_FONTS; i++ )
+    {
+        free( fghBitmapCaches[ i ].Atlas );
+        memset( &fghBitmapCaches[ i ], 0, sizeof( SFG_FontCache ) );
+    }
+    for( i = 0; i < FREEGLUT_STROKE_FONTS; i++ )
+    {
+        free( fghStrokeCaches[ i ].Lines );
+        memset( &fghStrokeCaches[ i ], 0, sizeof( SFG_FontCache ) );
+    }
+
+    free( fghTextBatch.Vertices );
+    memset( &fghTextBatch, 0, sizeof( SFG_TextBatch ) );
+}
+
 
 /* -- INTERFACE FUNCTIONS -------------------------------------------------- */
 
@@ -185,7 +655,7 @@ int FGAPIENTRY glutBitmapWidth( void* fontID, int character )
     font = fghFontByID( fontID );
     freeglut_return_val_if_fail( character > 0 && character < 256, 0 );
     freeglut_return_val_if_fail( font, 0 );
-    return *( font->Characters[ character ] );
+    return ( int )fghBitmapMetrics( font )->Advance[ character ];
 }
 
 /*
@@ -196,16 +666,19 @@ int FGAPIENTRY glutBitmapLength( void* fontID, const unsigned char* string )
     unsigned char c;
     int length = 0, this_line_length = 0;
     SFG_Font* font;
+    const GLfloat* advance;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutBitmapLength" );
     font = fghFontByID( fontID );
     freeglut_return_val_if_fail( font, 0 );
     if ( !string || ! *string )
         return 0;
 
+    advance = fghBitmapMetrics( font )->Advance;
+
     while( ( c = *string++) )
     {
         if( c != '\n' )/* Not an EOL, increment length of line */
-            this_line_length += *( font->Characters[ c ]);
+            this_line_length += ( int )advance[ c ];
         else  /* EOL; reset the length of this line */
         {
             if( length < this_line_length )
@@ -318,19 +791,16 @@ void FGAPIENTRY glutStrokeString( void* fontID, const unsigned char *string )
  */
 int FGAPIENTRY glutStrokeWidth( void* fontID, int character )
 {
-    const SFG_StrokeChar *schar;
     SFG_StrokeFont* font;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeWidth" );
     font = fghStrokeByID( fontID );
+    freeglut_return_val_if_fail( font, 0 );
     freeglut_return_val_if_fail( ( character >= 0 ) &&
                                  ( character < font->Quantity ),
                                  0
     );
-    freeglut_return_val_if_fail( font, 0 );
-    schar = font->Characters[ character ];
-    freeglut_return_val_if_fail( schar, 0 );
 
-    return ( int )( schar->Right + 0.5 );
+    return ( int )( fghStrokeMetrics( font )->Advance[ character ] + 0.5 );
 }
 
 /*
@@ -342,12 +812,15 @@ int FGAPIENTRY glutStrokeLength( void* fontID, const unsigned char* string )
     float length = 0.0;
     float this_line_length = 0.0;
     SFG_StrokeFont* font;
+    const GLfloat* advance;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeLength" );
     font = fghStrokeByID( fontID );
     freeglut_return_val_if_fail( font, 0 );
     if ( !string || ! *string )
         return 0;
 
+    advance = fghStrokeMetrics( font )->Advance;
+
     while( ( c = *string++) )
         if( c < font->Quantity )
         {
@@ -358,11 +831,7 @@ int FGAPIENTRY glutStrokeLength( void* fontID, const unsigned char* string )
                 this_line_length = 0.0;
             }
             else  /* Not an EOL, increment the length of this line */
-            {
-                const SFG_StrokeChar *schar = font->Characters[ c ];
-                if( schar )
-                    this_line_length += schar->Right;
-            }
+                this_line_length += advance[ c ];
         }
     if( length < this_line_length )
         length = this_line_length;
@@ -381,4 +850,91 @@ GLfloat FGAPIENTRY glutStrokeHeight( void* fontID )
     return font->Height;
 }
 
+/*
+ * Opens a text batch for a bitmap or stroke font. Strings added with
+ * glutTextBatchString are laid out into one vertex stream and drawn with a
+ * single call by glutTextBatchEnd.
+ *
+ * Stroke text is drawn as lines in the current modelview space, scaled by
+ * "scale" from font units. Bitmap text is positioned like glRasterPos with
+ * the matrices and viewport current at glutTextBatchBegin, and "scale"
+ * magnifies the glyphs in whole window pixels.
+ */
+void FGAPIENTRY glutTextBatchBegin( void* fontID, GLfloat scale )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTextBatchBegin" );
+
+    if( fghTextBatch.Font || fghTextBatch.Stroke )
+    {
+        fgWarning( "glutTextBatchBegin(): a text batch is already open" );
+        return;
+    }
+
+    fghTextBatch.Scale = scale;
+    fghTextBatch.NumVertices = 0;
+
+    if( fontID == GLUT_STROKE_ROMAN || fontID == GLUT_STROKE_MONO_ROMAN )
+    {
+        fghTextBatch.Stroke = fghStrokeByID( fontID );
+        fghTextBatch.Cache = fghStrokeMetrics( fghTextBatch.Stroke );
+        fghTextBatch.VertexSize = sizeof( SFG_StrokeTextVertex );
+
+        if( !fghTextBatch.Cache->Lines )
+            fghBuildStrokeLines( fghTextBatch.Cache, fghTextBatch.Stroke );
+    }
+    else
+    {
+        fghTextBatch.Font = fghFontByID( fontID );
+        freeglut_return_if_fail( fghTextBatch.Font );
+        fghTextBatch.Cache = fghBitmapMetrics( fghTextBatch.Font );
+        fghTextBatch.VertexSize = sizeof( SFG_BitmapTextVertex );
+
+        if( !fghTextBatch.Cache->Atlas )
+            fghBuildBitmapAtlas( fghTextBatch.Cache, fghTextBatch.Font );
+
+        glGetDoublev( GL_MODELVIEW_MATRIX, fghTextBatch.Modelview );
+        glGetDoublev( GL_PROJECTION_MATRIX, fghTextBatch.Projection );
+        glGetIntegerv( GL_VIEWPORT, fghTextBatch.Viewport );
+    }
+}
+
+/*
+ * Adds a string to the open batch at (x, y, z), in the current colour.
+ * A newline starts the next line under the string's origin.
+ */
+void FGAPIENTRY glutTextBatchString( GLfloat x, GLfloat y, GLfloat z, const unsigned char* string )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTextBatchString" );
+    if( !string || ! *string )
+        return;
+
+    if( fghTextBatch.Stroke )
+        fghStrokeBatchString( x, y, z, string );
+    else if( fghTextBatch.Font )
+        fghBitmapBatchString( x, y, z, string );
+    else
+        fgWarning( "glutTextBatchString(): no text batch is open" );
+}
+
+/*
+ * Draws everything added to the batch and closes it
+ */
+void FGAPIENTRY glutTextBatchEnd( void )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTextBatchEnd" );
+
+    if( fghTextBatch.NumVertices )
+    {
+        if( fghTextBatch.Stroke )
+            fghStrokeBatchDraw( );
+        else if( fghTextBatch.Font )
+            fghBitmapBatchDraw( );
+    }
+
+    fghTextBatch.Font = NULL;
+    fghTextBatch.Stroke = NULL;
+    fghTextBatch.Cache = NULL;
+    fghTextBatch.NumVertices = 0;
+}
+
 /*** END OF FILE ***/
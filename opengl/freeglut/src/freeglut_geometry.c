@@ -27,6 +27,7 @@
 
 #include <GL/freeglut.h>
 #include "freeglut_internal.h"
+#include <stddef.h>
 
 /*
  * TODO BEFORE THE STABLE RELEASE:
@@ -111,11 +112,77 @@ void FGAPIENTRY glutSolidCube( GLdouble dSize )
 #   undef N
 }
 
+/* -- SCRATCH MEMORY ------------------------------------------------------ */
+
+/*
+ * The sin/cos tables and the torus vertices only live for one call, and
+ * used to be calloc'd and freed on every call. They now come from a linear
+ * arena that each shape rewinds when it is done with them. What does not
+ * fit is allocated on its own and freed at the rewind, which grows the
+ * arena to what the shape needed, so drawing the same shapes again does
+ * not touch the heap at all.
+ */
+#define  FREEGLUT_SCRATCH_SPILLS  8
+
+static char   *fghScratch = NULL;
+static size_t  fghScratchSize = 0;
+static size_t  fghScratchUsed = 0;
+static size_t  fghScratchWanted = 0;
+static void   *fghScratchSpills[ FREEGLUT_SCRATCH_SPILLS ];
+static int     fghScratchNumSpills = 0;
+
+/*
+ * Uninitialised room for "count" doubles, until the next fghScratchRewind
+ */
+static double *fghScratchDoubles( size_t count )
+{
+    size_t bytes = count * sizeof( double );
+    void *memory;
+
+    fghScratchWanted += bytes;
+
+    if( fghScratchUsed + bytes <= fghScratchSize )
+    {
+        memory = fghScratch + fghScratchUsed;
+        fghScratchUsed += bytes;
+        return (double *) memory;
+    }
+
+    /* Bail out if memory allocation fails, fgError never returns */
+
+    memory = fghScratchNumSpills < FREEGLUT_SCRATCH_SPILLS ? malloc( bytes ) : NULL;
+    if( !memory )
+        fgError( "Failed to allocate memory in fghScratchDoubles" );
+    fghScratchSpills[ fghScratchNumSpills++ ] = memory;
+    return (double *) memory;
+}
+
+/*
+ * Releases everything taken since the last rewind
+ */
+static void fghScratchRewind( void )
+{
+    while( fghScratchNumSpills )
+        free( fghScratchSpills[ --fghScratchNumSpills ] );
+
+    if( fghScratchWanted > fghScratchSize )
+    {
+        free( fghScratch );
+        fghScratch = (char *) malloc( fghScratchWanted );
+        if( !fghScratch )
+            fgError( "Failed to allocate memory in fghScratchRewind" );
+        fghScratchSize = fghScratchWanted;
+    }
+
+    fghScratchUsed = 0;
+    fghScratchWanted = 0;
+}
+
 /*
  * Compute lookup table of cos and sin values forming a cirle
  *
  * Notes:
- *    It is the responsibility of the caller to free these tables
+ *    The tables are scratch memory, the caller rewinds it when done
  *    The size of the table is (n+1) to form a connected loop
  *    The last entry is exactly the same as the first
  *    The sign of n can be flipped to get the reverse loop
@@ -133,19 +200,10 @@ static void fghCircleTable(double **sint,double **cost,const int n)
 
     const double angle = 2*M_PI/(double)( ( n == 0 ) ? 1 : n );
 
-    /* Allocate memory for n samples, plus duplicate of first entry at the end */
+    /* Room for n samples, plus duplicate of first entry at the end */
 
-    *sint = (double *) calloc(sizeof(double), size+1);
-    *cost = (double *) calloc(sizeof(double), size+1);
-
-    /* Bail out if memory allocation fails, fgError never returns */
-
-    if (!(*sint) || !(*cost))
-    {
-        free(*sint);
-        free(*cost);
-        fgError("Failed to allocate memory in fghCircleTable");
-    }
+    *sint = fghScratchDoubles( size+1 );
+    *cost = fghScratchDoubles( size+1 );
 
     /* Compute cos and sin around the circle */
 
@@ -164,6 +222,528 @@ static void fghCircleTable(double **sint,double **cost,const int n)
     (*cost)[size] = (*cost)[0];
 }
 
+/* -- SHAPE CACHE ---------------------------------------------------------- */
+
+/*
+ * The solid sphere, cone, cylinder and torus used to rebuild their sin/cos
+ * tables and push every vertex through immediate mode on each call. They
+ * are now generated once per set of parameters as an indexed mesh (same
+ * vertices, normals and winding as the immediate mode code below) and drawn
+ * from buffer objects with a single glDrawElements. The teapot shares the
+ * cache through the fg* functions.
+ *
+ * Buffers belong to the context that was current when the mesh was first
+ * drawn; other contexts draw the same mesh from client memory. The cache is
+ * kept most-recently-used first and trimmed to FREEGLUT_GEOMETRY_CACHE_SIZE.
+ */
+#define  FREEGLUT_GEOMETRY_CACHE_SIZE  64
+
+/*
+ * Buffer object entry points, resolved on first use. They are only
+ * trusted when the context reports GL 1.5 or ARB_vertex_buffer_object,
+ * since glXGetProcAddress happily returns pointers for anything.
+ */
+#ifndef GL_ARRAY_BUFFER
+#   define GL_ARRAY_BUFFER          0x8892
+#   define GL_ELEMENT_ARRAY_BUFFER  0x8893
+#   define GL_STATIC_DRAW           0x88E4
+#endif
+
+typedef void (APIENTRY *FGH_PFNGLGENBUFFERSPROC)( GLsizei n, GLuint *buffers );
+typedef void (APIENTRY *FGH_PFNGLDELETEBUFFERSPROC)( GLsizei n, const GLuint *buffers );
+typedef void (APIENTRY *FGH_PFNGLBINDBUFFERPROC)( GLenum target, GLuint buffer );
+typedef void (APIENTRY *FGH_PFNGLBUFFERDATAPROC)( GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage );
+
+static GLboolean                  fghBuffersResolved = GL_FALSE;
+static FGH_PFNGLGENBUFFERSPROC    fghGenBuffers      = NULL;
+static FGH_PFNGLDELETEBUFFERSPROC fghDeleteBuffers   = NULL;
+static FGH_PFNGLBINDBUFFERPROC    fghBindBuffer      = NULL;
+static FGH_PFNGLBUFFERDATAPROC    fghBufferData      = NULL;
+
+static void fghResolveBufferProcs( void )
+{
+    const char *version = (const char *) glGetString( GL_VERSION );
+    int major = 0, minor = 0;
+
+    fghBuffersResolved = GL_TRUE;
+
+    if( version )
+        sscanf( version, "%d.%d", &major, &minor );
+
+    if( major > 1 || ( major == 1 && minor >= 5 ) )
+    {
+        fghGenBuffers    = (FGH_PFNGLGENBUFFERSPROC)    fghGetProcAddress( "glGenBuffers" );
+        fghDeleteBuffers = (FGH_PFNGLDELETEBUFFERSPROC) fghGetProcAddress( "glDeleteBuffers" );
+        fghBindBuffer    = (FGH_PFNGLBINDBUFFERPROC)    fghGetProcAddress( "glBindBuffer" );
+        fghBufferData    = (FGH_PFNGLBUFFERDATAPROC)    fghGetProcAddress( "glBufferData" );
+    }
+    else if( glutExtensionSupported( "GL_ARB_vertex_buffer_object" ) )
+    {
+        fghGenBuffers    = (FGH_PFNGLGENBUFFERSPROC)    fghGetProcAddress( "glGenBuffersARB" );
+        fghDeleteBuffers = (FGH_PFNGLDELETEBUFFERSPROC) fghGetProcAddress( "glDeleteBuffersARB" );
+        fghBindBuffer    = (FGH_PFNGLBINDBUFFERPROC)    fghGetProcAddress( "glBindBufferARB" );
+        fghBufferData    = (FGH_PFNGLBUFFERDATAPROC)    fghGetProcAddress( "glBufferDataARB" );
+    }
+
+    if( !fghGenBuffers || !fghDeleteBuffers || !fghBindBuffer || !fghBufferData )
+        fghGenBuffers = NULL;
+}
+
+SFG_WindowContextType fgCurrentContext( void )
+{
+#if TARGET_HOST_POSIX_X11
+    return glXGetCurrentContext( );
+#elif TARGET_HOST_MS_WINDOWS
+    return wglGetCurrentContext( );
+#elif TARGET_HOST_OSMESA
+    return OSMesaGetCurrentContext( );
+#endif
+}
+
+/*
+ * Appends a vertex of geometry->Stride floats, returning its index
+ */
+GLuint fgGeometryVertex( SFG_Geometry *geometry, const GLfloat *vertex )
+{
+    if( geometry->NumVertices == geometry->MaxVertices )
+    {
+        geometry->MaxVertices = geometry->MaxVertices ? geometry->MaxVertices * 2 : 64;
+        geometry->Vertices = (GLfloat *) realloc( geometry->Vertices,
+                                                  sizeof( GLfloat ) * geometry->Stride * geometry->MaxVertices );
+        if( !geometry->Vertices )
+            fgError( "Failed to allocate memory in fgGeometryVertex" );
+    }
+
+    memcpy( geometry->Vertices + geometry->Stride * geometry->NumVertices, vertex,
+            sizeof( GLfloat ) * geometry->Stride );
+
+    return (GLuint) geometry->NumVertices++;
+}
+
+void fgGeometryIndex( SFG_Geometry *geometry, GLuint index )
+{
+    if( geometry->NumIndices == geometry->MaxIndices )
+    {
+        geometry->MaxIndices = geometry->MaxIndices ? geometry->MaxIndices * 2 : 192;
+        geometry->Indices = (GLuint *) realloc( geometry->Indices,
+                                                sizeof( GLuint ) * geometry->MaxIndices );
+        if( !geometry->Indices )
+            fgError( "Failed to allocate memory in fgGeometryIndex" );
+    }
+
+    geometry->Indices[ geometry->NumIndices++ ] = index;
+}
+
+static GLuint fghGeometryVertex( SFG_Geometry *geometry,
+                                 double nx, double ny, double nz,
+                                 double x, double y, double z )
+{
+    GLfloat vertex[ 6 ];
+
+    vertex[ 0 ] = (GLfloat) nx; vertex[ 1 ] = (GLfloat) ny; vertex[ 2 ] = (GLfloat) nz;
+    vertex[ 3 ] = (GLfloat) x;  vertex[ 4 ] = (GLfloat) y;  vertex[ 5 ] = (GLfloat) z;
+
+    return fgGeometryVertex( geometry, vertex );
+}
+
+static void fghGeometryTriangle( SFG_Geometry *geometry, GLuint a, GLuint b, GLuint c )
+{
+    fgGeometryIndex( geometry, a );
+    fgGeometryIndex( geometry, b );
+    fgGeometryIndex( geometry, c );
+}
+
+/*
+ * One quad of a GL_QUAD_STRIP whose vertex pairs are (a0,b0), (a1,b1)
+ */
+static void fghGeometryStripQuad( SFG_Geometry *geometry,
+                                  GLuint a0, GLuint b0, GLuint a1, GLuint b1 )
+{
+    fghGeometryTriangle( geometry, a0, b0, b1 );
+    fghGeometryTriangle( geometry, a0, b1, a1 );
+}
+
+/*
+ * The generators below follow the immediate mode code vertex for vertex.
+ * Rings are stored without their closing duplicate; index (j % slices)
+ * wraps the seam instead.
+ */
+static void fghGenerateSolidSphere( SFG_Geometry *geometry, double radius, int slices, int stacks )
+{
+    int i, j;
+    GLuint top, bottom, ring, last;
+    double *sint1, *cost1;
+    double *sint2, *cost2;
+
+    fghCircleTable( &sint1, &cost1, -slices );
+    fghCircleTable( &sint2, &cost2, stacks * 2 );
+
+    top = fghGeometryVertex( geometry, 0, 0, 1, 0, 0, radius );
+
+    ring = geometry->NumVertices;
+    for( i = 1; i < stacks; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryVertex( geometry,
+                               cost1[ j ] * sint2[ i ],          sint1[ j ] * sint2[ i ],          cost2[ i ],
+                               cost1[ j ] * sint2[ i ] * radius, sint1[ j ] * sint2[ i ] * radius, cost2[ i ] * radius );
+
+    bottom = fghGeometryVertex( geometry, 0, 0, -1, 0, 0, -radius );
+
+#   define  R(i,j) ( ring + ( (i) - 1 ) * slices + ( (j) % slices ) )
+
+    /* Top fan, emitted from slice "slices" down to 0 */
+    for( j = slices; j > 0; j-- )
+        fghGeometryTriangle( geometry, top, R( 1, j ), R( 1, j - 1 ) );
+
+    /* Quad strips pair ring i+1 with ring i */
+    for( i = 1; i < stacks - 1; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryStripQuad( geometry, R( i + 1, j ), R( i, j ), R( i + 1, j + 1 ), R( i, j + 1 ) );
+
+    /* Bottom fan */
+    last = stacks - 1;
+    for( j = 0; j < slices; j++ )
+        fghGeometryTriangle( geometry, bottom, R( last, j ), R( last, j + 1 ) );
+
+#   undef R
+
+    fghScratchRewind( );
+}
+
+static void fghGenerateSolidCone( SFG_Geometry *geometry, double base, double height, int slices, int stacks )
+{
+    int i, j;
+    GLuint center, rim, ring, apex;
+    const double zStep = height / stacks;
+    const double rStep = base / stacks;
+    const double cosn = ( height / sqrt ( height * height + base * base ));
+    const double sinn = ( base   / sqrt ( height * height + base * base ));
+    double *sint, *cost;
+
+    fghCircleTable( &sint, &cost, -slices );
+
+#   define  B(j)   ( rim + ( (j) % slices ) )
+#   define  R(i,j) ( ring + (i) * slices + ( (j) % slices ) )
+
+    /* The base fan has its own vertices, they carry a different normal */
+    center = fghGeometryVertex( geometry, 0, 0, -1, 0, 0, 0 );
+    rim = geometry->NumVertices;
+    for( j = 0; j < slices; j++ )
+        fghGeometryVertex( geometry, 0, 0, -1, cost[ j ] * base, sint[ j ] * base, 0 );
+
+    for( j = 0; j < slices; j++ )
+        fghGeometryTriangle( geometry, center, B( j ), B( j + 1 ) );
+
+    /* The sides, ring i sits at the bottom of stack i */
+    ring = geometry->NumVertices;
+    for( i = 0; i < stacks; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryVertex( geometry, cost[ j ] * cosn, sint[ j ] * cosn, sinn,
+                               cost[ j ] * ( base - i * rStep ), sint[ j ] * ( base - i * rStep ), i * zStep );
+
+    for( i = 0; i < stacks - 1; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryStripQuad( geometry, R( i, j ), R( i + 1, j ), R( i, j + 1 ), R( i + 1, j + 1 ) );
+
+    /* The top stack: the apex takes the normal of the slice it closes */
+    for( j = 0; j < slices; j++ )
+    {
+        apex = fghGeometryVertex( geometry, cost[ j ] * cosn, sint[ j ] * cosn, sinn, 0, 0, height );
+        fghGeometryTriangle( geometry, R( stacks - 1, j ), apex, R( stacks - 1, j + 1 ) );
+    }
+
+#   undef B
+#   undef R
+
+    fghScratchRewind( );
+}
+
+static void fghGenerateSolidCylinder( SFG_Geometry *geometry, double radius, double height, int slices, int stacks )
+{
+    int i, j;
+    GLuint center, rim, ring;
+    const double zStep = height / stacks;
+    double *sint, *cost;
+
+    fghCircleTable( &sint, &cost, -slices );
+
+#   define  C(j)   ( rim + ( (j) % slices ) )
+#   define  R(i,j) ( ring + (i) * slices + ( (j) % slices ) )
+
+    /* Base and top caps */
+    center = fghGeometryVertex( geometry, 0, 0, -1, 0, 0, 0 );
+    rim = geometry->NumVertices;
+    for( j = 0; j < slices; j++ )
+        fghGeometryVertex( geometry, 0, 0, -1, cost[ j ] * radius, sint[ j ] * radius, 0 );
+    for( j = 0; j < slices; j++ )
+        fghGeometryTriangle( geometry, center, C( j ), C( j + 1 ) );
+
+    center = fghGeometryVertex( geometry, 0, 0, 1, 0, 0, height );
+    rim = geometry->NumVertices;
+    for( j = 0; j < slices; j++ )
+        fghGeometryVertex( geometry, 0, 0, 1, cost[ j ] * radius, sint[ j ] * radius, height );
+    for( j = slices; j > 0; j-- )
+        fghGeometryTriangle( geometry, center, C( j ), C( j - 1 ) );
+
+    /* The stacks, ring 0 at the base up to ring "stacks" exactly at the top */
+    ring = geometry->NumVertices;
+    for( i = 0; i <= stacks; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryVertex( geometry, cost[ j ], sint[ j ], 0,
+                               cost[ j ] * radius, sint[ j ] * radius, ( i == stacks ) ? height : i * zStep );
+
+    for( i = 1; i <= stacks; i++ )
+        for( j = 0; j < slices; j++ )
+            fghGeometryStripQuad( geometry, R( i - 1, j ), R( i, j ), R( i - 1, j + 1 ), R( i, j + 1 ) );
+
+#   undef C
+#   undef R
+
+    fghScratchRewind( );
+}
+
+static void fghGenerateSolidTorus( SFG_Geometry *geometry, double iradius, double oradius, int nSides, int nRings )
+{
+    int i, j;
+    double phi, psi, dpsi, dphi;
+
+    /* Same grid as glutSolidTorus, including the duplicated seam */
+    nSides ++ ;
+    nRings ++ ;
+
+    dpsi =  2.0 * M_PI / (double)(nRings - 1) ;
+    dphi = -2.0 * M_PI / (double)(nSides - 1) ;
+
+    for( j = 0; j < nRings; j++ )
+    {
+        psi = j * dpsi;
+
+        for( i = 0; i < nSides; i++ )
+        {
+            phi = i * dphi;
+            fghGeometryVertex( geometry,
+                               cos( psi ) * cos( phi ), sin( psi ) * cos( phi ), sin( phi ),
+                               cos( psi ) * ( oradius + cos( phi ) * iradius ),
+                               sin( psi ) * ( oradius + cos( phi ) * iradius ),
+                               sin( phi ) * iradius );
+        }
+    }
+
+    for( i = 0; i < nSides - 1; i++ )
+        for( j = 0; j < nRings - 1; j++ )
+        {
+            GLuint v = j * nSides + i;
+
+            fghGeometryTriangle( geometry, v, v + 1, v + nSides + 1 );
+            fghGeometryTriangle( geometry, v, v + nSides + 1, v + nSides );
+        }
+}
+
+/*
+ * Buffers can only be deleted while their own context is current; freeing
+ * a mesh anywhere else would drop their names and leak them
+ */
+static GLboolean fghCanFreeGeometry( SFG_Geometry *geometry,
+                                     SFG_WindowContextType context )
+{
+    return !geometry->Buffers[ 0 ] || geometry->Context == context;
+}
+
+static void fghFreeGeometry( SFG_Geometry *geometry )
+{
+    if( geometry->Buffers[ 0 ] && fghGenBuffers )
+        fghDeleteBuffers( 2, geometry->Buffers );
+
+    free( geometry->Vertices );
+    free( geometry->Indices );
+    free( geometry );
+}
+
+/*
+ * Gets whatever buffers the application bound out of the way so that
+ * client array pointers are taken as such. Call it within a
+ * glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT ), which restores them.
+ */
+void fgBindClientArrays( void )
+{
+    if( !fghBuffersResolved )
+        fghResolveBufferProcs( );
+
+    if( fghGenBuffers )
+    {
+        fghBindBuffer( GL_ARRAY_BUFFER, 0 );
+        fghBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+    }
+}
+
+/*
+ * Finds a cached mesh, making it the most recently used one
+ */
+SFG_Geometry *fgFindGeometry( SFG_GeometryShape shape, GLdouble p0, GLdouble p1,
+                              GLint slices, GLint stacks )
+{
+    SFG_Geometry *geometry;
+
+    for( geometry = (SFG_Geometry *) fgState.Geometries.First; geometry;
+         geometry = (SFG_Geometry *) geometry->Node.Next )
+        if( geometry->Shape == shape &&
+            geometry->Param[ 0 ] == p0 && geometry->Param[ 1 ] == p1 &&
+            geometry->Slices == slices && geometry->Stacks == stacks )
+        {
+            fgListRemove( &fgState.Geometries, &geometry->Node );
+            fgListInsert( &fgState.Geometries, fgState.Geometries.First, &geometry->Node );
+            return geometry;
+        }
+
+    return NULL;
+}
+
+/*
+ * Adds an empty mesh to the cache, for the caller to fill in. The vertex
+ * format is one of the glInterleavedArrays formats used here, the mode
+ * GL_TRIANGLES or GL_LINES.
+ */
+SFG_Geometry *fgCreateGeometry( SFG_GeometryShape shape, GLdouble p0, GLdouble p1,
+                                GLint slices, GLint stacks, GLenum format, GLenum mode )
+{
+    SFG_WindowContextType context = fgCurrentContext( );
+    SFG_Geometry *geometry, *oldest;
+
+    /*
+     * Trim the least recently used meshes this context can free. Those
+     * holding another context's buffers stay until that context makes
+     * room, so with several contexts the cache may run a little over.
+     */
+    oldest = (SFG_Geometry *) fgState.Geometries.Last;
+    while( oldest &&
+           fgListLength( &fgState.Geometries ) >= FREEGLUT_GEOMETRY_CACHE_SIZE )
+    {
+        SFG_Geometry *newer = (SFG_Geometry *) oldest->Node.Prev;
+
+        if( fghCanFreeGeometry( oldest, context ) )
+        {
+            fgListRemove( &fgState.Geometries, &oldest->Node );
+            fghFreeGeometry( oldest );
+        }
+        oldest = newer;
+    }
+
+    geometry = (SFG_Geometry *) calloc( sizeof( SFG_Geometry ), 1 );
+    if( !geometry )
+        fgError( "Failed to allocate memory in fgCreateGeometry" );
+
+    geometry->Shape = shape;
+    geometry->Param[ 0 ] = p0;
+    geometry->Param[ 1 ] = p1;
+    geometry->Slices = slices;
+    geometry->Stacks = stacks;
+    geometry->Format = format;
+    geometry->Stride = ( format == GL_T2F_N3F_V3F ) ? 8 : 6;
+    geometry->Mode = mode;
+
+    fgListInsert( &fgState.Geometries, fgState.Geometries.First, &geometry->Node );
+
+    return geometry;
+}
+
+/*
+ * Draws a cached mesh, uploading it to buffers on first use
+ */
+void fgDrawGeometry( SFG_Geometry *geometry )
+{
+    SFG_WindowContextType context = fgCurrentContext( );
+
+    if( !fghBuffersResolved )
+        fghResolveBufferProcs( );
+
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+    if( fghGenBuffers && !geometry->Buffers[ 0 ] )
+    {
+        geometry->Context = context;
+        fghGenBuffers( 2, geometry->Buffers );
+        fghBindBuffer( GL_ARRAY_BUFFER, geometry->Buffers[ 0 ] );
+        fghBufferData( GL_ARRAY_BUFFER, sizeof( GLfloat ) * geometry->Stride * geometry->NumVertices,
+                       geometry->Vertices, GL_STATIC_DRAW );
+        fghBindBuffer( GL_ELEMENT_ARRAY_BUFFER, geometry->Buffers[ 1 ] );
+        fghBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * geometry->NumIndices,
+                       geometry->Indices, GL_STATIC_DRAW );
+    }
+
+    if( geometry->Buffers[ 0 ] && geometry->Context == context )
+    {
+        fghBindBuffer( GL_ARRAY_BUFFER, geometry->Buffers[ 0 ] );
+        fghBindBuffer( GL_ELEMENT_ARRAY_BUFFER, geometry->Buffers[ 1 ] );
+        glInterleavedArrays( geometry->Format, 0, NULL );
+        glDrawElements( geometry->Mode, geometry->NumIndices, GL_UNSIGNED_INT, NULL );
+    }
+    else
+    {
+        fgBindClientArrays( );
+        glInterleavedArrays( geometry->Format, 0, geometry->Vertices );
+        glDrawElements( geometry->Mode, geometry->NumIndices, GL_UNSIGNED_INT, geometry->Indices );
+    }
+
+    /* The buffer bindings are part of the client vertex array state */
+    glPopClientAttrib( );
+}
+
+/*
+ * Draws a quadric from the cache, generating it on a miss. Returns GL_FALSE
+ * when the caller should fall back to immediate mode: the cache is switched
+ * off, or the parameters are degenerate and best left to the original code.
+ */
+static GLboolean fghDrawCachedGeometry( SFG_GeometryShape shape, GLdouble p0, GLdouble p1,
+                                        GLint slices, GLint stacks )
+{
+    SFG_Geometry *geometry;
+
+    if( !fgState.GeometryCache || slices < 1 || stacks < 1 ||
+        ( shape == SFG_SOLID_SPHERE && stacks < 2 ) )
+        return GL_FALSE;
+
+    geometry = fgFindGeometry( shape, p0, p1, slices, stacks );
+
+    if( !geometry )
+    {
+        geometry = fgCreateGeometry( shape, p0, p1, slices, stacks, GL_N3F_V3F, GL_TRIANGLES );
+
+        switch( shape )
+        {
+        case SFG_SOLID_SPHERE:   fghGenerateSolidSphere  ( geometry, p0,     slices, stacks ); break;
+        case SFG_SOLID_CONE:     fghGenerateSolidCone    ( geometry, p0, p1, slices, stacks ); break;
+        case SFG_SOLID_CYLINDER: fghGenerateSolidCylinder( geometry, p0, p1, slices, stacks ); break;
+        case SFG_SOLID_TORUS:    fghGenerateSolidTorus   ( geometry, p0, p1, slices, stacks ); break;
+        default: break;
+        }
+    }
+
+    fgDrawGeometry( geometry );
+
+    return GL_TRUE;
+}
+
+void fgDestroyGeometryCache( void )
+{
+    SFG_Geometry *geometry;
+
+    /* The contexts are gone by now and took the buffers with them */
+    while( ( geometry = (SFG_Geometry *) fgState.Geometries.First ) )
+    {
+        fgListRemove( &fgState.Geometries, &geometry->Node );
+        free( geometry->Vertices );
+        free( geometry->Indices );
+        free( geometry );
+    }
+
+    fghBuffersResolved = GL_FALSE;
+    fghGenBuffers = NULL;
+
+    free( fghScratch );
+    fghScratch = NULL;
+    fghScratchSize = 0;
+}
+
 /*
  * Draws a solid sphere
  */
@@ -183,6 +763,9 @@ void FGAPIENTRY glutSolidSphere(GLdouble radius, GLint slices, GLint stacks)
 
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidSphere" );
 
+    if( fghDrawCachedGeometry( SFG_SOLID_SPHERE, radius, 0.0, slices, stacks ) )
+        return;
+
     fghCircleTable(&sint1,&cost1,-slices);
     fghCircleTable(&sint2,&cost2,stacks*2);
 
@@ -246,10 +829,7 @@ void FGAPIENTRY glutSolidSphere(GLdouble radius, GLint slices, GLint stacks)
 
     /* Release sin and cos tables */
 
-    free(sint1);
-    free(cost1);
-    free(sint2);
-    free(cost2);
+    fghScratchRewind( );
 }
 
 /*
@@ -316,10 +896,7 @@ void FGAPIENTRY glutWireSphere(GLdouble radius, GLint slices, GLint stacks)
 
     /* Release sin and cos tables */
 
-    free(sint1);
-    free(cost1);
-    free(sint2);
-    free(cost2);
+    fghScratchRewind( );
 }
 
 /*
@@ -348,6 +925,9 @@ void FGAPIENTRY glutSolidCone( GLdouble base, GLdouble height, GLint slices, GLi
 
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidCone" );
 
+    if( fghDrawCachedGeometry( SFG_SOLID_CONE, base, height, slices, stacks ) )
+        return;
+
     fghCircleTable(&sint,&cost,-slices);
 
     /* Cover the circular base with a triangle fan... */
@@ -405,8 +985,7 @@ void FGAPIENTRY glutSolidCone( GLdouble base, GLdouble height, GLint slices, GLi
 
     /* Release sin and cos tables */
 
-    free(sint);
-    free(cost);
+    fghScratchRewind( );
 }
 
 /*
@@ -472,8 +1051,7 @@ void FGAPIENTRY glutWireCone( GLdouble base, GLdouble height, GLint slices, GLin
 
     /* Release sin and cos tables */
 
-    free(sint);
-    free(cost);
+    fghScratchRewind( );
 }
 
 
@@ -495,6 +1073,9 @@ void FGAPIENTRY glutSolidCylinder(GLdouble radius, GLdouble height, GLint slices
 
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidCylinder" );
 
+    if( fghDrawCachedGeometry( SFG_SOLID_CYLINDER, radius, height, slices, stacks ) )
+        return;
+
     fghCircleTable(&sint,&cost,-slices);
 
     /* Cover the base and top */
@@ -537,8 +1118,7 @@ void FGAPIENTRY glutSolidCylinder(GLdouble radius, GLdouble height, GLint slices
 
     /* Release sin and cos tables */
 
-    free(sint);
-    free(cost);
+    fghScratchRewind( );
 }
 
 /*
@@ -596,8 +1176,7 @@ void FGAPIENTRY glutWireCylinder(GLdouble radius, GLdouble height, GLint slices,
 
     /* Release sin and cos tables */
 
-    free(sint);
-    free(cost);
+    fghScratchRewind( );
 }
 
 /*
@@ -616,8 +1195,8 @@ void FGAPIENTRY glutWireTorus( GLdouble dInnerRadius, GLdouble dOuterRadius, GLi
   if ( nRings < 1 ) nRings = 1;
 
   /* Allocate the vertices array */
-  vertex = (double *)calloc( sizeof(double), 3 * nSides * nRings );
-  normal = (double *)calloc( sizeof(double), 3 * nSides * nRings );
+  vertex = fghScratchDoubles( 3 * nSides * nRings );
+  normal = fghScratchDoubles( 3 * nSides * nRings );
 
   glPushMatrix();
 
@@ -676,8 +1255,7 @@ void FGAPIENTRY glutWireTorus( GLdouble dInnerRadius, GLdouble dOuterRadius, GLi
     glEnd();
   }
 
-  free ( vertex ) ;
-  free ( normal ) ;
+  fghScratchRewind( );
   glPopMatrix();
 }
 
@@ -696,13 +1274,16 @@ void FGAPIENTRY glutSolidTorus( GLdouble dInnerRadius, GLdouble dOuterRadius, GL
   if ( nSides < 1 ) nSides = 1;
   if ( nRings < 1 ) nRings = 1;
 
+  if( fghDrawCachedGeometry( SFG_SOLID_TORUS, dInnerRadius, dOuterRadius, nSides, nRings ) )
+    return;
+
   /* Increment the number of sides and rings to allow for one more point than surface */
   nSides ++ ;
   nRings ++ ;
 
   /* Allocate the vertices array */
-  vertex = (double *)calloc( sizeof(double), 3 * nSides * nRings );
-  normal = (double *)calloc( sizeof(double), 3 * nSides * nRings );
+  vertex = fghScratchDoubles( 3 * nSides * nRings );
+  normal = fghScratchDoubles( 3 * nSides * nRings );
 
   glPushMatrix();
 
@@ -752,8 +1333,7 @@ void FGAPIENTRY glutSolidTorus( GLdouble dInnerRadius, GLdouble dOuterRadius, GL
 
   glEnd();
 
-  free ( vertex ) ;
-  free ( normal ) ;
+  fghScratchRewind( );
   glPopMatrix();
 }
 
@@ -73,7 +73,7 @@
 
 #include "freeglut_internal.h"
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 
 struct freeglutStrokeFont
 {
@@ -71,8 +71,11 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       0,                     /* SwapCount */
                       0,                     /* SwapTime */
                       0,                     /* Time */
-                      { NULL, NULL },         /* Timers */
+                      { NULL, 0, 0, 0, 0, NULL }, /* Timers */
                       { NULL, NULL },         /* FreeTimers */
+                      { NULL, NULL },         /* Watches */
+                      -1,                     /* WaitSet */
+                      -1,                     /* WaitTimer */
                       NULL,                   /* IdleCallback */
                       0,                      /* ActiveMenus */
                       NULL,                   /* MenuStateCallback */
@@ -85,11 +88,17 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       NULL,                   /* ProgramName */
                       GL_FALSE,               /* JoysticksInitialised */
                       0,                      /* NumActiveJoysticks */
+                      GL_FALSE,               /* JoystickInput */
                       GL_FALSE,               /* InputDevsInitialised */
                       0,                      /* MouseWheelTicks */
                       1,                      /* AuxiliaryBufferNumber */
                       4,                      /* SampleNumber */
                       GL_FALSE,               /* SkipStaleMotion */
+                      GL_TRUE,                /* CoalesceEvents */
+                      { 0, 0, 0, 0, 0, 0 },   /* EventCounts */
+                      GL_FALSE,               /* GeometryExact */
+                      GL_TRUE,                /* GeometryCache */
+                      { NULL, NULL },         /* Geometries */
                       1,                      /* MajorVersion */
                       0,                      /* MinorVersion */
                       0,                      /* ContextFlags */
@@ -388,6 +397,26 @@ static void fghInitialize( const char* displayName )
     /* Set the timer granularity to 1 ms */
     timeBeginPeriod ( 1 );
 
+#elif TARGET_HOST_OSMESA
+
+    /*
+     * There is no screen behind OSMesa, only the size we pretend it has,
+     * which "-display WIDTHxHEIGHT" (never $DISPLAY) can change; 96 dpi for
+     * the millimetres.
+     */
+    int width = 1920, height = 1080;
+
+    if( displayName &&
+        ( sscanf( displayName, "%dx%d", &width, &height ) != 2 ||
+          width <= 0 || height <= 0 ) )
+        fgError( "bad virtual screen size '%s', expected WIDTHxHEIGHT",
+                 displayName );
+
+    fgDisplay.ScreenWidth    = width;
+    fgDisplay.ScreenHeight   = height;
+    fgDisplay.ScreenWidthMM  = width  * 254 / 960;
+    fgDisplay.ScreenHeightMM = height * 254 / 960;
+
 #endif
 
     fgState.Initialised = GL_TRUE;
@@ -435,11 +464,13 @@ void fgDeinitialize( void )
 
     fgDestroyStructure( );
 
-    while( ( timer = fgState.Timers.First) )
+    while( fgState.Timers.Number )
     {
-        fgListRemove( &fgState.Timers, &timer->Node );
+        timer = fgState.Timers.Timers[ 0 ];
+        fgTimerHeapRemove( &fgState.Timers, timer );
         free( timer );
     }
+    free( fgState.Timers.Timers );
 
     while( ( timer = fgState.FreeTimers.First) )
     {
@@ -447,6 +478,9 @@ void fgDeinitialize( void )
         free( timer );
     }
 
+    fgDestroyGeometryCache( );
+    fgDestroyFontCache( );
+
 #if !defined(_WIN32_WCE)
     if ( fgState.JoysticksInitialised )
         fgJoystickClose( );
@@ -455,8 +489,11 @@ void fgDeinitialize( void )
         fgInputDeviceClose( );
 #endif /* !defined(_WIN32_WCE) */
     fgState.JoysticksInitialised = GL_FALSE;
+    fgState.JoystickInput = GL_FALSE;
     fgState.InputDevsInitialised = GL_FALSE;
 
+    fgDestroyWaitSet( );
+
 	fgState.MouseWheelTicks = 0;
 
     fgState.MajorVersion = 1;
@@ -492,7 +529,8 @@ void fgDeinitialize( void )
     fgState.GameModeDepth   = -1;
     fgState.GameModeRefresh = -1;
 
-    fgListInit( &fgState.Timers );
+    memset( &fgState.Timers, 0, sizeof( fgState.Timers ) );
+    memset( &fgState.EventCounts, 0, sizeof( fgState.EventCounts ) );
     fgListInit( &fgState.FreeTimers );
 
     fgState.IdleCallback = NULL;
@@ -542,7 +580,7 @@ void fgDeinitialize( void )
  * Everything inside the following #ifndef is copied from the X sources.
  */
 
-#if TARGET_HOST_MS_WINDOWS
+#if TARGET_HOST_MS_WINDOWS || TARGET_HOST_OSMESA
 
 /*
 
@@ -754,7 +792,10 @@ void FGAPIENTRY glutInit( int* pargc, char** argv )
         }
     }
 
+#if !TARGET_HOST_OSMESA
+    /* DISPLAY names an X server, which means nothing to the OSMesa size */
     displayName = getenv( "DISPLAY" );
+#endif
 
     for( i = 1; i < argc; i++ )
     {
@@ -35,7 +35,7 @@
 #include <GL/freeglut.h>
 #include "freeglut_internal.h"
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
 #endif
@@ -248,7 +248,7 @@ static void poll_dials ( int id )
 
 
 /******** OS Specific Serial I/O routines *******/
-#if TARGET_HOST_POSIX_X11 /* ==> Linux/BSD/UNIX POSIX serial I/O */
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA /* ==> Linux/BSD/UNIX POSIX serial I/O */
 static SERIALPORT *serial_open ( const char *device )
 {
     int fd;
@@ -38,10 +38,17 @@
 #define  VERSION_PATCH 1
 
 /* Freeglut is intended to function under all Unix/X11 and Win32 platforms. */
+/* FREEGLUT_OSMESA builds a headless freeglut that renders into OSMesa
+ * offscreen buffers instead of windows, for machines without a display.
+ */
+#if defined(FREEGLUT_OSMESA) && !defined(TARGET_HOST_OSMESA)
+#   define  TARGET_HOST_OSMESA     1
+#endif
+
 /* XXX: Don't all MS-Windows compilers (except Cygwin) have _WIN32 defined?
  * XXX: If so, remove the first set of defined()'s below.
  */
-#if !defined(TARGET_HOST_POSIX_X11) && !defined(TARGET_HOST_MS_WINDOWS) && !defined(TARGET_HOST_MAC_OSX) && !defined(TARGET_HOST_SOLARIS)
+#if !defined(TARGET_HOST_POSIX_X11) && !defined(TARGET_HOST_MS_WINDOWS) && !defined(TARGET_HOST_MAC_OSX) && !defined(TARGET_HOST_SOLARIS) && !defined(TARGET_HOST_OSMESA)
 #if defined(_MSC_VER) || defined(__WATCOMC__) || defined(__MINGW32__) \
     || defined(_WIN32) || defined(_WIN32_WCE) \
     || ( defined(__CYGWIN__) && defined(X_DISPLAY_MISSING) )
@@ -82,6 +89,10 @@
 #   define  TARGET_HOST_SOLARIS    0
 #endif
 
+#ifndef  TARGET_HOST_OSMESA
+#   define  TARGET_HOST_OSMESA     0
+#endif
+
 /* -- FIXED CONFIGURATION LIMITS ------------------------------------------- */
 
 #define  FREEGLUT_MAX_MENUS         3
@@ -125,6 +136,9 @@
 #        define GLX_SAMPLES 0x80A9
 #    endif
 
+#elif TARGET_HOST_OSMESA
+#    include <GL/osmesa.h>
+
 #endif
 
 /* These files should be available on every platform. */
@@ -168,6 +182,11 @@
 #    define  HAVE_VFPRINTF 1
 #endif
 
+/* Linux sleeps in epoll on a timerfd rather than in select() */
+#if ( TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA ) && defined(__linux__)
+#    define  HAVE_EPOLL 1
+#endif
+
 /* MinGW may lack a prototype for ChangeDisplaySettingsEx() (depending on the version?) */
 #if TARGET_HOST_MS_WINDOWS && !defined(ChangeDisplaySettingsEx)
 LONG WINAPI ChangeDisplaySettingsExA(LPCSTR,LPDEVMODEA,HWND,DWORD,LPVOID);
@@ -246,6 +265,7 @@ typedef void (* FGCBMultiPassive )( int, int, int );
 /* The global callbacks type definitions */
 typedef void (* FGCBIdle          )( void );
 typedef void (* FGCBTimer         )( int );
+typedef void (* FGCBFd            )( int );
 typedef void (* FGCBMenuState     )( int );
 typedef void (* FGCBMenuStatus    )( int, int, int );
 
@@ -281,6 +301,69 @@ struct tagSFG_XYUse
     GLboolean       Use;                /* ...and a single boolean.          */
 };
 
+/* The user can create any number of timer hooks */
+typedef struct tagSFG_Timer SFG_Timer;
+struct tagSFG_Timer
+{
+    SFG_Node        Node;               /* Links the unused timer hooks      */
+    int             ID;                 /* The timer ID integer              */
+    FGCBTimer       Callback;           /* The timer callback                */
+    unsigned long long TriggerTime;     /* The timer trigger time, in ns     */
+    unsigned long   Serial;             /* Orders timers due at the same time */
+    int             HeapIndex;          /* Where it sits in fgState.Timers   */
+    int             Handle;             /* Periodic timers: the handle given */
+    unsigned long long Period;          /*   out, the re-arm interval...     */
+    int             Policy;             /*   ...and what to do when late     */
+};
+
+/*
+ * The pending timers, as a binary min-heap on (TriggerTime, Serial) so
+ * that adding and firing a timer is O(log n) however many are pending
+ */
+typedef struct tagSFG_TimerHeap SFG_TimerHeap;
+struct tagSFG_TimerHeap
+{
+    SFG_Timer     **Timers;             /* Timers[ 0 ] is the next one due   */
+    int             Number;
+    int             Size;
+    unsigned long   Serial;             /* Hands out SFG_Timer::Serial       */
+    int             LastHandle;         /* Hands out periodic timer handles  */
+    SFG_Timer      *Firing;             /* The periodic timer being called   */
+};
+
+/*
+ * Window system events received and passed on, see GLUT_COALESCE_EVENTS
+ */
+typedef struct tagSFG_EventCounts SFG_EventCounts;
+struct tagSFG_EventCounts
+{
+    int             MotionRaw;
+    int             MotionDelivered;
+    int             ConfigureRaw;
+    int             ConfigureDelivered;
+    int             ExposeRaw;
+    int             ExposeDelivered;
+};
+
+/*
+ * A file descriptor the main loop wakes up for, with the FG_WATCH_* events
+ * it has callbacks for. Ready collects what the last wait saw, until the
+ * callbacks have been called.
+ */
+#define  FG_WATCH_READ                      0x0001
+#define  FG_WATCH_WRITE                     0x0002
+
+typedef struct tagSFG_Watch SFG_Watch;
+struct tagSFG_Watch
+{
+    SFG_Node        Node;
+    int             Fd;                 /* The watched descriptor            */
+    int             Events;             /* What to wait for...               */
+    int             Ready;              /* ...and what has happened          */
+    FGCBFd          ReadCallback;       /* Called as ( Fd ) when readable... */
+    FGCBFd          WriteCallback;      /* ...and when writable              */
+};
+
 /*
  * An enumeration containing the state of the GLUT execution:
  * initializing, running, or stopping
@@ -317,9 +400,12 @@ struct tagSFG_State
     GLuint           SwapCount;            /* Count of glutSwapBuffer calls  */
     GLuint           SwapTime;             /* Time of last SwapBuffers       */
 
-    unsigned long    Time;                 /* Time that glutInit was called  */
-    SFG_List         Timers;               /* The freeglut timer hooks       */
+    unsigned long long Time;               /* Time that glutInit was called  */
+    SFG_TimerHeap    Timers;               /* The freeglut timer hooks       */
     SFG_List         FreeTimers;           /* The unused timer hooks         */
+    SFG_List         Watches;              /* Descriptors the main loop waits on */
+    int              WaitSet;              /* The epoll instance, -1 if none */
+    int              WaitTimer;            /* The timerfd for the next deadline */
 
     FGCBIdle         IdleCallback;         /* The global idle callback       */
 
@@ -337,6 +423,7 @@ struct tagSFG_State
     char            *ProgramName;         /* Name of the invoking program    */
     GLboolean        JoysticksInitialised;  /* Only initialize if application calls for them */
     int              NumActiveJoysticks;    /* Number of active joysticks -- if zero, don't poll joysticks */
+    GLboolean        JoystickInput;         /* A joystick device has input waiting */
     GLboolean        InputDevsInitialised;  /* Only initialize if application calls for them */
 
 	int              MouseWheelTicks;      /* Number of ticks the mouse wheel has turned */
@@ -345,6 +432,12 @@ struct tagSFG_State
     int              SampleNumber;         /*  Number of samples per pixel  */
 
     GLboolean        SkipStaleMotion;      /* skip stale motion events */
+    GLboolean        CoalesceEvents;       /* Merge runs of motion/configure events */
+    SFG_EventCounts  EventCounts;          /* What was merged away           */
+    GLboolean        GeometryExact;        /* Ask the server for window geometry */
+
+    GLboolean        GeometryCache;        /* Keep the solid shapes in buffers */
+    SFG_List         Geometries;           /* The cached shape meshes        */
 
     int              MajorVersion;         /* Major OpenGL context version  */
     int              MinorVersion;         /* Minor OpenGL context version  */
@@ -402,16 +495,6 @@ struct tagSFG_Display
 };
 
 
-/* The user can create any number of timer hooks */
-typedef struct tagSFG_Timer SFG_Timer;
-struct tagSFG_Timer
-{
-    SFG_Node        Node;
-    int             ID;                 /* The timer ID integer              */
-    FGCBTimer       Callback;           /* The timer callback                */
-    long            TriggerTime;        /* The timer trigger time            */
-};
-
 /*
  * Make "freeglut" window handle and context types so that we don't need so
  * much conditionally-compiled code later in the library.
@@ -426,8 +509,48 @@ typedef GLXContext SFG_WindowContextType ;
 typedef HWND    SFG_WindowHandleType ;
 typedef HGLRC   SFG_WindowContextType ;
 
+#elif TARGET_HOST_OSMESA
+
+/* There is nothing behind an offscreen window, it is its own handle */
+typedef struct tagSFG_Window *SFG_WindowHandleType ;
+typedef OSMesaContext         SFG_WindowContextType ;
+
 #endif
 
+/*
+ * A mesh in the shape cache (see freeglut_geometry.c), keyed by the shape
+ * and the parameters it was generated with.
+ */
+typedef enum
+{
+    SFG_SOLID_SPHERE,
+    SFG_SOLID_CONE,
+    SFG_SOLID_CYLINDER,
+    SFG_SOLID_TORUS,
+    SFG_SOLID_TEAPOT,
+    SFG_WIRE_TEAPOT
+} SFG_GeometryShape;
+
+typedef struct tagSFG_Geometry SFG_Geometry;
+struct tagSFG_Geometry
+{
+    SFG_Node              Node;
+    SFG_GeometryShape     Shape;         /* What was generated...            */
+    GLdouble              Param[ 2 ];    /* ...and with which parameters     */
+    GLint                 Slices, Stacks;
+
+    GLenum                Format;        /* glInterleavedArrays format       */
+    int                   Stride;        /* Floats per vertex                */
+    GLenum                Mode;          /* GL_TRIANGLES or GL_LINES         */
+    GLfloat              *Vertices;
+    GLuint               *Indices;
+    int                   NumVertices, MaxVertices;
+    int                   NumIndices, MaxIndices;
+
+    SFG_WindowContextType Context;       /* The context owning the buffers   */
+    GLuint                Buffers[ 2 ];  /* Vertex and index buffer, or 0    */
+};
+
 /*
  * A window and its OpenGL context. The contents of this structure
  * are highly dependant on the target operating system we aim at...
@@ -442,6 +565,11 @@ struct tagSFG_Context
     GLXFBConfig*    FBConfig;        /* The window's FBConfig               */
 #elif TARGET_HOST_MS_WINDOWS
     HDC             Device;          /* The window's device context         */
+#elif TARGET_HOST_OSMESA
+    GLubyte        *BackBuffer;      /* What OSMesa renders into, RGBA      */
+    GLubyte        *FrontBuffer;     /* The last swapped frame, the same    */
+    int             BufferWidth;     /* The size both buffers were made for */
+    int             BufferHeight;
 #endif
 
     int             DoubleBuffered;  /* Treat the window as double-buffered */
@@ -457,6 +585,14 @@ struct tagSFG_WindowState
 #if TARGET_HOST_POSIX_X11
     int             OldWidth;           /* Window width from before a resize */
     int             OldHeight;          /*   "    height  "    "    "   "    */
+
+    GLboolean       SizeKnown;          /* The geometry glutGet() answers... */
+    GLboolean       PositionKnown;      /* ...kept current by ConfigureNotify */
+    int             CachedX, CachedY;   /* Root position of the client area  */
+    int             CachedWidth;
+    int             CachedHeight;
+    int             CachedBorderWidth;  /* The window manager's frame        */
+    int             CachedHeaderHeight;
 #elif TARGET_HOST_MS_WINDOWS
     RECT            OldRect;            /* window rect - stored before the window is made fullscreen */
     DWORD           OldStyle;           /* window style - stored before the window is made fullscreen */
@@ -860,6 +996,11 @@ void fgDestroyStructure( void );
 GLXFBConfig* fgChooseFBConfig( int* numcfgs );
 #endif
 
+/* Sizes the memory an offscreen window renders into, see freeglut_window.c */
+#if TARGET_HOST_OSMESA
+void fgResizeOffscreenBuffers( SFG_Window *window, int width, int height );
+#endif
+
 /* The window procedure for Win32 events handling */
 #if TARGET_HOST_MS_WINDOWS
 LRESULT CALLBACK fgWindowProc( HWND hWnd, UINT uMsg,
@@ -990,11 +1131,17 @@ void fgDeactivateMenu( SFG_Window *window );
  */
 void fgDisplayMenu( void );
 
-/* Elapsed time as per glutGet(GLUT_ELAPSED_TIME). */
+/* Elapsed time as per glutGet(GLUT_ELAPSED_TIME), and in nanoseconds. */
 long fgElapsedTime( void );
+unsigned long long fgElapsedTimeNs( void );
 
-/* System time in milliseconds */
-long unsigned fgSystemTime(void);
+/* Monotonic system time in nanoseconds */
+unsigned long long fgSystemTime(void);
+
+/* Descriptors the main loop wakes up for, see freeglut_main.c */
+void fgWatchFd( int fd, FGCBFd readCallback, FGCBFd writeCallback );
+void fgUnwatchFd( int fd );
+void fgDestroyWaitSet( void );
 
 /* List functions */
 void fgListInit(SFG_List *list);
@@ -1003,6 +1150,10 @@ void fgListRemove(SFG_List *list, SFG_Node *node);
 int fgListLength(SFG_List *list);
 void fgListInsert(SFG_List *list, SFG_Node *next, SFG_Node *node);
 
+/* Timer heap functions */
+void fgTimerHeapInsert( SFG_TimerHeap *heap, SFG_Timer *timer );
+void fgTimerHeapRemove( SFG_TimerHeap *heap, SFG_Timer *timer );
+
 /* Error Message functions */
 void fgError( const char *fmt, ... );
 void fgWarning( const char *fmt, ... );
@@ -1023,6 +1174,23 @@ int fgHintPresent(Window window, Atom property, Atom hint);
 
 SFG_Proc fghGetProcAddress( const char *procName );
 
+/* The shape cache, see freeglut_geometry.c */
+SFG_Geometry *fgFindGeometry( SFG_GeometryShape shape, GLdouble p0, GLdouble p1,
+                              GLint slices, GLint stacks );
+SFG_Geometry *fgCreateGeometry( SFG_GeometryShape shape, GLdouble p0, GLdouble p1,
+                                GLint slices, GLint stacks, GLenum format, GLenum mode );
+GLuint        fgGeometryVertex( SFG_Geometry *geometry, const GLfloat *vertex );
+void          fgGeometryIndex( SFG_Geometry *geometry, GLuint index );
+void          fgDrawGeometry( SFG_Geometry *geometry );
+void          fgDestroyGeometryCache( void );
+
+/* Context and client array helpers shared by the cached drawing paths */
+SFG_WindowContextType fgCurrentContext( void );
+void          fgBindClientArrays( void );
+
+/* Frees the glyph caches and the text batch, see freeglut_font.c */
+void          fgDestroyFontCache( void );
+
 #if TARGET_HOST_MS_WINDOWS
 extern void (__cdecl *__glutExitFunc)( int return_value );
 #endif
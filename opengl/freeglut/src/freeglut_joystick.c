@@ -67,7 +67,7 @@
 
 #endif
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #    define _JS_MAX_AXES 16
 #    ifdef HAVE_SYS_IOCTL_H
 #        include <sys/ioctl.h>
@@ -404,7 +404,7 @@ struct tagSFG_Joystick
 #endif
 
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #   if defined(__FreeBSD__) || defined(__FreeBSD_kernel__) || defined(__NetBSD__)
        struct os_specific_s *os;
 #   endif
@@ -461,6 +461,36 @@ static void fghJoystickAddHatElement ( SFG_Joystick* joy, CFDictionaryRef hat );
 #define MAX_NUM_JOYSTICKS  2
 static SFG_Joystick *fgJoystick [ MAX_NUM_JOYSTICKS ];
 
+#if ( TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA ) && ( defined( JS_NEW ) || defined( __FreeBSD__ ) || defined(__FreeBSD_kernel__) || defined( __NetBSD__ ) )
+static void fghJoystickRawRead( SFG_Joystick* joy, int* buttons, float* axes );
+
+/*
+ * Where the driver hands out events on a non-blocking descriptor, the main
+ * loop waits on it and polls the joysticks as soon as there is input. The
+ * descriptor is read dry here, into the cached state the poll reports:
+ * the poll only reads it when a window has a Joystick callback, and until
+ * it is empty the main loop would never sleep.
+ */
+static void fghJoystickInput( int fd )
+{
+    int ident;
+
+    for( ident = 0; ident < MAX_NUM_JOYSTICKS; ident++ )
+    {
+        SFG_Joystick *joy = fgJoystick[ ident ];
+
+#    if defined( __FreeBSD__ ) || defined( __FreeBSD_kernel__ ) || defined( __NetBSD__ )
+        if( joy && !joy->error && joy->os->fd == fd )
+#    else
+        if( joy && !joy->error && joy->fd == fd )
+#    endif
+            fghJoystickRawRead( joy, NULL, NULL );
+    }
+
+    fgState.JoystickInput = GL_TRUE;
+}
+#endif
+
 
 /*
  * Read the raw joystick data
@@ -609,7 +639,7 @@ static void fghJoystickRawRead( SFG_Joystick* joy, int* buttons, float* axes )
     }
 #endif
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #    if defined(__FreeBSD__) || defined(__FreeBSD_kernel__) || defined(__NetBSD__)
     if ( joy->os->is_analog )
     {
@@ -683,6 +713,7 @@ static void fghJoystickRawRead( SFG_Joystick* joy, int* buttons, float* axes )
     {
         perror( joy->os->fname );
         joy->error = 1;
+        fgUnwatchFd( joy->os->fd );
     }
     if ( buttons != NULL ) *buttons = joy->os->cache_buttons;
     if ( axes    != NULL )
@@ -713,6 +744,8 @@ static void fghJoystickRawRead( SFG_Joystick* joy, int* buttons, float* axes )
 
             fgWarning ( "%s", joy->fname );
             joy->error = GL_TRUE;
+            /* Nothing will read it again, so stop waking up for it */
+            fgUnwatchFd( joy->fd );
             return;
         }
 
@@ -1071,7 +1104,7 @@ static void fghJoystickOpen( SFG_Joystick* joy )
         CFDictionaryRef props;
     CFTypeRef topLevelElement;
 #endif
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #    if defined( __FreeBSD__ ) || defined(__FreeBSD_kernel__) || defined( __NetBSD__ )
        char *cp;
 #    endif
@@ -1307,7 +1340,7 @@ static void fghJoystickOpen( SFG_Joystick* joy )
     }
 #endif
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #if defined( __FreeBSD__ ) || defined(__FreeBSD_kernel__) || defined( __NetBSD__ )
     for( i = 0; i < _JS_MAX_AXES; i++ )
         joy->os->cache_axes[ i ] = 0.0f;
@@ -1326,6 +1359,8 @@ static void fghJoystickOpen( SFG_Joystick* joy )
     if( joy->error )
         return;
 
+    fgWatchFd( joy->os->fd, fghJoystickInput, NULL );
+
     joy->num_axes = 0;
     joy->num_buttons = 0;
     if( joy->os->is_analog )
@@ -1445,6 +1480,7 @@ static void fghJoystickOpen( SFG_Joystick* joy )
     joy->num_buttons = u;
     ioctl( joy->fd, JSIOCGNAME( sizeof( joy->name ) ), joy->name );
     fcntl( joy->fd, F_SETFL, O_NONBLOCK );
+    fgWatchFd( joy->fd, fghJoystickInput, NULL );
 #    endif
 
     /*
@@ -1573,7 +1609,7 @@ static void fghJoystickInit( int ident )
     }
 #endif
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #    if defined( __FreeBSD__ ) || defined(__FreeBSD_kernel__) || defined( __NetBSD__ )
     fgJoystick[ ident ]->id = ident;
     fgJoystick[ ident ]->error = GL_FALSE;
@@ -1642,12 +1678,15 @@ void fgJoystickClose( void )
             /* Do nothing special */
 #endif
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 #if defined( __FreeBSD__ ) || defined(__FreeBSD_kernel__) || defined( __NetBSD__ )
             if( fgJoystick[ident]->os )
             {
                 if( ! fgJoystick[ ident ]->error )
+                {
+                    fgUnwatchFd( fgJoystick[ ident ]->os->fd );
                     close( fgJoystick[ ident ]->os->fd );
+                }
 #ifdef HAVE_USB_JS
                 if( fgJoystick[ ident ]->os->hids )
                     free (fgJoystick[ ident ]->os->hids);
@@ -1659,7 +1698,12 @@ void fgJoystickClose( void )
 #endif
 
             if( ! fgJoystick[ident]->error )
+            {
+#ifdef JS_NEW
+                fgUnwatchFd( fgJoystick[ ident ]->fd );
+#endif
                 close( fgJoystick[ ident ]->fd );
+            }
 #endif
 
             free( fgJoystick[ ident ] );
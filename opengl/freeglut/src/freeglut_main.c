@@ -31,6 +31,13 @@
 #    include <errno.h>
 #endif
 #include <stdarg.h>
+#ifdef HAVE_EPOLL
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <sys/epoll.h>
+#    include <sys/timerfd.h>
+#endif
 #ifdef  HAVE_VFPRINTF
 #    define VFPRINTF(s,f,a) vfprintf((s),(f),(a))
 #elif defined(HAVE__DOPRNT)
@@ -66,6 +73,9 @@ struct GXKeyList gxKeyList;
 #    define INT_MAX 32767
 #endif
 
+/* How long to sleep with no timer pending, INT_MAX milliseconds */
+#define FGH_FOREVER ( (unsigned long long) INT_MAX * 1000000 )
+
 #ifndef MIN
 #    define MIN(a,b) (((a)<(b)) ? (a) : (b))
 #endif
@@ -172,6 +182,10 @@ static void fghReshapeWindow ( SFG_Window *window, int width, int height )
                       SWP_NOZORDER
         );
     }
+#elif TARGET_HOST_OSMESA
+
+    fgResizeOffscreenBuffers( window, width, height );
+
 #endif
 
     if( FETCH_WCB( *window, Reshape ) )
@@ -244,7 +258,7 @@ static void fghcbDisplayWindow( SFG_Window *window,
     {
         window->State.Redisplay = GL_FALSE;
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
         fghRedrawWindow ( window ) ;
 #elif TARGET_HOST_MS_WINDOWS
 
@@ -279,7 +293,8 @@ static void fghcbCheckJoystickPolls( SFG_Window *window,
 {
     long int checkTime = fgElapsedTime( );
 
-    if( window->State.JoystickLastPoll + window->State.JoystickPollRate <=
+    if( fgState.JoystickInput ||
+        window->State.JoystickLastPoll + window->State.JoystickPollRate <=
         checkTime )
     {
 #if !defined(_WIN32_WCE)
@@ -302,6 +317,7 @@ static void fghCheckJoystickPolls( void )
     enumerator.data  =  NULL;
 
     fgEnumWindows( fghcbCheckJoystickPolls, &enumerator );
+    fgState.JoystickInput = GL_FALSE;
 }
 
 /*
@@ -309,54 +325,101 @@ static void fghCheckJoystickPolls( void )
  */
 static void fghCheckTimers( void )
 {
-    long checkTime = fgElapsedTime( );
+    unsigned long long checkTime = fgElapsedTimeNs( );
 
-    while( fgState.Timers.First )
+    while( fgState.Timers.Number )
     {
-        SFG_Timer *timer = fgState.Timers.First;
+        SFG_Timer *timer = fgState.Timers.Timers[ 0 ];
 
         if( timer->TriggerTime > checkTime )
             break;
 
-        fgListRemove( &fgState.Timers, &timer->Node );
-        fgListAppend( &fgState.FreeTimers, &timer->Node );
+        fgTimerHeapRemove( &fgState.Timers, timer );
+
+        if( ! timer->Period )
+        {
+            fgListAppend( &fgState.FreeTimers, &timer->Node );
 
+            timer->Callback( timer->ID );
+            continue;
+        }
+
+        fgState.Timers.Firing = timer;
         timer->Callback( timer->ID );
+        fgState.Timers.Firing = NULL;
+
+        /* Cancelled from its own callback */
+        if( ! timer->Handle )
+        {
+            fgListAppend( &fgState.FreeTimers, &timer->Node );
+            continue;
+        }
+
+        /*
+         * Re-arm from the deadline, not from now. Catching up, a timer
+         * that is still late comes round again in this same pass, but
+         * never beyond checkTime, so the loop ends.
+         */
+        timer->TriggerTime += timer->Period;
+
+        if( timer->Policy == GLUT_TIMER_SKIP )
+        {
+            unsigned long long now = fgElapsedTimeNs( );
+
+            if( timer->TriggerTime <= now )
+                timer->TriggerTime +=
+                    ( ( now - timer->TriggerTime ) / timer->Period + 1 ) * timer->Period;
+        }
+
+        fgTimerHeapInsert( &fgState.Timers, timer );
     }
 }
 
  
-/* Platform-dependent time in milliseconds, as an unsigned 32-bit integer.
- * This value wraps every 49.7 days, but integer overflows cancel
- * when subtracting an initial start time, unless the total time exceeds
- * 32-bit, where the GLUT API return value is also overflowed.
- */  
-unsigned long fgSystemTime(void) {
+/* Platform-dependent monotonic time in nanoseconds, as an unsigned 64-bit
+ * integer, which does not wrap in any realistic uptime.
+ */
+unsigned long long fgSystemTime(void) {
 #if TARGET_HOST_MS_WINDOWS
 #    if defined(_WIN32_WCE)
-    return GetTickCount();
+    return (unsigned long long) GetTickCount() * 1000000;
 #    else
-    return timeGetTime();
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if( ! frequency.QuadPart )
+        QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &counter );
+
+    /* Split so that counter * 1e9 cannot overflow */
+    return (unsigned long long) ( counter.QuadPart / frequency.QuadPart ) * 1000000000 +
+           (unsigned long long) ( counter.QuadPart % frequency.QuadPart ) * 1000000000 /
+           frequency.QuadPart;
 #    endif
 #else
 #   ifdef CLOCK_MONOTONIC
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
-    return now.tv_nsec/1000000 + now.tv_sec*1000;
+    return (unsigned long long) now.tv_sec * 1000000000 + now.tv_nsec;
 #   elif HAVE_GETTIMEOFDAY
     struct timeval now;
     gettimeofday( &now, NULL );
-    return now.tv_usec/1000 + now.tv_sec*1000;
+    return (unsigned long long) now.tv_sec * 1000000000 + now.tv_usec * 1000;
 #   endif
 #endif
 }
   
 /*
- * Elapsed Time
+ * Elapsed Time, in nanoseconds and in GLUT's milliseconds
  */
+unsigned long long fgElapsedTimeNs( void )
+{
+    return fgSystemTime() - fgState.Time;
+}
+
 long fgElapsedTime( void )
 {
-    return (long) (fgSystemTime() - fgState.Time);
+    return (long) ( fgElapsedTimeNs() / 1000000 );
 }
 
 /*
@@ -423,34 +486,50 @@ void fgWarning( const char *fmt, ... )
 
 
 /*
- * Indicates whether Joystick events are being used by ANY window.
- *
- * The current mechanism is to walk all of the windows and ask if
- * there is a joystick callback.  We have a short-circuit early
- * return if we find any joystick handler registered.
- *
- * The real way to do this is to make use of the glutTimer() API
- * to more cleanly re-implement the joystick API.  Then, this code
- * and all other "joystick timer" code can be yanked.
- *
+ * Finds when the next joystick poll is due, as the earliest of the windows'
+ * LastPoll + PollRate. A zero rate asks for a poll on every pass of the
+ * main loop, which does not call for a pass of its own.
  */
-static void fghCheckJoystickCallback( SFG_Window* w, SFG_Enumerator* e)
+static void fghcbNextJoystickPoll( SFG_Window *window,
+                                   SFG_Enumerator *enumerator )
 {
-    if( FETCH_WCB( *w, Joystick ) )
+    long *next = ( long * )enumerator->data;
+
+    if( FETCH_WCB( *window, Joystick ) && window->State.JoystickPollRate > 0 )
     {
-        e->found = GL_TRUE;
-        e->data = w;
+        long due = window->State.JoystickLastPoll + window->State.JoystickPollRate;
+
+        if( due < *next )
+            *next = due;
     }
-    fgEnumSubWindows( w, fghCheckJoystickCallback, e );
+    fgEnumSubWindows( window, fghcbNextJoystickPoll, enumerator );
 }
-static int fghHaveJoystick( void )
+
+/*
+ * Returns the number of nanoseconds till the next joystick poll.
+ */
+static unsigned long long fghNextJoystickPoll( void )
 {
     SFG_Enumerator enumerator;
+    unsigned long long due, now;
+    long next = INT_MAX;
+
+    if( ! fgState.NumActiveJoysticks )
+        return FGH_FOREVER;
 
     enumerator.found = GL_FALSE;
-    enumerator.data = NULL;
-    fgEnumWindows( fghCheckJoystickCallback, &enumerator );
-    return !!enumerator.data;
+    enumerator.data = &next;
+    fgEnumWindows( fghcbNextJoystickPoll, &enumerator );
+
+    if( next == INT_MAX )
+        return FGH_FOREVER;
+    if( next < 0 )
+        return 0;
+
+    due = ( unsigned long long ) next * 1000000;
+    now = fgElapsedTimeNs( );
+
+    return due > now ? due - now : 0;
 }
 static void fghHavePendingRedisplaysCallback( SFG_Window* w, SFG_Enumerator* e)
 {
@@ -471,36 +550,277 @@ static int fghHavePendingRedisplays (void)
     return !!enumerator.data;
 }
 /*
- * Returns the number of GLUT ticks (milliseconds) till the next timer event.
+ * Returns the number of nanoseconds till the next timer event.
  */
-static long fghNextTimer( void )
+static unsigned long long fghNextTimer( void )
 {
-    long ret = INT_MAX;
-    SFG_Timer *timer = fgState.Timers.First;
+    unsigned long long now;
+    SFG_Timer *timer;
 
-    if( timer )
-        ret = timer->TriggerTime - fgElapsedTime();
-    if( ret < 0 )
-        ret = 0;
+    if( ! fgState.Timers.Number )
+        return FGH_FOREVER;
 
-    return ret;
+    timer = fgState.Timers.Timers[ 0 ];
+    now = fgElapsedTimeNs( );
+
+    return timer->TriggerTime > now ? timer->TriggerTime - now : 0;
+}
+
+/*
+ * Looks up a watched descriptor
+ */
+static SFG_Watch *fghWatchByFd( int fd )
+{
+    SFG_Watch *watch;
+
+    for( watch = ( SFG_Watch * )fgState.Watches.First;
+         watch;
+         watch = ( SFG_Watch * )watch->Node.Next )
+        if( watch->Fd == fd )
+            return watch;
+
+    return NULL;
 }
+
+/*
+ * Closes the epoll set and timerfd, leaving the watches in place
+ */
+static void fghCloseWaitSet( void )
+{
+#ifdef HAVE_EPOLL
+    if( fgState.WaitSet >= 0 )
+        close( fgState.WaitSet );
+    if( fgState.WaitTimer >= 0 )
+        close( fgState.WaitTimer );
+#endif
+    fgState.WaitSet = -1;
+    fgState.WaitTimer = -1;
+}
+
+#ifdef HAVE_EPOLL
+/*
+ * Adds a descriptor to the epoll set, or changes what is waited on
+ */
+static void fghEpollControl( int op, int fd, int events )
+{
+    struct epoll_event event;
+
+    memset( &event, 0, sizeof( event ) );
+    event.data.fd = fd;
+    if( events & FG_WATCH_READ )
+        event.events |= EPOLLIN;
+    if( events & FG_WATCH_WRITE )
+        event.events |= EPOLLOUT;
+
+    if( epoll_ctl( fgState.WaitSet, op, fd, &event ) == -1 )
+        fgWarning( "freeglut epoll_ctl() error: %d", errno );
+}
+
+/*
+ * Creates the epoll set on the first sleep: the X connection, if there is
+ * one, the timerfd and whatever has been watched so far. Returns GL_FALSE, and leaves the
+ * main loop on select(), if the kernel will not give us either.
+ */
+static GLboolean fghCreateWaitSet( void )
+{
+    SFG_Watch *watch;
+
+    if( fgState.WaitSet == -2 )
+        return GL_FALSE;
+
+    fgState.WaitSet = epoll_create( 16 );
+    fgState.WaitTimer = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK );
+
+    if( fgState.WaitSet == -1 || fgState.WaitTimer == -1 )
+    {
+        fgWarning( "freeglut epoll/timerfd error: %d, using select()", errno );
+        fghCloseWaitSet( );
+        fgState.WaitSet = -2;
+        return GL_FALSE;
+    }
+
+    fcntl( fgState.WaitSet, F_SETFD, FD_CLOEXEC );
+    fcntl( fgState.WaitTimer, F_SETFD, FD_CLOEXEC );
+
+#if TARGET_HOST_POSIX_X11
+    fghEpollControl( EPOLL_CTL_ADD, ConnectionNumber( fgDisplay.Display ),
+                     FG_WATCH_READ );
+#endif
+    fghEpollControl( EPOLL_CTL_ADD, fgState.WaitTimer, FG_WATCH_READ );
+
+    for( watch = ( SFG_Watch * )fgState.Watches.First;
+         watch;
+         watch = ( SFG_Watch * )watch->Node.Next )
+        fghEpollControl( EPOLL_CTL_ADD, watch->Fd, watch->Events );
+
+    return GL_TRUE;
+}
+
+/*
+ * Waits for input, a watched descriptor or the deadline "nsec" from now.
+ * The deadline goes to the timerfd as an absolute CLOCK_MONOTONIC time,
+ * the same clock as fgSystemTime(), so it is met to the nanosecond rather
+ * than rounded to epoll_wait()'s milliseconds.
+ */
+static GLboolean fghEpollWait( unsigned long long nsec )
+{
+    struct epoll_event events[ 16 ];
+    struct itimerspec deadline;
+    int timeout = -1;
+    int i, n;
+
+    if( fgState.WaitSet < 0 && ! fghCreateWaitSet( ) )
+        return GL_FALSE;
+
+    memset( &deadline, 0, sizeof( deadline ) );
+    if( ! nsec )
+        timeout = 0;
+    else if( nsec != FGH_FOREVER )
+    {
+        unsigned long long when = fgSystemTime( ) + nsec;
+
+        deadline.it_value.tv_sec  = ( time_t )( when / 1000000000 );
+        deadline.it_value.tv_nsec = ( long )( when % 1000000000 );
+    }
+
+    /* All zero disarms it, so an old deadline cannot wake us */
+    if( timeout )
+        timerfd_settime( fgState.WaitTimer, TFD_TIMER_ABSTIME, &deadline, NULL );
+
+    n = epoll_wait( fgState.WaitSet, events, 16, timeout );
+
+    if( ( -1 == n ) && ( errno != EINTR ) )
+        fgWarning ( "freeglut epoll_wait() error: %d", errno );
+
+    for( i = 0; i < n; i++ )
+    {
+        SFG_Watch *watch;
+
+        if( events[ i ].data.fd == fgState.WaitTimer )
+        {
+            unsigned long long expirations;
+
+            if( read( fgState.WaitTimer, &expirations, sizeof( expirations ) ) < 0 )
+                continue;
+        }
+        else if( ( watch = fghWatchByFd( events[ i ].data.fd ) ) )
+        {
+            /* Errors and hang-ups are for the callback's read or write to find */
+            if( events[ i ].events & ( EPOLLIN | EPOLLHUP | EPOLLERR ) )
+                watch->Ready |= watch->Events & FG_WATCH_READ;
+            if( events[ i ].events & ( EPOLLOUT | EPOLLERR ) )
+                watch->Ready |= watch->Events & FG_WATCH_WRITE;
+        }
+    }
+
+    return GL_TRUE;
+}
+#endif
+
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
+/*
+ * Waits on the X connection, if any, and the watched descriptors in select()
+ */
+static void fghSelectWait( unsigned long long nsec )
+{
+    fd_set readset, writeset;
+    SFG_Watch *watch;
+    int err;
+    int maxfd = -1;
+    struct timeval wait;
+    unsigned long long usec = ( nsec + 999 ) / 1000;
+
+    FD_ZERO( &readset );
+    FD_ZERO( &writeset );
+#if TARGET_HOST_POSIX_X11
+    maxfd = ConnectionNumber( fgDisplay.Display );
+    FD_SET( maxfd, &readset );
+#endif
+
+    for( watch = ( SFG_Watch * )fgState.Watches.First;
+         watch;
+         watch = ( SFG_Watch * )watch->Node.Next )
+    {
+        if( watch->Events & FG_WATCH_READ )
+            FD_SET( watch->Fd, &readset );
+        if( watch->Events & FG_WATCH_WRITE )
+            FD_SET( watch->Fd, &writeset );
+        if( watch->Fd > maxfd )
+            maxfd = watch->Fd;
+    }
+
+    wait.tv_sec = (long) ( usec / 1000000 );
+    wait.tv_usec = (long) ( usec % 1000000 );
+    err = select( maxfd+1, &readset, &writeset, NULL, &wait );
+
+#ifdef HAVE_ERRNO_H
+    if( ( -1 == err ) && ( errno != EINTR ) )
+        fgWarning ( "freeglut select() error: %d", errno );
+#endif
+
+    if( err <= 0 )
+        return;
+
+    for( watch = ( SFG_Watch * )fgState.Watches.First;
+         watch;
+         watch = ( SFG_Watch * )watch->Node.Next )
+    {
+        if( ( watch->Events & FG_WATCH_READ ) && FD_ISSET( watch->Fd, &readset ) )
+            watch->Ready |= FG_WATCH_READ;
+        if( ( watch->Events & FG_WATCH_WRITE ) && FD_ISSET( watch->Fd, &writeset ) )
+            watch->Ready |= FG_WATCH_WRITE;
+    }
+}
+#endif
+
+/*
+ * Calls back the descriptors the last wait found ready. A callback may
+ * watch or unwatch any descriptor, itself included, so the walk starts
+ * over after each one.
+ */
+static void fghDispatchWatches( void )
+{
+    SFG_Watch *watch = ( SFG_Watch * )fgState.Watches.First;
+
+    while( watch )
+    {
+        if( watch->Ready & FG_WATCH_READ )
+        {
+            watch->Ready &= ~FG_WATCH_READ;
+            watch->ReadCallback( watch->Fd );
+        }
+        else if( watch->Ready & FG_WATCH_WRITE )
+        {
+            watch->Ready &= ~FG_WATCH_WRITE;
+            watch->WriteCallback( watch->Fd );
+        }
+        else
+        {
+            watch = ( SFG_Watch * )watch->Node.Next;
+            continue;
+        }
+
+        watch = ( SFG_Watch * )fgState.Watches.First;
+    }
+}
+
 /*
  * Does the magic required to relinquish the CPU until something interesting
- * happens.
+ * happens: input, a watched descriptor, or the next timer or joystick poll.
  */
 static void fghSleepForEvents( void )
 {
-    long msec;
+    unsigned long long nsec;
 
     if( fgState.IdleCallback || fghHavePendingRedisplays( ) )
-        return;
-
-    msec = fghNextTimer( );
-    /* XXX Use GLUT timers for joysticks... */
-    /* XXX Dumb; forces granularity to .01sec */
-    if( fghHaveJoystick( ) && ( msec > 10 ) )     
-        msec = 10;
+    {
+        /* Not sleeping, but the watched descriptors still get a look in */
+        if( ! fgState.Watches.First )
+            return;
+        nsec = 0;
+    }
+    else
+        nsec = MIN( fghNextTimer( ), fghNextJoystickPoll( ) );
 
 #if TARGET_HOST_POSIX_X11
     /*
@@ -512,31 +832,189 @@ static void fghSleepForEvents( void )
      * need to allow that we may have an empty socket but non-
      * empty event queue.
      */
-    if( ! XPending( fgDisplay.Display ) )
-    {
-        fd_set fdset;
-        int err;
-        int socket;
-        struct timeval wait;
-
-        socket = ConnectionNumber( fgDisplay.Display );
-        FD_ZERO( &fdset );
-        FD_SET( socket, &fdset );
-        wait.tv_sec = msec / 1000;
-        wait.tv_usec = (msec % 1000) * 1000;
-        err = select( socket+1, &fdset, NULL, NULL, &wait );
+    if( XPending( fgDisplay.Display ) )
+        nsec = 0;
+#endif
 
-#ifdef HAVE_ERRNO_H
-        if( ( -1 == err ) && ( errno != EINTR ) )
-            fgWarning ( "freeglut select() error: %d", errno );
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
+#ifdef HAVE_EPOLL
+    if( ! fghEpollWait( nsec ) )
 #endif
-    }
+        fghSelectWait( nsec );
 #elif TARGET_HOST_MS_WINDOWS
-    MsgWaitForMultipleObjects( 0, NULL, FALSE, msec, QS_ALLINPUT );
+    /*
+     * The wait is in whole milliseconds. Round down, and let the main loop
+     * come back round for the last fraction rather than oversleep it.
+     */
+    MsgWaitForMultipleObjects( 0, NULL, FALSE, (DWORD) ( nsec / 1000000 ),
+                               QS_ALLINPUT );
+#endif
+
+    fghDispatchWatches( );
+}
+
+/* -- WATCHED DESCRIPTORS -------------------------------------------------- */
+
+/*
+ * Wakes the main loop up when "fd" is readable or writable, for whichever
+ * has a callback, and calls it with "fd". Watching a descriptor again
+ * replaces its callbacks, and no callbacks at all stops watching it.
+ * Windows has nothing to wait on besides its message queue, so there the
+ * callbacks are never called.
+ */
+void fgWatchFd( int fd, FGCBFd readCallback, FGCBFd writeCallback )
+{
+    SFG_Watch *watch;
+    GLboolean added = GL_FALSE;
+    int events = ( readCallback ? FG_WATCH_READ : 0 ) |
+                 ( writeCallback ? FG_WATCH_WRITE : 0 );
+
+    if( ! events )
+    {
+        fgUnwatchFd( fd );
+        return;
+    }
+
+    if( ! ( watch = fghWatchByFd( fd ) ) )
+    {
+        watch = ( SFG_Watch * )calloc( 1, sizeof( SFG_Watch ) );
+        if( ! watch )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in fgWatchFd()" );
+        watch->Fd = fd;
+        fgListAppend( &fgState.Watches, &watch->Node );
+        added = GL_TRUE;
+    }
+
+    watch->Events = events;
+    watch->Ready &= events;
+    watch->ReadCallback = readCallback;
+    watch->WriteCallback = writeCallback;
+
+#ifdef HAVE_EPOLL
+    if( fgState.WaitSet >= 0 )
+        fghEpollControl( added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, events );
+#endif
+}
+
+/*
+ * Stops watching "fd", if it was
+ */
+void fgUnwatchFd( int fd )
+{
+    SFG_Watch *watch = fghWatchByFd( fd );
+
+    if( ! watch )
+        return;
+
+#ifdef HAVE_EPOLL
+    if( fgState.WaitSet >= 0 )
+        epoll_ctl( fgState.WaitSet, EPOLL_CTL_DEL, fd, NULL );
 #endif
+
+    fgListRemove( &fgState.Watches, &watch->Node );
+    free( watch );
+}
+
+/*
+ * Drops all the watches and closes the epoll set and timerfd
+ */
+void fgDestroyWaitSet( void )
+{
+    SFG_Watch *watch;
+
+    while( ( watch = ( SFG_Watch * )fgState.Watches.First ) )
+    {
+        fgListRemove( &fgState.Watches, &watch->Node );
+        free( watch );
+    }
+
+    fghCloseWaitSet( );
 }
 
 #if TARGET_HOST_POSIX_X11
+/*
+ * Keeps the geometry glutGet() answers from current. Every ConfigureNotify
+ * has the size. The position is only given in root coordinates by the
+ * synthetic events a window manager sends when it moves a window, and the
+ * frame around the window does not change with a move; anything else
+ * leaves the position for glutGet() to ask the server about. Subwindows
+ * move on the root along with their parent, so theirs go as well.
+ */
+static void fghcbForgetPosition( SFG_Window *window,
+                                 SFG_Enumerator *enumerator )
+{
+    window->State.PositionKnown = GL_FALSE;
+    fgEnumSubWindows( window, fghcbForgetPosition, enumerator );
+}
+
+static void fghUpdateGeometry( SFG_Window *window, XConfigureEvent *event )
+{
+    SFG_Enumerator enumerator;
+    GLboolean positionKnown = window->State.PositionKnown;
+
+    window->State.CachedWidth = event->width;
+    window->State.CachedHeight = event->height;
+    window->State.SizeKnown = GL_TRUE;
+
+    enumerator.found = GL_FALSE;
+    enumerator.data = NULL;
+    fghcbForgetPosition( window, &enumerator );
+
+    if( event->send_event && positionKnown )
+    {
+        window->State.CachedX = event->x + event->border_width;
+        window->State.CachedY = event->y + event->border_width;
+        window->State.PositionKnown = GL_TRUE;
+    }
+}
+
+/*
+ * The window an event is dispatched to. A ConfigureNotify that reaches a
+ * parent through SubstructureNotifyMask carries the parent in xany.window,
+ * but it is about the child in xconfigure.window.
+ */
+static Window fghEventTarget( XEvent *event )
+{
+    if( event->type == ConfigureNotify )
+        return event->xconfigure.window;
+
+    return event->xany.window;
+}
+
+/*
+ * With GLUT_COALESCE_EVENTS, replaces "event" by the last of the events of
+ * the same type, for the same target window, queued right behind it. Motion
+ * only merges while the buttons and modifiers stay the same, so that a
+ * Motion callback is never turned into a Passive one. Returns how many
+ * events were merged away.
+ */
+static int fghCoalesceEvents( XEvent *event )
+{
+    XEvent next;
+    int merged = 0;
+
+    if( ! fgState.CoalesceEvents )
+        return 0;
+
+    while( XEventsQueued( fgDisplay.Display, QueuedAfterReading ) )
+    {
+        XPeekEvent( fgDisplay.Display, &next );
+
+        if( ( next.type != event->type ) ||
+            ( fghEventTarget( &next ) != fghEventTarget( event ) ) )
+            break;
+        if( ( event->type == MotionNotify ) &&
+            ( next.xmotion.state != event->xmotion.state ) )
+            break;
+
+        XNextEvent( fgDisplay.Display, event );
+        merged++;
+    }
+
+    return merged;
+}
+
 /*
  * Returns GLUT modifier mask for the state field of an X11 event.
  */
@@ -1075,7 +1553,10 @@ void FGAPIENTRY glutMainLoopEvent( void )
                     width = event.xcreatewindow.width;
                     height = event.xcreatewindow.height;
                 } else {
+                    fgState.EventCounts.ConfigureRaw += 1 + fghCoalesceEvents( &event );
                     GETWINDOW( xconfigure );
+                    fgState.EventCounts.ConfigureDelivered++;
+                    fghUpdateGeometry( window, &event.xconfigure );
                     width = event.xconfigure.width;
                     height = event.xconfigure.height;
                 }
@@ -1120,9 +1601,13 @@ void FGAPIENTRY glutMainLoopEvent( void )
              * XXX do a buffer-swap).
              *
              */
+            fgState.EventCounts.ExposeRaw++;
             if( event.xexpose.count == 0 )
             {
                 GETWINDOW( xexpose );
+                /* However many came in, this is one redisplay */
+                if( ! window->State.Redisplay )
+                    fgState.EventCounts.ExposeDelivered++;
                 window->State.Redisplay = GL_TRUE;
             }
             break;
@@ -1200,12 +1685,15 @@ void FGAPIENTRY glutMainLoopEvent( void )
             /* if GLUT_SKIP_STALE_MOTION_EVENTS is true, then discard all but
              * the last motion event from the queue
              */
+            fgState.EventCounts.MotionRaw += 1 + fghCoalesceEvents( &event );
             if(fgState.SkipStaleMotion) {
-                while(XCheckIfEvent(fgDisplay.Display, &event, match_motion, 0));
+                while(XCheckIfEvent(fgDisplay.Display, &event, match_motion, 0))
+                    fgState.EventCounts.MotionRaw++;
             }
 
             GETWINDOW( xmotion );
             GETMOUSE( xmotion );
+            fgState.EventCounts.MotionDelivered++;
 
             if( window->ActiveMenu )
             {
@@ -1515,9 +2003,15 @@ void FGAPIENTRY glutMainLoopEvent( void )
         TranslateMessage( &stMsg );
         DispatchMessage( &stMsg );
     }
+
+#elif TARGET_HOST_OSMESA
+
+    /* Offscreen windows get no events, only timers and redisplays */
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutMainLoopEvent" );
+
 #endif
 
-    if( fgState.Timers.First )
+    if( fgState.Timers.Number )
         fghCheckTimers( );
     fghCheckJoystickPolls( );
     fghDisplayAll( );
@@ -1533,13 +2027,13 @@ void FGAPIENTRY glutMainLoop( void )
 {
     int action;
 
-#if TARGET_HOST_MS_WINDOWS
+#if TARGET_HOST_MS_WINDOWS || TARGET_HOST_OSMESA
     SFG_Window *window = (SFG_Window *)fgStructure.Windows.First ;
 #endif
 
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutMainLoop" );
 
-#if TARGET_HOST_MS_WINDOWS
+#if TARGET_HOST_MS_WINDOWS || TARGET_HOST_OSMESA
     /*
      * Processing before the main loop:  If there is a window which is open and
      * which has a visibility callback, call it.  I know this is an ugly hack,
@@ -1592,7 +2086,9 @@ void FGAPIENTRY glutMainLoop( void )
                 fgState.IdleCallback( );
             }
 
-            fghSleepForEvents( );
+            /* Nothing may ever wake us once glutLeaveMainLoop() is called */
+            if( fgState.ExecState == GLUT_EXEC_STATE_RUNNING )
+                fghSleepForEvents( );
         }
     }
 
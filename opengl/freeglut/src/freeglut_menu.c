@@ -159,6 +159,7 @@ static GLvoid fghGetVMaxExtent( SFG_Window* window, int* x, int* y )
         *x = fgState.GameModeSize.X + wx;
         *y = fgState.GameModeSize.Y + wy;
 #else
+        (void)window;
         *x = glutGet ( GLUT_SCREEN_WIDTH );
         *y = glutGet ( GLUT_SCREEN_HEIGHT );
 #endif
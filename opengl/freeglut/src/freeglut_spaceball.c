@@ -146,6 +146,8 @@ void fgSpaceballSetWindow(SFG_Window *window)
         spnav_x11_window(window->Window.Handle);
         spnav_win = window;
     }
+#else
+    (void)window;
 #endif
 }
 
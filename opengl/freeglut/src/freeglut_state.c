@@ -62,6 +62,70 @@ static int fghGetConfig( int attribute )
 
   return returnValue;
 }
+
+/*
+ * Makes sure the cached position and frame size of "window" are current,
+ * asking the server when ConfigureNotify has not kept them so. That takes
+ * two round-trips: one for where the window is on the root, and one for
+ * where it is in the window manager's frame.
+ */
+static SFG_WindowState *fghWindowPosition( SFG_Window *window )
+{
+    SFG_WindowState *state = &window->State;
+    int x, y;
+    Window w;
+
+    if( state->PositionKnown && ! fgState.GeometryExact )
+        return state;
+
+    XTranslateCoordinates(
+        fgDisplay.Display,
+        window->Window.Handle,
+        fgDisplay.RootWindow,
+        0, 0, &x, &y, &w);
+
+    state->CachedX = x;
+    state->CachedY = y;
+    state->CachedBorderWidth = 0;
+    state->CachedHeaderHeight = 0;
+
+    if ( w != 0 )
+    {
+        XTranslateCoordinates(
+            fgDisplay.Display,
+            window->Window.Handle,
+            w, 0, 0, &x, &y, &w);
+
+        state->CachedBorderWidth = x;
+        state->CachedHeaderHeight = y;
+    }
+
+    state->PositionKnown = GL_TRUE;
+    return state;
+}
+
+/*
+ * The same for the window's size, which every ConfigureNotify carries
+ */
+static SFG_WindowState *fghWindowSize( SFG_Window *window )
+{
+    SFG_WindowState *state = &window->State;
+    XWindowAttributes winAttributes;
+
+    if( state->SizeKnown && ! fgState.GeometryExact )
+        return state;
+
+    XGetWindowAttributes(
+        fgDisplay.Display,
+        window->Window.Handle,
+        &winAttributes
+    );
+
+    state->CachedWidth = winAttributes.width;
+    state->CachedHeight = winAttributes.height;
+    state->SizeKnown = GL_TRUE;
+    return state;
+}
 #endif
 
 /* -- INTERFACE FUNCTIONS -------------------------------------------------- */
@@ -128,6 +192,42 @@ void FGAPIENTRY glutSetOption( GLenum eWhat, int value )
       fgState.SkipStaleMotion = value;
       break;
 
+    case GLUT_GEOMETRY_CACHE:
+      fgState.GeometryCache = value ? GL_TRUE : GL_FALSE;
+      break;
+
+    case GLUT_COALESCE_EVENTS:
+      fgState.CoalesceEvents = value ? GL_TRUE : GL_FALSE;
+      break;
+
+    case GLUT_GEOMETRY_EXACT:
+      fgState.GeometryExact = value ? GL_TRUE : GL_FALSE;
+      break;
+
+    case GLUT_MOTION_EVENTS_RAW:
+      fgState.EventCounts.MotionRaw = value;
+      break;
+
+    case GLUT_MOTION_EVENTS_DELIVERED:
+      fgState.EventCounts.MotionDelivered = value;
+      break;
+
+    case GLUT_CONFIGURE_EVENTS_RAW:
+      fgState.EventCounts.ConfigureRaw = value;
+      break;
+
+    case GLUT_CONFIGURE_EVENTS_DELIVERED:
+      fgState.EventCounts.ConfigureDelivered = value;
+      break;
+
+    case GLUT_EXPOSE_EVENTS_RAW:
+      fgState.EventCounts.ExposeRaw = value;
+      break;
+
+    case GLUT_EXPOSE_EVENTS_DELIVERED:
+      fgState.EventCounts.ExposeDelivered = value;
+      break;
+
     default:
         fgWarning( "glutSetOption(): missing enum handle %d", eWhat );
         break;
@@ -248,62 +348,42 @@ int FGAPIENTRY glutGet( GLenum eWhat )
         }
 
     /*
-     * Those calls are somewhat similiar, as they use XGetWindowAttributes()
-     * function
+     * The window geometry comes from the cache ConfigureNotify keeps, see
+     * fghWindowPosition() and fghWindowSize()
      */
     case GLUT_WINDOW_X:
     case GLUT_WINDOW_Y:
     case GLUT_WINDOW_BORDER_WIDTH:
     case GLUT_WINDOW_HEADER_HEIGHT:
     {
-        int x, y;
-        Window w;
+        SFG_WindowState *state;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
 
-        XTranslateCoordinates(
-            fgDisplay.Display,
-            fgStructure.CurrentWindow->Window.Handle,
-            fgDisplay.RootWindow,
-            0, 0, &x, &y, &w);
-
-        switch ( eWhat )
-        {
-        case GLUT_WINDOW_X: return x;
-        case GLUT_WINDOW_Y: return y;
-        }
-
-        if ( w == 0 )
-            return 0;
-        XTranslateCoordinates(
-            fgDisplay.Display,
-            fgStructure.CurrentWindow->Window.Handle,
-            w, 0, 0, &x, &y, &w);
-
+        state = fghWindowPosition( fgStructure.CurrentWindow );
         switch ( eWhat )
         {
-        case GLUT_WINDOW_BORDER_WIDTH:  return x;
-        case GLUT_WINDOW_HEADER_HEIGHT: return y;
+        case GLUT_WINDOW_X:             return state->CachedX;
+        case GLUT_WINDOW_Y:             return state->CachedY;
+        case GLUT_WINDOW_BORDER_WIDTH:  return state->CachedBorderWidth;
+        case GLUT_WINDOW_HEADER_HEIGHT: return state->CachedHeaderHeight;
         }
     }
 
     case GLUT_WINDOW_WIDTH:
     case GLUT_WINDOW_HEIGHT:
     {
-        XWindowAttributes winAttributes;
+        SFG_WindowState *state;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
-        XGetWindowAttributes(
-            fgDisplay.Display,
-            fgStructure.CurrentWindow->Window.Handle,
-            &winAttributes
-        );
+
+        state = fghWindowSize( fgStructure.CurrentWindow );
         switch ( eWhat )
         {
-        case GLUT_WINDOW_WIDTH:            return winAttributes.width ;
-        case GLUT_WINDOW_HEIGHT:           return winAttributes.height ;
+        case GLUT_WINDOW_WIDTH:            return state->CachedWidth ;
+        case GLUT_WINDOW_HEIGHT:           return state->CachedHeight ;
         }
     }
 
@@ -543,6 +623,65 @@ int FGAPIENTRY glutGet( GLenum eWhat )
 #endif /* defined(_WIN32_WCE) */
         return 0;
 
+#elif TARGET_HOST_OSMESA
+
+    /*
+     * OSMesa has no configs to ask: the colour buffer is always RGBA8888
+     * and the rest is whatever the context was made with
+     */
+    case GLUT_WINDOW_NUM_SAMPLES:
+    case GLUT_WINDOW_STEREO:
+    case GLUT_WINDOW_COLORMAP_SIZE:
+    case GLUT_WINDOW_FORMAT_ID:
+        return 0;
+
+    case GLUT_WINDOW_RGBA:
+        return 1;
+    case GLUT_WINDOW_DOUBLEBUFFER:
+        if( fgStructure.CurrentWindow == NULL )
+            return 0;
+        return fgStructure.CurrentWindow->Window.DoubleBuffered;
+
+    case GLUT_WINDOW_BUFFER_SIZE:
+        return 32;
+    case GLUT_WINDOW_RED_SIZE:
+    case GLUT_WINDOW_GREEN_SIZE:
+    case GLUT_WINDOW_BLUE_SIZE:
+    case GLUT_WINDOW_ALPHA_SIZE:
+        return 8;
+
+    case GLUT_WINDOW_DEPTH_SIZE:
+        glGetIntegerv ( GL_DEPTH_BITS, &nsamples );
+        return nsamples;
+    case GLUT_WINDOW_STENCIL_SIZE:
+        glGetIntegerv ( GL_STENCIL_BITS, &nsamples );
+        return nsamples;
+    case GLUT_WINDOW_ACCUM_RED_SIZE:
+    case GLUT_WINDOW_ACCUM_GREEN_SIZE:
+    case GLUT_WINDOW_ACCUM_BLUE_SIZE:
+    case GLUT_WINDOW_ACCUM_ALPHA_SIZE:
+        glGetIntegerv ( GL_ACCUM_RED_BITS, &nsamples );
+        return nsamples;
+
+    /* Offscreen windows are nowhere and undecorated, only their size counts */
+    case GLUT_WINDOW_X:
+    case GLUT_WINDOW_Y:
+    case GLUT_WINDOW_BORDER_WIDTH:
+    case GLUT_WINDOW_HEADER_HEIGHT:
+        return 0;
+
+    case GLUT_WINDOW_WIDTH:
+        if( fgStructure.CurrentWindow == NULL )
+            return 0;
+        return fgStructure.CurrentWindow->Window.BufferWidth;
+    case GLUT_WINDOW_HEIGHT:
+        if( fgStructure.CurrentWindow == NULL )
+            return 0;
+        return fgStructure.CurrentWindow->Window.BufferHeight;
+
+    case GLUT_DISPLAY_MODE_POSSIBLE:
+        return ( fgState.DisplayMode & ( GLUT_INDEX | GLUT_STEREO ) ) ? 0 : 1;
+
 #endif
 
     /* The window structure queries */
@@ -591,6 +730,33 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     case GLUT_SKIP_STALE_MOTION_EVENTS:
       return fgState.SkipStaleMotion;
 
+    case GLUT_GEOMETRY_CACHE:
+      return fgState.GeometryCache;
+
+    case GLUT_COALESCE_EVENTS:
+      return fgState.CoalesceEvents;
+
+    case GLUT_GEOMETRY_EXACT:
+      return fgState.GeometryExact;
+
+    case GLUT_MOTION_EVENTS_RAW:
+      return fgState.EventCounts.MotionRaw;
+
+    case GLUT_MOTION_EVENTS_DELIVERED:
+      return fgState.EventCounts.MotionDelivered;
+
+    case GLUT_CONFIGURE_EVENTS_RAW:
+      return fgState.EventCounts.ConfigureRaw;
+
+    case GLUT_CONFIGURE_EVENTS_DELIVERED:
+      return fgState.EventCounts.ConfigureDelivered;
+
+    case GLUT_EXPOSE_EVENTS_RAW:
+      return fgState.EventCounts.ExposeRaw;
+
+    case GLUT_EXPOSE_EVENTS_DELIVERED:
+      return fgState.EventCounts.ExposeDelivered;
+
     default:
         fgWarning( "glutGet(): missing enum handle %d", eWhat );
         break;
@@ -598,6 +764,15 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     return -1;
 }
 
+/*
+ * Nanoseconds since glutInit, from a monotonic 64-bit clock. Like
+ * GLUT_ELAPSED_TIME this can be asked for before glutInit.
+ */
+unsigned long long FGAPIENTRY glutGetElapsedTimeNs( void )
+{
+    return fgElapsedTimeNs();
+}
+
 /*
  * Returns various device information.
  */
@@ -647,6 +822,13 @@ int FGAPIENTRY glutDeviceGet( GLenum eWhat )
             return nbuttons;
         }
 
+#elif TARGET_HOST_OSMESA
+
+    /* Nothing to point with when there is nothing to look at */
+    case GLUT_HAS_MOUSE:
+    case GLUT_NUM_MOUSE_BUTTONS:
+        return 0;
+
 #elif TARGET_HOST_MS_WINDOWS
 
     case GLUT_HAS_MOUSE:
@@ -747,7 +929,7 @@ int FGAPIENTRY glutLayerGet( GLenum eWhat )
     switch( eWhat )
     {
 
-#if TARGET_HOST_POSIX_X11
+#if TARGET_HOST_POSIX_X11 || TARGET_HOST_OSMESA
 
     case GLUT_OVERLAY_POSSIBLE:
         return 0;
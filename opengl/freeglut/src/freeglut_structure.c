@@ -674,4 +674,91 @@ void fgListInsert(SFG_List *list, SFG_Node *next, SFG_Node *node)
         list->First = node;
 }
 
+/*
+ * Timer heap functions...
+ */
+static int fghTimerBefore( const SFG_Timer *a, const SFG_Timer *b )
+{
+    if( a->TriggerTime != b->TriggerTime )
+        return a->TriggerTime < b->TriggerTime;
+    return a->Serial < b->Serial;
+}
+
+static void fghTimerHeapPlace( SFG_TimerHeap *heap, SFG_Timer *timer, int index )
+{
+    heap->Timers[ index ] = timer;
+    timer->HeapIndex = index;
+}
+
+static void fghTimerHeapUp( SFG_TimerHeap *heap, int index )
+{
+    SFG_Timer *timer = heap->Timers[ index ];
+
+    while( index > 0 && fghTimerBefore( timer, heap->Timers[ ( index - 1 ) / 2 ] ) )
+    {
+        fghTimerHeapPlace( heap, heap->Timers[ ( index - 1 ) / 2 ], index );
+        index = ( index - 1 ) / 2;
+    }
+    fghTimerHeapPlace( heap, timer, index );
+}
+
+static void fghTimerHeapDown( SFG_TimerHeap *heap, int index )
+{
+    SFG_Timer *timer = heap->Timers[ index ];
+
+    for( ;; )
+    {
+        int child = 2 * index + 1;
+
+        if( child >= heap->Number )
+            break;
+        if( child + 1 < heap->Number &&
+            fghTimerBefore( heap->Timers[ child + 1 ], heap->Timers[ child ] ) )
+            child++;
+        if( !fghTimerBefore( heap->Timers[ child ], timer ) )
+            break;
+
+        fghTimerHeapPlace( heap, heap->Timers[ child ], index );
+        index = child;
+    }
+    fghTimerHeapPlace( heap, timer, index );
+}
+
+/*
+ * Queues a timer on its TriggerTime. Timers due at the same time fire in
+ * the order they were queued, as they did from the old sorted list.
+ */
+void fgTimerHeapInsert( SFG_TimerHeap *heap, SFG_Timer *timer )
+{
+    if( heap->Number == heap->Size )
+    {
+        heap->Size = heap->Size ? heap->Size * 2 : 16;
+        heap->Timers = realloc( heap->Timers, heap->Size * sizeof( SFG_Timer * ) );
+        if( !heap->Timers )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in fgTimerHeapInsert()" );
+    }
+
+    timer->Serial = heap->Serial++;
+    fghTimerHeapPlace( heap, timer, heap->Number++ );
+    fghTimerHeapUp( heap, timer->HeapIndex );
+}
+
+/*
+ * Takes a queued timer out of the heap, wherever it is
+ */
+void fgTimerHeapRemove( SFG_TimerHeap *heap, SFG_Timer *timer )
+{
+    int index = timer->HeapIndex;
+    SFG_Timer *last = heap->Timers[ --heap->Number ];
+
+    timer->HeapIndex = -1;
+    if( last == timer )
+        return;
+
+    fghTimerHeapPlace( heap, last, index );
+    fghTimerHeapUp( heap, index );
+    fghTimerHeapDown( heap, last->HeapIndex );
+}
+
 /*** END OF FILE ***/
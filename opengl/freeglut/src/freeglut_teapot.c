@@ -78,6 +78,143 @@
 
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
+#if !defined(_WIN32_WCE)
+
+/*
+ * The evaluator path below re-uploads and re-evaluates all 32 patches on
+ * every call, which is very slow on most drivers. Instead the patches are
+ * evaluated once on the CPU into an indexed mesh for each (grid, scale),
+ * with the same positions, texture coordinates and automatic normals as
+ * glEvalMesh2 would produce, and the mesh goes into the shape cache.
+ */
+
+/*
+ * Cubic Bernstein basis and its derivative at t
+ */
+static void fghBernstein( double t, double b[4], double d[4] )
+{
+    const double s = 1.0 - t;
+
+    b[0] = s * s * s;
+    b[1] = 3.0 * t * s * s;
+    b[2] = 3.0 * t * t * s;
+    b[3] = t * t * t;
+
+    d[0] = -3.0 * s * s;
+    d[1] =  3.0 * s * s - 6.0 * t * s;
+    d[2] =  6.0 * t * s - 3.0 * t * t;
+    d[3] =  3.0 * t * t;
+}
+
+/*
+ * Evaluates a patch laid out as glMap2d sees it, u along the inner index,
+ * returning the position and the GL_AUTO_NORMAL normal (dP/du x dP/dv)
+ */
+static void fghEvaluatePatch( double cp[4][4][3], double u, double v, double pos[3], double nrm[3] )
+{
+    double bu[4], du[4], bv[4], dv[4];
+    double pu[3] = { 0.0, 0.0, 0.0 }, pv[3] = { 0.0, 0.0, 0.0 };
+    int j, k, l;
+
+    fghBernstein( u, bu, du );
+    fghBernstein( v, bv, dv );
+
+    pos[0] = pos[1] = pos[2] = 0.0;
+
+    for( j = 0; j < 4; j++ )
+        for( k = 0; k < 4; k++ )
+            for( l = 0; l < 3; l++ )
+            {
+                pos[l] += bv[j] * bu[k] * cp[j][k][l];
+                pu[l]  += bv[j] * du[k] * cp[j][k][l];
+                pv[l]  += dv[j] * bu[k] * cp[j][k][l];
+            }
+
+    nrm[0] = pu[1] * pv[2] - pu[2] * pv[1];
+    nrm[1] = pu[2] * pv[0] - pu[0] * pv[2];
+    nrm[2] = pu[0] * pv[1] - pu[1] * pv[0];
+}
+
+/*
+ * Tessellates one patch into the mesh, baking in the transformation that
+ * fghTeapot applies: rotate 270 degrees about x, scale, translate by -1.5 z
+ */
+static void fghTessellatePatch( SFG_Geometry *geometry, double cp[4][4][3], int grid, double scale )
+{
+    const double size = 0.5 * scale;
+    const double sign = ( scale < 0.0 ) ? -1.0 : 1.0;
+    GLuint first = geometry->NumVertices;
+    GLfloat vertex[ 8 ];
+    double pos[3], nrm[3], len;
+    int i, j;
+
+    for( j = 0; j <= grid; j++ )
+        for( i = 0; i <= grid; i++ )
+        {
+            const double u = (double) i / grid, v = (double) j / grid;
+
+            fghEvaluatePatch( cp, u, v, pos, nrm );
+            len = sqrt( nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2] );
+
+            /* Collapsed edges (the lid knob, the bottom) have no normal there, take it from just inside */
+            if( len < 1e-9 )
+            {
+                double inside[3];
+                fghEvaluatePatch( cp, u + ( 0.5 - u ) * 1e-3, v + ( 0.5 - v ) * 1e-3, inside, nrm );
+                len = sqrt( nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2] );
+            }
+            if( len > 0.0 )
+                len = sign / len;
+
+            vertex[0] = (GLfloat) u;
+            vertex[1] = (GLfloat) v;
+            vertex[2] = (GLfloat) (  nrm[0] * len );
+            vertex[3] = (GLfloat) (  nrm[2] * len );
+            vertex[4] = (GLfloat) ( -nrm[1] * len );
+            vertex[5] = (GLfloat) (   pos[0]          * size );
+            vertex[6] = (GLfloat) ( ( pos[2] - 1.5 )  * size );
+            vertex[7] = (GLfloat) (  -pos[1]          * size );
+            fgGeometryVertex( geometry, vertex );
+        }
+
+#   define  V(i,j) ( first + (j) * ( grid + 1 ) + (i) )
+
+    if( geometry->Mode == GL_TRIANGLES )
+    {
+        /* The quad strips of glEvalMesh2( GL_FILL ) */
+        for( j = 0; j < grid; j++ )
+            for( i = 0; i < grid; i++ )
+            {
+                fgGeometryIndex( geometry, V( i, j ) );
+                fgGeometryIndex( geometry, V( i, j + 1 ) );
+                fgGeometryIndex( geometry, V( i + 1, j + 1 ) );
+                fgGeometryIndex( geometry, V( i, j ) );
+                fgGeometryIndex( geometry, V( i + 1, j + 1 ) );
+                fgGeometryIndex( geometry, V( i + 1, j ) );
+            }
+    }
+    else
+    {
+        /* The line strips of glEvalMesh2( GL_LINE ), along u then along v */
+        for( j = 0; j <= grid; j++ )
+            for( i = 0; i < grid; i++ )
+            {
+                fgGeometryIndex( geometry, V( i, j ) );
+                fgGeometryIndex( geometry, V( i + 1, j ) );
+            }
+        for( i = 0; i <= grid; i++ )
+            for( j = 0; j < grid; j++ )
+            {
+                fgGeometryIndex( geometry, V( i, j ) );
+                fgGeometryIndex( geometry, V( i, j + 1 ) );
+            }
+    }
+
+#   undef V
+}
+
+#endif  /* !defined(_WIN32_WCE) */
+
 
 static void fghTeapot( GLint grid, GLdouble scale, GLenum type )
 {
@@ -86,6 +223,25 @@ static void fghTeapot( GLint grid, GLdouble scale, GLenum type )
 #else
     double p[4][4][3], q[4][4][3], r[4][4][3], s[4][4][3];
     long i, j, k, l;
+    SFG_Geometry *geometry = NULL;
+    SFG_GeometryShape shape = ( type == GL_FILL ) ? SFG_SOLID_TEAPOT : SFG_WIRE_TEAPOT;
+
+    if( fgState.GeometryCache && grid > 0 )
+    {
+        geometry = fgFindGeometry( shape, scale, 0.0, grid, 0 );
+
+        if( geometry )
+        {
+            glPushAttrib( GL_ENABLE_BIT );
+            glEnable( GL_NORMALIZE );
+            fgDrawGeometry( geometry );
+            glPopAttrib();
+            return;
+        }
+
+        geometry = fgCreateGeometry( shape, scale, 0.0, grid, 0, GL_T2F_N3F_V3F,
+                                     ( type == GL_FILL ) ? GL_TRIANGLES : GL_LINES );
+    }
 #endif
 
     glPushAttrib( GL_ENABLE_BIT | GL_EVAL_BIT );
@@ -145,6 +301,16 @@ static void fghTeapot( GLint grid, GLdouble scale, GLenum type )
         }
       }
 
+      if (geometry) {
+        fghTessellatePatch(geometry, p, grid, scale);
+        fghTessellatePatch(geometry, q, grid, scale);
+        if (i < 6) {
+          fghTessellatePatch(geometry, r, grid, scale);
+          fghTessellatePatch(geometry, s, grid, scale);
+        }
+        continue;
+      }
+
       glMap2d(GL_MAP2_TEXTURE_COORD_2, 0.0, 1.0, 2, 2, 0.0, 1.0, 4, 2,
         &tex[0][0][0]);
       glMap2d(GL_MAP2_VERTEX_3, 0.0, 1.0, 3, 4, 0.0, 1.0, 12, 4,
@@ -166,6 +332,18 @@ static void fghTeapot( GLint grid, GLdouble scale, GLenum type )
 #endif  /* defined(_WIN32_WCE) */
 
     glPopMatrix();
+
+#if !defined(_WIN32_WCE)
+    /* The mesh was built in place of the evaluation, draw it now */
+    if( geometry )
+    {
+        glDisable( GL_AUTO_NORMAL );
+        glDisable( GL_MAP2_VERTEX_3 );
+        glDisable( GL_MAP2_TEXTURE_COORD_2 );
+        fgDrawGeometry( geometry );
+    }
+#endif
+
     glPopAttrib();
 }
 
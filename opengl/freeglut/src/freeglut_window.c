@@ -180,6 +180,7 @@ static int fghIsLegacyContextRequested( void )
   return fgState.MajorVersion < 2 || (fgState.MajorVersion == 2 && fgState.MinorVersion <= 1);
 }
 
+#if !TARGET_HOST_OSMESA /* OSMesa asks for neither aux buffers nor context flags */
 static int fghNumberOfAuxBuffersRequested( void )
 {
   if ( fgState.DisplayMode & GLUT_AUX4 ) {
@@ -202,6 +203,7 @@ static int fghMapBit( int mask, int from, int to )
   return ( mask & from ) ? to : 0;
 
 }
+#endif
 
 static void fghContextCreationError( void )
 {
@@ -809,6 +811,91 @@ GLboolean fgSetupPixelFormat( SFG_Window* window, GLboolean checkOnly,
 
 #endif  /* TARGET_HOST_MS_WINDOWS */
 
+
+#if TARGET_HOST_OSMESA
+/*
+ * OSMesa renders into memory we hand it, RGBA with the bottom row first.
+ * Versions and profiles need OSMesaCreateContextAttribs() (Mesa 11.2).
+ */
+static OSMesaContext fghCreateNewContext( void )
+{
+    GLint depth   = ( fgState.DisplayMode & GLUT_DEPTH   ) ? 24 : 0;
+    GLint stencil = ( fgState.DisplayMode & GLUT_STENCIL ) ?  8 : 0;
+    GLint accum   = ( fgState.DisplayMode & GLUT_ACCUM   ) ? 16 : 0;
+    OSMesaContext context;
+
+#ifdef OSMESA_CONTEXT_MAJOR_VERSION
+    if ( !fghIsLegacyContextRequested() || fgState.ContextProfile )
+    {
+        int attributes[ 15 ], where = 0;
+
+        ATTRIB_VAL( OSMESA_FORMAT, OSMESA_RGBA );
+        ATTRIB_VAL( OSMESA_DEPTH_BITS, depth );
+        ATTRIB_VAL( OSMESA_STENCIL_BITS, stencil );
+        ATTRIB_VAL( OSMESA_ACCUM_BITS, accum );
+        ATTRIB_VAL( OSMESA_CONTEXT_MAJOR_VERSION, fgState.MajorVersion );
+        ATTRIB_VAL( OSMESA_CONTEXT_MINOR_VERSION, fgState.MinorVersion );
+        if ( fgState.ContextProfile )
+            ATTRIB_VAL( OSMESA_PROFILE,
+                        ( fgState.ContextProfile & GLUT_CORE_PROFILE ) ?
+                        OSMESA_CORE_PROFILE : OSMESA_COMPAT_PROFILE );
+        ATTRIB( 0 );
+
+        context = OSMesaCreateContextAttribs( attributes, NULL );
+    }
+    else
+#else
+    if ( !fghIsLegacyContextRequested() ) {
+        fgWarning( "OpenGL >2.1 context requested but OSMesaCreateContextAttribs is not available! Falling back to legacy context creation" );
+        fgState.MajorVersion = 2;
+        fgState.MinorVersion = 1;
+    }
+#endif
+        context = OSMesaCreateContextExt( OSMESA_RGBA, depth, stencil, accum, NULL );
+
+    if ( context == NULL ) {
+        fghContextCreationError();
+    }
+    return context;
+}
+
+/*
+ * (Re)allocates an offscreen window's buffers for a new size, pointing its
+ * context at the new back buffer if it is current. Single buffered windows
+ * have the one buffer, which is then their front buffer too.
+ */
+void fgResizeOffscreenBuffers( SFG_Window *window, int width, int height )
+{
+    size_t bytes;
+
+    if( width < 1 )
+        width = 1;
+    if( height < 1 )
+        height = 1;
+    if( window->Window.BackBuffer &&
+        window->Window.BufferWidth == width &&
+        window->Window.BufferHeight == height )
+        return;
+
+    if( window->Window.FrontBuffer != window->Window.BackBuffer )
+        free( window->Window.FrontBuffer );
+    free( window->Window.BackBuffer );
+
+    bytes = ( size_t )width * height * 4;
+    window->Window.BackBuffer = (GLubyte *)calloc( bytes, 1 );
+    window->Window.FrontBuffer = window->Window.DoubleBuffered ?
+        (GLubyte *)calloc( bytes, 1 ) : window->Window.BackBuffer;
+    if( !window->Window.BackBuffer || !window->Window.FrontBuffer )
+        fgError( "Out of memory for a %dx%d offscreen window", width, height );
+
+    window->Window.BufferWidth = width;
+    window->Window.BufferHeight = height;
+
+    if( fgStructure.CurrentWindow == window )
+        fgSetWindow( window );
+}
+#endif  /* TARGET_HOST_OSMESA */
+
 /*
  * Sets the OpenGL context and the fgStructure "Current Window" pointer to
  * the window structure passed in.
@@ -841,6 +928,17 @@ void fgSetWindow ( SFG_Window *window )
             );
         }
     }
+#elif TARGET_HOST_OSMESA
+    if ( window )
+    {
+        OSMesaMakeCurrent(
+            window->Window.Context,
+            window->Window.BackBuffer,
+            GL_UNSIGNED_BYTE,
+            window->Window.BufferWidth,
+            window->Window.BufferHeight
+        );
+    }
 #endif
     fgStructure.CurrentWindow = window;
 }
@@ -1464,6 +1562,38 @@ void fgOpenWindow( SFG_Window* window, const char* title,
     UpdateWindow( window->Window.Handle );
     ShowCursor( TRUE );  /* XXX Old comments say "hide cursor"! */
 
+#elif TARGET_HOST_OSMESA
+
+    /*
+     * Nothing to place or decorate: an offscreen window is a context and
+     * the memory it renders into, and stands for its own handle.
+     */
+    (void)title;
+    (void)positionUse;
+    (void)x;
+    (void)y;
+    (void)sizeUse;
+    (void)gameMode;
+    (void)isSubWindow;
+
+    window->Window.Handle = window;
+
+    if( fgState.UseCurrentContext && OSMesaGetCurrentContext( ) )
+        window->Window.Context = OSMesaGetCurrentContext( );
+    else
+        window->Window.Context = fghCreateNewContext( );
+
+    window->Window.DoubleBuffered =
+        ( fgState.DisplayMode & GLUT_DOUBLE ) ? 1 : 0;
+    fgResizeOffscreenBuffers( window, w, h );
+
+    /* Nobody will expose it, so it reshapes and draws on the first pass */
+    window->State.Width = w;
+    window->State.Height = h;
+    window->State.NeedToResize = GL_TRUE;
+    window->State.Visible = GL_TRUE;
+    window->State.Redisplay = GL_TRUE;
+
 #endif
 
     fgSetWindow( window );
@@ -1529,6 +1659,33 @@ void fgCloseWindow( SFG_Window* window )
     }
 
     DestroyWindow( window->Window.Handle );
+#elif TARGET_HOST_OSMESA
+
+    if( fgStructure.CurrentWindow == window )
+        OSMesaMakeCurrent( NULL, NULL, GL_UNSIGNED_BYTE, 0, 0 );
+
+    /* Windows made with GLUT_USE_CURRENT_CONTEXT share one */
+    {
+        int used = FALSE ;
+        SFG_Window *iter ;
+
+        for( iter = (SFG_Window *)fgStructure.Windows.First;
+             iter;
+             iter = (SFG_Window *)iter->Node.Next )
+        {
+            if( ( iter->Window.Context == window->Window.Context ) &&
+                ( iter != window ) )
+                used = TRUE;
+        }
+
+        if( ! used )
+            OSMesaDestroyContext( window->Window.Context );
+    }
+
+    if( window->Window.FrontBuffer != window->Window.BackBuffer )
+        free( window->Window.FrontBuffer );
+    free( window->Window.BackBuffer );
+    window->Window.FrontBuffer = window->Window.BackBuffer = NULL;
 #endif
 }
 
@@ -1680,6 +1837,10 @@ void FGAPIENTRY glutShowWindow( void )
 
     ShowWindow( fgStructure.CurrentWindow->Window.Handle, SW_SHOW );
 
+#elif TARGET_HOST_OSMESA
+
+    fgStructure.CurrentWindow->State.Visible = GL_TRUE;
+
 #endif
 
     fgStructure.CurrentWindow->State.Redisplay = GL_TRUE;
@@ -1708,6 +1869,10 @@ void FGAPIENTRY glutHideWindow( void )
 
     ShowWindow( fgStructure.CurrentWindow->Window.Handle, SW_HIDE );
 
+#elif TARGET_HOST_OSMESA
+
+    fgStructure.CurrentWindow->State.Visible = GL_FALSE;
+
 #endif
 
     fgStructure.CurrentWindow->State.Redisplay = GL_FALSE;
@@ -1774,6 +1939,10 @@ void FGAPIENTRY glutSetWindowTitle( const char* title )
         SetWindowText( fgStructure.CurrentWindow->Window.Handle, title );
 #    endif
 
+#elif TARGET_HOST_OSMESA
+
+        (void)title;  /* offscreen windows have no title bar */
+
 #endif
     }
 }
@@ -1816,6 +1985,10 @@ void FGAPIENTRY glutSetIconTitle( const char* title )
         SetWindowText( fgStructure.CurrentWindow->Window.Handle, title );
 #    endif
 
+#elif TARGET_HOST_OSMESA
+
+        (void)title;  /* offscreen windows have no title bar */
+
 #endif
     }
 }
@@ -1876,6 +2049,11 @@ void FGAPIENTRY glutPositionWindow( int x, int y )
         );
     }
 
+#elif TARGET_HOST_OSMESA
+
+    (void)x;  /* offscreen windows have no position */
+    (void)y;
+
 #endif
 }
 
@@ -2083,6 +2261,8 @@ void FGAPIENTRY glutLeaveFullScreen( void )
         );
 
     win->State.IsFullscreen = GL_FALSE;
+#else
+    (void)win;
 #endif
 }
 
@@ -2107,6 +2287,8 @@ void FGAPIENTRY glutFullScreenToggle( void )
         glutFullScreen();
     else
         glutLeaveFullScreen();
+#else
+    (void)win;
 #endif
 }
 
@@ -80,6 +80,15 @@
 #define __glew_h__
 #define __GLEW_H__
 
+/*
+ * GLEW_MX_TLS is GLEW_MX with the function pointers kept in the GLEWContext
+ * on every platform, and with glewGetContext() provided by GLEW as the
+ * calling thread's current context, set with glewMakeCurrent.
+ */
+#if defined(GLEW_MX_TLS) && !defined(GLEW_MX)
+#  define GLEW_MX
+#endif
+
 #if defined(__gl_h_) || defined(__GL_H__) || defined(__X_GL_H)
 #error gl.h included before glew.h
 #endif
@@ -15023,7 +15032,7 @@ typedef void (GLAPIENTRY * PFNGLADDSWAPHINTRECTWINPROC) (GLint x, GLint y, GLsiz
 
 /* ------------------------------------------------------------------------- */
 
-#if defined(GLEW_MX) && defined(_WIN32)
+#if defined(GLEW_MX) && (defined(_WIN32) || defined(GLEW_MX_TLS))
 #define GLEW_FUN_EXPORT
 #else
 #define GLEW_FUN_EXPORT GLEWAPI
@@ -15035,7 +15044,7 @@ typedef void (GLAPIENTRY * PFNGLADDSWAPHINTRECTWINPROC) (GLint x, GLint y, GLsiz
 #define GLEW_VAR_EXPORT GLEWAPI
 #endif /* GLEW_MX */
 
-#if defined(GLEW_MX) && defined(_WIN32)
+#if defined(GLEW_MX) && (defined(_WIN32) || defined(GLEW_MX_TLS))
 struct GLEWContextStruct
 {
 #endif /* GLEW_MX */
@@ -17461,7 +17470,7 @@ GLEW_FUN_EXPORT PFNGLTEXCOORD4FVERTEX4FVSUNPROC __glewTexCoord4fVertex4fvSUN;
 
 GLEW_FUN_EXPORT PFNGLADDSWAPHINTRECTWINPROC __glewAddSwapHintRectWIN;
 
-#if defined(GLEW_MX) && !defined(_WIN32)
+#if defined(GLEW_MX) && !defined(_WIN32) && !defined(GLEW_MX_TLS)
 struct GLEWContextStruct
 {
 #endif /* GLEW_MX */
@@ -18013,12 +18022,29 @@ GLEWAPI GLboolean GLEWAPIENTRY glewContextIsSupported (const GLEWContext *ctx, c
 #define glewIsExtensionSupported(x) glewIsSupported(x)
 
 #define GLEW_GET_VAR(x) (*(const GLboolean*)&(glewGetContext()->x))
-#ifdef _WIN32
+#if defined(_WIN32) || defined(GLEW_MX_TLS)
 #  define GLEW_GET_FUN(x) glewGetContext()->x
 #else
 #  define GLEW_GET_FUN(x) x
 #endif
 
+#ifdef GLEW_MX_TLS
+#  ifdef _MSC_VER
+#    define GLEW_THREAD_LOCAL __declspec(thread)
+#  else
+#    define GLEW_THREAD_LOCAL __thread
+#  endif
+GLEWAPI void GLEWAPIENTRY glewMakeCurrent (GLEWContext *ctx);
+GLEWAPI GLEWContext * GLEWAPIENTRY glewGetCurrentContext (void);
+#  if defined(_WIN32) && !defined(GLEW_STATIC)
+/* thread-local data cannot be imported from a DLL */
+#    define glewGetContext() glewGetCurrentContext()
+#  else
+GLEWAPI GLEW_THREAD_LOCAL GLEWContext *__glewCurrentContext;
+#    define glewGetContext() __glewCurrentContext
+#  endif
+#endif /* GLEW_MX_TLS */
+
 #else /* GLEW_MX */
 
 GLEWAPI GLenum GLEWAPIENTRY glewInit (void);
@@ -18031,6 +18057,7 @@ GLEWAPI GLboolean GLEWAPIENTRY glewIsSupported (const char *name);
 #endif /* GLEW_MX */
 
 GLEWAPI GLboolean glewExperimental;
+GLEWAPI GLboolean glewLazy;
 GLEWAPI GLboolean GLEWAPIENTRY glewGetExtension (const char *name);
 GLEWAPI const GLubyte * GLEWAPIENTRY glewGetErrorString (GLenum error);
 GLEWAPI const GLubyte * GLEWAPIENTRY glewGetString (GLenum name);
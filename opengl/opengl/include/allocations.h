@@ -0,0 +1,47 @@
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+/*counts the heap allocations each thread makes through operator new, which every container and string in the program
+ goes through; what C code allocates (freeglut, the driver) is not seen. The main thread's allocations are also kept
+ per frame, from BeginFrame to EndFrame, and per Region. A steady state frame should allocate nothing: with
+ "-allocations assert <frames>", the first allocation in any frame after the first <frames> aborts, so the culprit is
+ on the stack*/
+class Allocations
+{
+public:
+	struct Counts
+	{
+		unsigned long Allocations;
+		unsigned long long Bytes;
+	};
+	enum { MAX_REGIONS = 32 };
+
+	//counts what the main thread allocates under Name, a string literal, until it goes out of scope
+	class Region
+	{
+	public:
+		Region( char const * Name );
+		~Region();
+
+	private:
+		char const * m_name;
+		Counts m_start;
+
+		Region( Region const & );
+		Region & operator=( Region const & );
+	};
+
+	//"-allocations report <frames>": a line per <frames> frames with the allocations per frame and per region;
+	//"-allocations assert <frames>": aborts on an allocation in a frame after the first <frames>. Removes the arguments
+	static void FromCommandLine( int & argc, char ** argv );
+	//what the calling thread has allocated so far
+	static Counts Thread();
+	//call on the main thread
+	static void BeginFrame();
+	static void EndFrame();
+
+	//used by the replaced operator new
+	static void Allocated( unsigned long long Bytes );
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*a workload that takes over the frame loop when the program is started with "-benchmark <name>"
+ benchmarks register themselves by having a static instance*/
+class Benchmark
+{
+public:
+	Benchmark( char const * Name, char const * Description );
+	virtual ~Benchmark() {}
+
+	//called once GL and the scene resources are up
+	virtual void Setup() {}
+	//draws one frame into the cleared back buffer, returns false once the results are reported
+	virtual bool Frame() = 0;
+
+	char const * GetName() const { return m_name; }
+
+	//finds the benchmark named after "-benchmark" and removes both arguments, NULL if there is none
+	static Benchmark * FromCommandLine( int & argc, char ** argv );
+	//freeglut's monotonic nanosecond clock, in seconds
+	static double Now();
+	//what DrawScene draws, set by the program
+	static void SetScene( void (*Draw)() );
+
+protected:
+	//one result per line: benchmark, case, metric, value, unit, so runs can be diffed and parsed
+	void Report( char const * Case, char const * Metric, double Value, char const * Unit ) const;
+	//draws a frame of the program's own scene, for benchmarks that measure it rather than replace it
+	static void DrawScene();
+
+private:
+	char const * m_name;
+	char const * m_description;
+	Benchmark * m_next;
+	static Benchmark * s_first;
+	static void (*s_scene)();
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef FRAMETIMES_H
+#define FRAMETIMES_H
+
+/*counts values in buckets that grow with the value, HDR histogram style: exact below 2 * SUB_BUCKETS, then every power
+ of two split into SUB_BUCKETS, so any value lands within 1 / SUB_BUCKETS of its bucket. Recording is a few
+ instructions and never allocates; the percentiles are worked out from the buckets when asked for*/
+class Histogram
+{
+public:
+	enum { SUB_BITS = 5, SUB_BUCKETS = 1 << SUB_BITS, BUCKET_COUNT = ( 64 - SUB_BITS + 1 ) * SUB_BUCKETS };
+
+	Histogram() { Reset(); }
+	void Reset();
+	void Record( unsigned long long Value );
+
+	unsigned long long Count() const { return m_count; }
+	unsigned long long Min() const { return m_count ? m_min : 0; }
+	unsigned long long Max() const { return m_max; }
+	//the value Percent of the values are at or under, to the bucket's precision, 0 with nothing recorded
+	unsigned long long Percentile( double Percent ) const;
+	unsigned long long BucketCount( int Bucket ) const { return m_buckets[ Bucket ]; }
+	static unsigned long long BucketLow( int Bucket );
+	static unsigned long long BucketHigh( int Bucket ); //the last value the bucket holds
+
+private:
+	unsigned long long m_buckets[ BUCKET_COUNT ];
+	unsigned long long m_count;
+	unsigned long long m_min;
+	unsigned long long m_max;
+
+	static int BucketOf( unsigned long long Value );
+};
+
+/*every frame's CPU time (from the start of Advance to the swap), simulation time (the camera and every Update) and
+ the interval between one swap and the next, in nanoseconds. The overlay shows their p50/p95/p99/max; the whole
+ histograms are written out when the program closes*/
+class FrameTimes
+{
+public:
+	enum Kind
+	{
+		CPU_TIME,
+		SIM_TIME,
+		SWAP_INTERVAL,
+		KIND_COUNT
+	};
+
+	FrameTimes();
+	//"-frametimes <path>": where the histograms go at exit instead of frametimes.txt, removes both arguments
+	void FromCommandLine( int & argc, char ** argv );
+
+	void Record( Kind Which, unsigned long long Nanoseconds ) { m_histograms[ Which ].Record( Nanoseconds ); }
+	//call right after the swap; the first swap only starts the first interval
+	void Swapped( unsigned long long Now );
+	Histogram const & Get( Kind Which ) const { return m_histograms[ Which ]; }
+	static char const * Name( Kind Which );
+
+	//the percentiles in the top left corner of the viewport, over whatever is drawn; leaves the GL state as it was
+	void DrawOverlay() const;
+	bool Write() const;
+
+private:
+	Histogram m_histograms[ KIND_COUNT ];
+	unsigned long long m_lastswap;
+	char m_path[ 512 ];
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef GLCAPTURE_H
+#define GLCAPTURE_H
+
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <stdio.h>
+#include <vector>
+
+/*records every GL call the program makes, with its arguments, for a window of frames into a binary trace that
+ GLReplay re-issues against any context. Capturing needs a build with GL_TRACE: the trace macros send each call through
+ the hook below named after it (without the gl or glu prefix) while Capturing is set. A trace is a Header, then per call
+ a byte opcode (GLTrace's numbering of the function) and its arguments in native byte order, with FRAME_END closing
+ each frame. Data a call reads is copied in: buffer and texture uploads, client-side indices and vectors passed by
+ pointer. Names the program generated are recorded as it saw them and translated on replay. Capturing starts with the
+ program, so the first frame also carries everything set up before it. Draws from client-side vertex arrays are not
+ captured, only counted; the program's meshes always draw from buffers*/
+class GLCapture
+{
+public:
+	enum { VERSION = 1, FRAME_END = 255 };
+
+	struct Header
+	{
+		char Magic[ 8 ]; //"GLCAPTUR"
+		unsigned Version;
+		unsigned Functions; //GLTrace::FUNCTION_COUNT, as the opcodes depend on it
+		unsigned Frames; //including the first
+		int Width; //the viewport the first frame with one ended with
+		int Height;
+	};
+
+	static bool Capturing;
+
+	//"-capture <trace> <frames>": captures the setup and the first <frames> frames after it, removes the arguments;
+	//exits if the build has no GL_TRACE or the trace cannot be written
+	static void FromCommandLine( int & argc, char ** argv );
+	//closes the frame in the trace, and the trace once it has all its frames; call it just before swapping
+	static void EndFrame();
+	//finishes the trace early, at exit
+	static void Close();
+	//how many floats the vector forms of glLight, glLightModel, glMaterial and glFog read for pname
+	static int ParamCount( GLenum pname );
+
+	//hooks, with GL's own signatures
+	static void Begin( GLenum mode );
+	static void End();
+	static void Vertex3f( GLfloat x, GLfloat y, GLfloat z );
+	static void Vertex3fv( GLfloat const * v );
+	static void Normal3f( GLfloat nx, GLfloat ny, GLfloat nz );
+	static void Normal3fv( GLfloat const * v );
+	static void TexCoord2f( GLfloat s, GLfloat t );
+	static void TexCoord2fv( GLfloat const * v );
+	static void Color3f( GLfloat red, GLfloat green, GLfloat blue );
+	static void Color3fv( GLfloat const * v );
+	static void Color4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha );
+	static void Color4fv( GLfloat const * v );
+	static void MatrixMode( GLenum mode );
+	static void LoadIdentity();
+	static void LoadMatrixf( GLfloat const * m );
+	static void MultMatrixf( GLfloat const * m );
+	static void PushMatrix();
+	static void PopMatrix();
+	static void Translatef( GLfloat x, GLfloat y, GLfloat z );
+	static void Rotatef( GLfloat angle, GLfloat x, GLfloat y, GLfloat z );
+	static void Scalef( GLfloat x, GLfloat y, GLfloat z );
+	static void Frustum( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar );
+	static void Ortho( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar );
+	static void LookAt( GLdouble eyeX, GLdouble eyeY, GLdouble eyeZ, GLdouble centerX, GLdouble centerY, GLdouble centerZ,
+		GLdouble upX, GLdouble upY, GLdouble upZ );
+	static void Perspective( GLdouble fovy, GLdouble aspect, GLdouble zNear, GLdouble zFar );
+	static void Viewport( GLint x, GLint y, GLsizei width, GLsizei height );
+	static void Enable( GLenum cap );
+	static void Disable( GLenum cap );
+	static void ShadeModel( GLenum mode );
+	static void PolygonMode( GLenum face, GLenum mode );
+	static void DepthFunc( GLenum func );
+	static void BlendFunc( GLenum sfactor, GLenum dfactor );
+	static void CullFace( GLenum mode );
+	static void PushAttrib( GLbitfield mask );
+	static void PopAttrib();
+	static void PushClientAttrib( GLbitfield mask );
+	static void PopClientAttrib();
+	static void Lightf( GLenum light, GLenum pname, GLfloat param );
+	static void Lightfv( GLenum light, GLenum pname, GLfloat const * params );
+	static void LightModelfv( GLenum pname, GLfloat const * params );
+	static void Materialf( GLenum face, GLenum pname, GLfloat param );
+	static void Materialfv( GLenum face, GLenum pname, GLfloat const * params );
+	static void ColorMaterial( GLenum face, GLenum mode );
+	static void Fogi( GLenum pname, GLint param );
+	static void Fogf( GLenum pname, GLfloat param );
+	static void Fogfv( GLenum pname, GLfloat const * params );
+	static void ClearColor( GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha );
+	static void Clear( GLbitfield mask );
+	static void Flush();
+	static void Finish();
+	static void NewList( GLuint list, GLenum mode );
+	static void EndList();
+	static void CallList( GLuint list );
+	static void BindTexture( GLenum target, GLuint texture );
+	static void TexParameteri( GLenum target, GLenum pname, GLint param );
+	static void TexParameterf( GLenum target, GLenum pname, GLfloat param );
+	static void TexEnvf( GLenum target, GLenum pname, GLfloat param );
+	static void PixelStorei( GLenum pname, GLint param );
+	static void EnableClientState( GLenum array );
+	static void DisableClientState( GLenum array );
+	static void VertexPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer );
+	static void NormalPointer( GLenum type, GLsizei stride, GLvoid const * pointer );
+	static void TexCoordPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer );
+	static void ColorPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer );
+	static void ActiveTexture( GLenum texture );
+	static void ClientActiveTexture( GLenum texture );
+	static void BindBuffer( GLenum target, GLuint buffer );
+	static GLvoid * MapBuffer( GLenum target, GLenum access );
+	static GLboolean UnmapBuffer( GLenum target );
+	static GLuint GenLists( GLsizei range );
+	static void DeleteLists( GLuint list, GLsizei range );
+	static void GenTextures( GLsizei n, GLuint * textures );
+	static void DeleteTextures( GLsizei n, GLuint const * textures );
+	static void TexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border,
+		GLenum format, GLenum type, GLvoid const * pixels );
+	static void TexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, GLvoid const * pixels );
+	static GLint Build2DMipmaps( GLenum target, GLint components, GLint width, GLint height, GLenum format, GLenum type,
+		void const * data );
+	static void ReadPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid * pixels );
+	static void DrawArrays( GLenum mode, GLint first, GLsizei count );
+	static void DrawElements( GLenum mode, GLsizei count, GLenum type, GLvoid const * indices );
+	static void DrawRangeElements( GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, GLvoid const * indices );
+	static void GenBuffers( GLsizei n, GLuint * buffers );
+	static void DeleteBuffers( GLsizei n, GLuint const * buffers );
+	static void BufferData( GLenum target, GLsizeiptr size, GLvoid const * data, GLenum usage );
+	static void BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const * data );
+
+private:
+	static FILE * s_file;
+	static std::vector< unsigned char > s_buffer; //the frame being captured
+	static Header s_header;
+	static unsigned s_frames; //wanted, after the first
+	static double s_calls;
+	static double s_bytes;
+	static unsigned s_skipped; //draws from client-side arrays
+
+	static void Op( int Function );
+	template< typename T > static void Put( T Value )
+	{
+		unsigned char const * const bytes = (unsigned char const *)&Value;
+		s_buffer.insert( s_buffer.end(), bytes, bytes + sizeof( Value ) );
+	}
+	static void PutArray( GLfloat const * Values, int Count );
+	static void PutPointer( GLvoid const * Pointer ); //an offset into a bound buffer
+	static void PutBlob( void const * Data, size_t Bytes );
+	//the bytes an image of this size takes in client memory, by the pack or unpack alignment and row length
+	static size_t ClientImageBytes( GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, bool Unpack );
+	static bool ClientArrays(); //whether an enabled vertex array is in client memory
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef GLREPLAY_H
+#define GLREPLAY_H
+
+#include <glcapture.h>
+#include <vector>
+#include <map>
+#include <string.h>
+
+/*re-issues a GLCapture trace against the current context, with none of the program's simulation: the first frame,
+ which carries the setup, once, then the rest over and over as fast as they go, timing how long the calls take to
+ issue and how long the frame takes to finish. The same trace gives the same workload on any driver*/
+class GLReplay
+{
+public:
+	//"-replay <trace> <passes>": reads the trace and removes the arguments, NULL if there are none; exits if the
+	//trace cannot be read or was captured by a build with other opcodes
+	static GLReplay * FromCommandLine( int & argc, char ** argv );
+
+	int GetWidth() const { return m_header.Width; }
+	int GetHeight() const { return m_header.Height; }
+	//needs a current context the trace's size; returns false if the trace turned out to be cut short or corrupt
+	bool Run();
+
+private:
+	GLCapture::Header m_header;
+	std::vector< unsigned char > m_trace;
+	size_t m_cursor;
+	unsigned m_passes;
+	bool m_corrupt;
+	std::map< GLuint, GLuint > m_textures; //the name the program saw to the name this context gave
+	std::map< GLuint, GLuint > m_buffers;
+	std::map< GLuint, GLuint > m_lists;
+	std::vector< unsigned char > m_scratch; //what glReadPixels into client memory reads into
+
+	GLReplay( unsigned Passes );
+
+	template< typename T > T Get()
+	{
+		T value = T();
+		if( m_cursor + sizeof( T ) > m_trace.size() )
+			m_corrupt = true;
+		else
+			memcpy( &value, &m_trace[ m_cursor ], sizeof( T ) );
+		m_cursor += sizeof( T );
+		return value;
+	}
+	void GetArray( GLfloat * Values, int Count );
+	GLvoid const * GetPointer(); //an offset into a bound buffer
+	GLvoid const * GetBlob( size_t * Bytes = NULL ); //points into the trace, NULL for an empty one
+	static GLuint Translate( std::map< GLuint, GLuint > const & Names, GLuint Name );
+	static void Generated( std::map< GLuint, GLuint > & Names, std::vector< GLuint > const & Recorded, std::vector< GLuint > const & Made );
+	unsigned Frame(); //issues the calls up to the end of the frame, returns how many
+};
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef GLTRACE_H
+#define GLTRACE_H
+
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <glcapture.h>
+
+/*counts the GL calls the program makes, the time spent inside them and the bytes they upload, per function per frame.
+ The interposition is compile-time: in a build with GL_TRACE defined, every call below that a source file makes after
+ including this header (last, after the GL headers) goes through a macro that times it, both the core GL 1.x entry
+ points and the ones dispatched through GLEW. Without GL_TRACE the calls are untouched and nothing is counted, and
+ "-trace" says so. Calls made inside freeglut and GLU (the glut shapes, the levels gluBuild2DMipmaps builds) are not
+ seen, only the call that made them. While GLCapture is capturing, the calls go through its hooks instead*/
+#define GLTRACE_FUNCTIONS( X ) \
+	X( glBegin ) X( glEnd ) X( glVertex3f ) X( glVertex3fv ) X( glNormal3f ) X( glNormal3fv ) X( glTexCoord2f ) \
+	X( glTexCoord2fv ) X( glColor3f ) X( glColor3fv ) X( glColor4f ) X( glColor4fv ) \
+	X( glMatrixMode ) X( glLoadIdentity ) X( glLoadMatrixf ) X( glMultMatrixf ) X( glPushMatrix ) X( glPopMatrix ) \
+	X( glTranslatef ) X( glRotatef ) X( glScalef ) X( glFrustum ) X( glOrtho ) X( gluLookAt ) X( gluPerspective ) \
+	X( glViewport ) X( glEnable ) X( glDisable ) X( glShadeModel ) X( glPolygonMode ) X( glDepthFunc ) \
+	X( glBlendFunc ) X( glCullFace ) X( glPushAttrib ) X( glPopAttrib ) X( glPushClientAttrib ) X( glPopClientAttrib ) \
+	X( glLightf ) X( glLightfv ) X( glLightModelfv ) X( glMaterialf ) X( glMaterialfv ) X( glColorMaterial ) \
+	X( glFogi ) X( glFogf ) X( glFogfv ) X( glClearColor ) X( glClear ) X( glFlush ) X( glFinish ) X( glGetError ) \
+	X( glGetIntegerv ) X( glGetFloatv ) X( glGenLists ) X( glNewList ) X( glEndList ) X( glCallList ) X( glDeleteLists ) \
+	X( glGenTextures ) X( glBindTexture ) X( glDeleteTextures ) X( glTexParameteri ) X( glTexParameterf ) X( glTexEnvf ) \
+	X( glTexImage2D ) X( glTexSubImage2D ) X( gluBuild2DMipmaps ) X( glPixelStorei ) X( glReadPixels ) \
+	X( glEnableClientState ) X( glDisableClientState ) X( glVertexPointer ) X( glNormalPointer ) X( glTexCoordPointer ) \
+	X( glColorPointer ) X( glDrawArrays ) X( glDrawElements ) X( glDrawRangeElements ) X( glActiveTexture ) \
+	X( glClientActiveTexture ) X( glGenBuffers ) X( glBindBuffer ) X( glBufferData ) X( glBufferSubData ) \
+	X( glMapBuffer ) X( glUnmapBuffer ) X( glDeleteBuffers )
+
+#define GLTRACE_ENUM( Name ) Name##_CALL,
+
+class GLTrace
+{
+public:
+	enum Function { GLTRACE_FUNCTIONS( GLTRACE_ENUM ) FUNCTION_COUNT };
+	enum Mode
+	{
+		OFF_MODE,
+		TOP_MODE, //a table of the TOP_COUNT most called functions on exit
+		FRAMES_MODE //a summary line per frame as well
+	};
+	enum { TOP_COUNT = 20 };
+
+	struct Totals
+	{
+		unsigned Calls;
+		double Seconds; //inside GL, less the clock read each call's time includes
+		double Bytes; //uploaded
+	};
+
+	//times one call, from before its arguments are evaluated to the end of the full expression it is in
+	class Scope
+	{
+		Function m_function;
+		double m_bytes;
+		unsigned long long m_start;
+	public:
+		Scope( Function Called, double Bytes = 0.0 ) : m_function( Called ), m_bytes( Bytes ), m_start( glutGetElapsedTimeNs() ) {}
+		~Scope()
+		{
+			++s_frame.Calls[ m_function ];
+			s_frame.Nanoseconds[ m_function ] += glutGetElapsedTimeNs() - m_start;
+			s_frame.Bytes[ m_function ] += m_bytes;
+		}
+	};
+
+	//"-trace <top|frames>", removes both arguments; exits if the build has no GL_TRACE
+	static void FromCommandLine( int & argc, char ** argv );
+	//closes the frame's counts, call it just before swapping
+	static void EndFrame();
+	//prints the table, at exit
+	static void Finish();
+	//what the current frame has counted so far
+	static Totals FrameTotals();
+	//the bytes an image of this size, format and type holds, ignoring the unpack alignment
+	static double ImageBytes( int Width, int Height, GLenum Format, GLenum Type );
+
+private:
+	struct Counters
+	{
+		unsigned Calls[ FUNCTION_COUNT ];
+		unsigned long long Nanoseconds[ FUNCTION_COUNT ];
+		double Bytes[ FUNCTION_COUNT ];
+	};
+
+	static Counters s_frame;
+	static Counters s_total;
+	static unsigned s_frames;
+	static Mode s_mode;
+	static char const * const s_names[ FUNCTION_COUNT ];
+
+	static double ClockNanoseconds(); //what one read of the clock costs, measured on first use
+	static double Net( unsigned long long Nanoseconds, unsigned Calls );
+};
+
+#if defined( GL_TRACE ) && !defined( GLTRACE_REAL_CALLS )
+
+/*the uploads go through functions so their arguments are only evaluated once; they are declared before the macros
+ so the calls inside are the real ones*/
+inline void GLTraceTexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border,
+	GLenum format, GLenum type, GLvoid const * pixels )
+{
+	GLTrace::Scope scope( GLTrace::glTexImage2D_CALL, pixels ? GLTrace::ImageBytes( width, height, format, type ) : 0.0 );
+	if( GLCapture::Capturing )
+		GLCapture::TexImage2D( target, level, internalformat, width, height, border, format, type, pixels );
+	else
+		glTexImage2D( target, level, internalformat, width, height, border, format, type, pixels );
+}
+inline void GLTraceTexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, GLvoid const * pixels )
+{
+	GLTrace::Scope scope( GLTrace::glTexSubImage2D_CALL, pixels ? GLTrace::ImageBytes( width, height, format, type ) : 0.0 );
+	if( GLCapture::Capturing )
+		GLCapture::TexSubImage2D( target, level, xoffset, yoffset, width, height, format, type, pixels );
+	else
+		glTexSubImage2D( target, level, xoffset, yoffset, width, height, format, type, pixels );
+}
+//the base level and the levels built from it, about a third more
+inline GLint GLTraceBuild2DMipmaps( GLenum target, GLint components, GLint width, GLint height, GLenum format, GLenum type,
+	void const * data )
+{
+	GLTrace::Scope scope( GLTrace::gluBuild2DMipmaps_CALL, GLTrace::ImageBytes( width, height, format, type ) * 4.0 / 3.0 );
+	if( GLCapture::Capturing )
+		return GLCapture::Build2DMipmaps( target, components, width, height, format, type, data );
+	return gluBuild2DMipmaps( target, components, width, height, format, type, data );
+}
+inline void GLTraceBufferData( GLenum target, GLsizeiptr size, GLvoid const * data, GLenum usage )
+{
+	GLTrace::Scope scope( GLTrace::glBufferData_CALL, data ? (double)size : 0.0 );
+	if( GLCapture::Capturing )
+		GLCapture::BufferData( target, size, data, usage );
+	else
+		glBufferData( target, size, data, usage );
+}
+inline void GLTraceBufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const * data )
+{
+	GLTrace::Scope scope( GLTrace::glBufferSubData_CALL, (double)size );
+	if( GLCapture::Capturing )
+		GLCapture::BufferSubData( target, offset, size, data );
+	else
+		glBufferSubData( target, offset, size, data );
+}
+
+//a comma expression, so calls that return something still do
+#define GLTRACE_CALL( Name, Call ) ( GLTrace::Scope( GLTrace::Name##_CALL ), Call )
+#define GLTRACE_CAPTURE( Hook, Call, ... ) ( GLCapture::Capturing ? GLCapture::Hook( __VA_ARGS__ ) : Call( __VA_ARGS__ ) )
+#define GLTRACE_CORE( Name, Hook, ... ) GLTRACE_CALL( Name, GLTRACE_CAPTURE( Hook, Name, __VA_ARGS__ ) )
+#define GLTRACE_GLEW( Name, Hook, ... ) GLTRACE_CALL( Name, GLTRACE_CAPTURE( Hook, GLEW_GET_FUN( __glew##Hook ), __VA_ARGS__ ) )
+//queries change nothing a replay needs
+#define GLTRACE_QUERY( Name, ... ) GLTRACE_CALL( Name, Name( __VA_ARGS__ ) )
+
+#define glBegin( ... ) GLTRACE_CORE( glBegin, Begin, __VA_ARGS__ )
+#define glEnd( ... ) GLTRACE_CORE( glEnd, End, __VA_ARGS__ )
+#define glVertex3f( ... ) GLTRACE_CORE( glVertex3f, Vertex3f, __VA_ARGS__ )
+#define glVertex3fv( ... ) GLTRACE_CORE( glVertex3fv, Vertex3fv, __VA_ARGS__ )
+#define glNormal3f( ... ) GLTRACE_CORE( glNormal3f, Normal3f, __VA_ARGS__ )
+#define glNormal3fv( ... ) GLTRACE_CORE( glNormal3fv, Normal3fv, __VA_ARGS__ )
+#define glTexCoord2f( ... ) GLTRACE_CORE( glTexCoord2f, TexCoord2f, __VA_ARGS__ )
+#define glTexCoord2fv( ... ) GLTRACE_CORE( glTexCoord2fv, TexCoord2fv, __VA_ARGS__ )
+#define glColor3f( ... ) GLTRACE_CORE( glColor3f, Color3f, __VA_ARGS__ )
+#define glColor3fv( ... ) GLTRACE_CORE( glColor3fv, Color3fv, __VA_ARGS__ )
+#define glColor4f( ... ) GLTRACE_CORE( glColor4f, Color4f, __VA_ARGS__ )
+#define glColor4fv( ... ) GLTRACE_CORE( glColor4fv, Color4fv, __VA_ARGS__ )
+#define glMatrixMode( ... ) GLTRACE_CORE( glMatrixMode, MatrixMode, __VA_ARGS__ )
+#define glLoadIdentity( ... ) GLTRACE_CORE( glLoadIdentity, LoadIdentity, __VA_ARGS__ )
+#define glLoadMatrixf( ... ) GLTRACE_CORE( glLoadMatrixf, LoadMatrixf, __VA_ARGS__ )
+#define glMultMatrixf( ... ) GLTRACE_CORE( glMultMatrixf, MultMatrixf, __VA_ARGS__ )
+#define glPushMatrix( ... ) GLTRACE_CORE( glPushMatrix, PushMatrix, __VA_ARGS__ )
+#define glPopMatrix( ... ) GLTRACE_CORE( glPopMatrix, PopMatrix, __VA_ARGS__ )
+#define glTranslatef( ... ) GLTRACE_CORE( glTranslatef, Translatef, __VA_ARGS__ )
+#define glRotatef( ... ) GLTRACE_CORE( glRotatef, Rotatef, __VA_ARGS__ )
+#define glScalef( ... ) GLTRACE_CORE( glScalef, Scalef, __VA_ARGS__ )
+#define glFrustum( ... ) GLTRACE_CORE( glFrustum, Frustum, __VA_ARGS__ )
+#define glOrtho( ... ) GLTRACE_CORE( glOrtho, Ortho, __VA_ARGS__ )
+#define gluLookAt( ... ) GLTRACE_CORE( gluLookAt, LookAt, __VA_ARGS__ )
+#define gluPerspective( ... ) GLTRACE_CORE( gluPerspective, Perspective, __VA_ARGS__ )
+#define glViewport( ... ) GLTRACE_CORE( glViewport, Viewport, __VA_ARGS__ )
+#define glEnable( ... ) GLTRACE_CORE( glEnable, Enable, __VA_ARGS__ )
+#define glDisable( ... ) GLTRACE_CORE( glDisable, Disable, __VA_ARGS__ )
+#define glShadeModel( ... ) GLTRACE_CORE( glShadeModel, ShadeModel, __VA_ARGS__ )
+#define glPolygonMode( ... ) GLTRACE_CORE( glPolygonMode, PolygonMode, __VA_ARGS__ )
+#define glDepthFunc( ... ) GLTRACE_CORE( glDepthFunc, DepthFunc, __VA_ARGS__ )
+#define glBlendFunc( ... ) GLTRACE_CORE( glBlendFunc, BlendFunc, __VA_ARGS__ )
+#define glCullFace( ... ) GLTRACE_CORE( glCullFace, CullFace, __VA_ARGS__ )
+#define glPushAttrib( ... ) GLTRACE_CORE( glPushAttrib, PushAttrib, __VA_ARGS__ )
+#define glPopAttrib( ... ) GLTRACE_CORE( glPopAttrib, PopAttrib, __VA_ARGS__ )
+#define glPushClientAttrib( ... ) GLTRACE_CORE( glPushClientAttrib, PushClientAttrib, __VA_ARGS__ )
+#define glPopClientAttrib( ... ) GLTRACE_CORE( glPopClientAttrib, PopClientAttrib, __VA_ARGS__ )
+#define glLightf( ... ) GLTRACE_CORE( glLightf, Lightf, __VA_ARGS__ )
+#define glLightfv( ... ) GLTRACE_CORE( glLightfv, Lightfv, __VA_ARGS__ )
+#define glLightModelfv( ... ) GLTRACE_CORE( glLightModelfv, LightModelfv, __VA_ARGS__ )
+#define glMaterialf( ... ) GLTRACE_CORE( glMaterialf, Materialf, __VA_ARGS__ )
+#define glMaterialfv( ... ) GLTRACE_CORE( glMaterialfv, Materialfv, __VA_ARGS__ )
+#define glColorMaterial( ... ) GLTRACE_CORE( glColorMaterial, ColorMaterial, __VA_ARGS__ )
+#define glFogi( ... ) GLTRACE_CORE( glFogi, Fogi, __VA_ARGS__ )
+#define glFogf( ... ) GLTRACE_CORE( glFogf, Fogf, __VA_ARGS__ )
+#define glFogfv( ... ) GLTRACE_CORE( glFogfv, Fogfv, __VA_ARGS__ )
+#define glClearColor( ... ) GLTRACE_CORE( glClearColor, ClearColor, __VA_ARGS__ )
+#define glClear( ... ) GLTRACE_CORE( glClear, Clear, __VA_ARGS__ )
+#define glFlush( ... ) GLTRACE_CORE( glFlush, Flush, __VA_ARGS__ )
+#define glFinish( ... ) GLTRACE_CORE( glFinish, Finish, __VA_ARGS__ )
+#define glGetError( ... ) GLTRACE_QUERY( glGetError, __VA_ARGS__ )
+#define glGetIntegerv( ... ) GLTRACE_QUERY( glGetIntegerv, __VA_ARGS__ )
+#define glGetFloatv( ... ) GLTRACE_QUERY( glGetFloatv, __VA_ARGS__ )
+#define glGenLists( ... ) GLTRACE_CORE( glGenLists, GenLists, __VA_ARGS__ )
+#define glNewList( ... ) GLTRACE_CORE( glNewList, NewList, __VA_ARGS__ )
+#define glEndList( ... ) GLTRACE_CORE( glEndList, EndList, __VA_ARGS__ )
+#define glCallList( ... ) GLTRACE_CORE( glCallList, CallList, __VA_ARGS__ )
+#define glDeleteLists( ... ) GLTRACE_CORE( glDeleteLists, DeleteLists, __VA_ARGS__ )
+#define glGenTextures( ... ) GLTRACE_CORE( glGenTextures, GenTextures, __VA_ARGS__ )
+#define glBindTexture( ... ) GLTRACE_CORE( glBindTexture, BindTexture, __VA_ARGS__ )
+#define glDeleteTextures( ... ) GLTRACE_CORE( glDeleteTextures, DeleteTextures, __VA_ARGS__ )
+#define glTexParameteri( ... ) GLTRACE_CORE( glTexParameteri, TexParameteri, __VA_ARGS__ )
+#define glTexParameterf( ... ) GLTRACE_CORE( glTexParameterf, TexParameterf, __VA_ARGS__ )
+#define glTexEnvf( ... ) GLTRACE_CORE( glTexEnvf, TexEnvf, __VA_ARGS__ )
+#define glTexImage2D GLTraceTexImage2D
+#define glTexSubImage2D GLTraceTexSubImage2D
+#define gluBuild2DMipmaps GLTraceBuild2DMipmaps
+#define glPixelStorei( ... ) GLTRACE_CORE( glPixelStorei, PixelStorei, __VA_ARGS__ )
+#define glReadPixels( ... ) GLTRACE_CORE( glReadPixels, ReadPixels, __VA_ARGS__ )
+#define glEnableClientState( ... ) GLTRACE_CORE( glEnableClientState, EnableClientState, __VA_ARGS__ )
+#define glDisableClientState( ... ) GLTRACE_CORE( glDisableClientState, DisableClientState, __VA_ARGS__ )
+#define glVertexPointer( ... ) GLTRACE_CORE( glVertexPointer, VertexPointer, __VA_ARGS__ )
+#define glNormalPointer( ... ) GLTRACE_CORE( glNormalPointer, NormalPointer, __VA_ARGS__ )
+#define glTexCoordPointer( ... ) GLTRACE_CORE( glTexCoordPointer, TexCoordPointer, __VA_ARGS__ )
+#define glColorPointer( ... ) GLTRACE_CORE( glColorPointer, ColorPointer, __VA_ARGS__ )
+#define glDrawArrays( ... ) GLTRACE_CORE( glDrawArrays, DrawArrays, __VA_ARGS__ )
+#define glDrawElements( ... ) GLTRACE_CORE( glDrawElements, DrawElements, __VA_ARGS__ )
+
+//GLEW's entry points are already macros over its dispatch
+#undef glDrawRangeElements
+#undef glActiveTexture
+#undef glClientActiveTexture
+#undef glGenBuffers
+#undef glBindBuffer
+#undef glBufferData
+#undef glBufferSubData
+#undef glMapBuffer
+#undef glUnmapBuffer
+#undef glDeleteBuffers
+#define glDrawRangeElements( ... ) GLTRACE_GLEW( glDrawRangeElements, DrawRangeElements, __VA_ARGS__ )
+#define glActiveTexture( ... ) GLTRACE_GLEW( glActiveTexture, ActiveTexture, __VA_ARGS__ )
+#define glClientActiveTexture( ... ) GLTRACE_GLEW( glClientActiveTexture, ClientActiveTexture, __VA_ARGS__ )
+#define glGenBuffers( ... ) GLTRACE_GLEW( glGenBuffers, GenBuffers, __VA_ARGS__ )
+#define glBindBuffer( ... ) GLTRACE_GLEW( glBindBuffer, BindBuffer, __VA_ARGS__ )
+#define glBufferData GLTraceBufferData
+#define glBufferSubData GLTraceBufferSubData
+#define glMapBuffer( ... ) GLTRACE_GLEW( glMapBuffer, MapBuffer, __VA_ARGS__ )
+#define glUnmapBuffer( ... ) GLTRACE_GLEW( glUnmapBuffer, UnmapBuffer, __VA_ARGS__ )
+#define glDeleteBuffers( ... ) GLTRACE_GLEW( glDeleteBuffers, DeleteBuffers, __VA_ARGS__ )
+
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <GL/glew.h>
+#include <vector>
+
+/*indexed triangle mesh, generated on the CPU so it can be optimised before GL sees it*/
+class Mesh
+{
+public:
+	struct Vertex
+	{
+		float Position[ 3 ];
+		float Normal[ 3 ];
+		float TexCoord[ 2 ];
+	};
+	struct PackedVertex //16 bytes against Vertex's 32
+	{
+		GLshort Position[ 4 ]; //relative to the mesh bounds, the 4th is padding
+		GLbyte Normal[ 4 ]; //signed normalised, as glNormalPointer has taken since GL 1.1; the 4th is padding
+		GLushort TexCoord[ 2 ]; //half floats
+	};
+	enum Format
+	{
+		FLOAT_FORMAT,
+		PACKED_FORMAT
+	};
+	struct Stats //what Draw() has pulled through the vertex stage since the last Reset
+	{
+		unsigned Draws;
+		unsigned long VertexBytes;
+		unsigned long IndexBytes;
+		void Reset() { Draws = 0, VertexBytes = IndexBytes = 0; }
+	};
+	static Stats FrameStats;
+
+	Mesh();
+
+	//generators, these follow the same parameterisation (and emission order) as the GLU/freeglut calls they replace
+	void AddSphere( float Radius, int Slices, int Stacks ); //gluSphere, textured, GLU_OUTSIDE
+	void AddCylinder( float BaseRadius, float TopRadius, float Height, int Slices, int Stacks ); //gluCylinder, textured
+	void AddSolidSphere( float Radius, int Slices, int Stacks ); //glutSolidSphere
+	void AddDodecahedron(); //glutSolidDodecahedron
+	void AddCube( float Size ); //glutSolidCube
+
+	//welds duplicate vertices, reorders triangles for the post-transform cache and vertices for fetch locality
+	void Optimize();
+	//average cache miss ratio (transformed vertices per triangle) for a FIFO cache of the given size
+	float ACMR( unsigned CacheSize ) const;
+
+	//(re)creates the buffer objects in the given format, falls back to FLOAT_FORMAT if GL can't decode the packed one
+	void Upload( Format VertexFormat );
+	void Draw() const;
+
+	Format GetFormat() const { return m_format; }
+	unsigned VertexCount() const { return (unsigned)m_vertices.size(); }
+	unsigned TriangleCount() const { return (unsigned)m_indices.size() / 3; }
+	unsigned VertexStride() const { return m_format == PACKED_FORMAT ? sizeof( PackedVertex ) : sizeof( Vertex ); }
+	unsigned VertexBytes() const { return VertexCount() * VertexStride(); }
+	unsigned IndexBytes() const { return (unsigned)m_indices.size() * sizeof( GLushort ); }
+
+private:
+	std::vector< Vertex > m_vertices;
+	std::vector< GLushort > m_indices;
+	bool m_textured;
+	Format m_format;
+	GLuint m_vertexbuffer;
+	GLuint m_indexbuffer;
+	float m_center[ 3 ]; //packed positions decode as m_center + Position * m_scale
+	float m_scale[ 3 ];
+
+	unsigned AddVertex( float const * Position, float const * Normal, float s, float t );
+	void AddTriangle( unsigned a, unsigned b, unsigned c );
+	void AddQuadStrip( unsigned First, unsigned Count ); //Count vertices starting at First, as emitted to GL_QUAD_STRIP
+	void AddFan( unsigned First, unsigned Count ); //GL_TRIANGLE_FAN or GL_POLYGON
+	void Weld();
+	void OptimizeVertexCache();
+	void OptimizeVertexFetch();
+	void Pack( std::vector< PackedVertex > & Out );
+};
+
+#endif
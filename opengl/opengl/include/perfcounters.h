@@ -0,0 +1,51 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+/*counts what the CPU does in named regions of the frame: cycles, instructions, cache and branch misses from one
+ perf_event_open group, so they are all counted over the same stretch, read as the main thread moves from one region
+ to the next. Without hardware counters (a VM, a container, a paranoid kernel) it falls back to software events, and
+ without perf_event_open at all (not Linux, or seccomp) to timing the regions; either way it says so once and carries
+ on. Every <frames> frames a line per region goes to stderr with the per-frame averages*/
+class PerfCounters
+{
+public:
+	enum Region
+	{
+		CAMERA_REGION,
+		FISH_REGION,
+		WATERBUG_REGION,
+		PARTICLE_REGION,
+		DRAW_REGION,
+		REGION_COUNT
+	};
+
+	//"-counters <frames>": opens the counters and removes both arguments
+	static void FromCommandLine( int & argc, char ** argv );
+
+	//ends the region being counted, if any, and starts counting Which
+	static void Enter( Region Which )
+	{
+		if( s_enabled )
+			Switch( Which );
+	}
+	//ends the region being counted
+	static void Leave()
+	{
+		if( s_enabled )
+			Switch( REGION_COUNT );
+	}
+	//call once a frame, reports and starts over every <frames> frames
+	static void EndFrame()
+	{
+		if( s_enabled )
+			Frame();
+	}
+
+private:
+	static bool s_enabled;
+
+	static void Switch( int Next );
+	static void Frame();
+};
+
+#endif
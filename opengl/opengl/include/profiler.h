@@ -0,0 +1,65 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*a hierarchical CPU profiler: PROFILE_SCOPE( "name" ) times the rest of the enclosing block to the nanosecond, and the
+ scopes a thread opens inside one another nest in the trace. Each thread records into a ring of its own with no lock
+ taken, so the last RING_SIZE scopes of every thread are kept; Write turns them into Chrome's trace_event JSON, for
+ chrome://tracing or Perfetto. The scopes are only compiled in a build with PROFILE defined, and only record once
+ -profile has been given, so a build without it pays nothing and one with it pays a branch per scope until then*/
+class Profiler
+{
+public:
+	enum { RING_SIZE = 1 << 16 };
+
+	class Scope
+	{
+	public:
+		//the name must outlive the program, a string literal
+		Scope( char const * Name ) : m_name( Name ), m_start( s_enabled ? Now() : 0 ) {}
+		~Scope()
+		{
+			if( m_start )
+				Record( m_name, m_start, Now() );
+		}
+
+	private:
+		char const * m_name;
+		unsigned long long m_start;
+
+		Scope( Scope const & );
+		Scope & operator=( Scope const & );
+	};
+
+	//"-profile <file.json>": starts recording and removes both arguments; works before glutInit, so it can be timed.
+	//Exits if the build has no scopes to record
+	static void FromCommandLine( int & argc, char ** argv );
+	static bool Enabled() { return s_enabled; }
+	static void Enable( bool Enabled ) { s_enabled = Enabled; }
+	//labels the calling thread's lane in the trace, a string literal again
+	static void NameThread( char const * Name );
+	//a thread about to exit hands its ring to the next thread that starts, so threads started per frame do not each
+	//keep one
+	static void EndThread();
+	//writes what the rings hold to the -profile path, returns false if nothing was written; any thread may call it,
+	//the others keep recording meanwhile
+	static bool Write();
+	//how many scopes the calling thread has recorded
+	static unsigned long ThreadScopes();
+	static unsigned long long Now();
+
+private:
+	static bool s_enabled;
+	static char s_path[ 512 ];
+
+	static void Record( char const * Name, unsigned long long Start, unsigned long long End );
+};
+
+#define PROFILE_JOIN2( A, B ) A##B
+#define PROFILE_JOIN( A, B ) PROFILE_JOIN2( A, B )
+#ifdef PROFILE
+#define PROFILE_SCOPE( Name ) Profiler::Scope PROFILE_JOIN( profilescope, __LINE__ )( Name )
+#else
+#define PROFILE_SCOPE( Name )
+#endif
+
+#endif
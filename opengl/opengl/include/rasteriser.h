@@ -0,0 +1,107 @@
+#ifndef RASTERISER_H
+#define RASTERISER_H
+
+#include <GL/glew.h>
+#include <mesh.h>
+#include <vector>
+#include <map>
+
+/*CPU reference for the slice of the fixed-function pipeline the program uses, so its frames can be diffed against the
+ driver's and its cost measured without a GPU: GL_LIGHT0 as a local light with attenuation, GL_COLOR_MATERIAL,
+ GL_NORMALIZE, GL_MODULATE texturing with a GL_LINEAR_MIPMAP_NEAREST/GL_LINEAR filter and GL_REPEAT, GL_LINEAR fog on
+ eye depth and a GL_LESS depth test. Everything else about the state is read back from GL as each draw is mirrored,
+ so it sees the same matrices, light, fog and textures the scene set up. Draws are transformed, lit, clipped and
+ binned into screen tiles as they come in, and Render shades the tiles in parallel*/
+class Rasteriser
+{
+public:
+	enum { TILE_SIZE = 64 };
+
+	struct Stats //of the frame since the last Begin
+	{
+		unsigned Triangles; //as drawn
+		unsigned Binned; //after clipping, culling zero area ones and splitting those cut by the near plane
+		unsigned long Fragments; //that passed the depth test, by the last Render
+		double SetupSeconds; //transform, lighting, clipping, setup and binning, without the GL state reads
+	};
+
+	//GL drawing is mirrored into this one while it is set
+	static Rasteriser * Capture;
+
+	Rasteriser();
+
+	//starts a frame with GL's current viewport, projection and clear colour
+	void Begin();
+	//a draw of GL_TRIANGLES, with the current GL state; with no Indices the vertices are drawn in order
+	void Draw( Mesh::Vertex const * Vertices, unsigned VertexCount, GLushort const * Indices, unsigned IndexCount, bool Textured );
+	//clears and shades every tile on the given number of threads (0 for one per core), returns the seconds it took;
+	//the binned triangles are kept, so a frame can be rendered again
+	double Render( unsigned Threads );
+
+	//RGBA, bottom row first, like glReadPixels
+	unsigned char const * GetColorBuffer() const { return m_color.empty() ? NULL : &m_color[ 0 ]; }
+	int GetWidth() const { return m_width; }
+	int GetHeight() const { return m_height; }
+	Stats const & GetStats() const { return m_stats; }
+
+	static unsigned CoreCount();
+
+private:
+	enum
+	{
+		//what is interpolated across a triangle, the first two linearly and the rest divided by w
+		PLANE_Z, PLANE_Q, PLANE_R, PLANE_G, PLANE_B, PLANE_S, PLANE_T, PLANE_FOG,
+		PLANE_COUNT,
+		VERTEX_ATTRIBUTES = PLANE_COUNT - PLANE_R
+	};
+	struct Texture //the mip levels of a GL texture, read back as GL holds them
+	{
+		struct Level
+		{
+			int Width;
+			int Height;
+			std::vector< unsigned char > Texels; //RGB
+		};
+		std::vector< Level > Levels;
+
+		void Sample( float s, float t, float Lod, float * Rgb ) const;
+	};
+	struct ClipVertex
+	{
+		float Position[ 4 ];
+		float Attributes[ VERTEX_ATTRIBUTES ]; //lit colour, texture coordinates and fog distance
+	};
+	struct Triangle
+	{
+		double Edge[ 3 ][ 3 ]; //A x + B y + C, positive inside
+		int TopLeft; //a bit per edge that owns the pixels exactly on it
+		int MinX, MinY, MaxX, MaxY; //inclusive pixel bounds, within the viewport
+		double Plane[ PLANE_COUNT ][ 3 ]; //the same, for the values at the vertices
+		Texture const * Image; //NULL when untextured
+		bool Fog;
+		float FogEnd, FogScale, FogColor[ 3 ]; //GL_LINEAR fog is ( end - distance ) * scale
+	};
+	struct Worker; //Render's threads
+
+	int m_width;
+	int m_height;
+	int m_tilesx;
+	int m_tilesy;
+	float m_projection[ 16 ];
+	unsigned char m_clear[ 4 ];
+	std::vector< unsigned char > m_color;
+	std::vector< Triangle > m_triangles;
+	std::vector< std::vector< unsigned > > m_bins; //triangles overlapping each tile, in draw order
+	std::vector< ClipVertex > m_transformed; //the current draw's vertices
+	std::map< GLuint, Texture > m_textures; //by GL name, read back the first time each is drawn with
+	Stats m_stats;
+
+	Texture const * FetchTexture( GLuint Name );
+	void DrawTriangle( ClipVertex const & a, ClipVertex const & b, ClipVertex const & c, Triangle const & State );
+	void SetupTriangle( ClipVertex const * const * Vertices, Triangle const & State );
+	unsigned long ShadeTile( unsigned Tile, float * Depth );
+	unsigned long ShadeSpan( Triangle const & Tri, int x0, int x1, int y, float * Depth );
+	static void ShadePixel( Triangle const & Tri, float const * Base, float const * Step, float i, unsigned char * Out );
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <GL/glew.h>
+#include <stdio.h>
+
+/*records every frame the program swaps: each one is read back into the next of a ring of pixel buffer objects, so
+ glReadPixels only queues a copy, and is mapped RING_SIZE frames later when the copy is long done; the mapped frames
+ go to a writer thread, which emits a raw Y4M stream (to a file, or to stdout to pipe into an encoder) or a numbered
+ PPM sequence. When the writer falls QUEUE_SIZE frames behind, frames are dropped rather than stalling the program*/
+class Recorder
+{
+public:
+	enum Format
+	{
+		Y4M_FORMAT,
+		PPM_FORMAT
+	};
+	enum { RING_SIZE = 3, QUEUE_SIZE = 8, FRAME_RATE = 60 };
+
+	struct Stats
+	{
+		unsigned Captured; //frames read back and queued for the writer
+		unsigned Written;
+		unsigned Dropped; //the writer was behind, or the frame was not the size the stream started at
+		double Latency; //summed seconds from glReadPixels to the frame being mapped
+		double MaxLatency;
+		double Stall; //summed seconds spent in glMapBuffer
+	};
+
+	//"-record <path>": a path ending in .y4m, or "-" for stdout, gets a Y4M stream, anything else a PPM sequence, with
+	//the path as a printf pattern for the frame number if it has one (otherwise the number and .ppm are appended);
+	//removes both arguments, NULL if there are none. As stdout can be the stream, every report the program makes on
+	//its own workings (traces, profiles, counters, allocations) goes to stderr
+	static Recorder * FromCommandLine( int & argc, char ** argv );
+
+	Recorder( char const * Path, Format OutputFormat );
+	~Recorder();
+
+	bool IsOpen() const { return m_file || ( m_format == PPM_FORMAT && m_path[ 0 ] ); }
+	//reads back the current read buffer, call it just before swapping
+	void Capture();
+	//reads back the frames still in the ring, waits for the writer and reports; needs the context that captured
+	void Finish();
+	Stats GetStats() const;
+
+private:
+	struct Shared; //the state the writer thread shares, and the thread itself
+
+	Format m_format;
+	char m_path[ 512 ];
+	FILE * m_file; //the Y4M stream
+	int m_width;
+	int m_height;
+	bool m_finished;
+	GLuint m_buffers[ RING_SIZE ]; //0 without pixel buffer objects, frames are then read back synchronously
+	double m_issued[ RING_SIZE ];
+	unsigned m_oldest;
+	unsigned m_pending;
+	Shared * m_shared;
+
+	void Start( int Width, int Height ); //on the first frame
+	void Collect(); //maps the oldest frame in the ring and queues it
+	int Acquire(); //a free frame buffer in the writer's queue, -1 if there is none
+	void Submit( int Buffer, double Latency, double Stall ); //queues it, or counts a drop for -1
+	bool Write( unsigned char const * Pixels, unsigned Number ); //on the writer thread
+};
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+/*16 byte aligned vectors, quaternions and matrices, one SSE or NEON register each, with the math of vecmath.h done
+ in those registers, and kernels that run the hot ones over whole arrays four at a time. SSE is used wherever the
+ compiler targets it (every x64 build, and x86 with /arch:SSE or better), NEON on AArch64, and plain floats
+ otherwise or when SIMDMATH_SCALAR is defined. Unlike vecmath.h, Dot does not normalise, Scale finds the length
+ once, ToMatrix returns its matrix rather than a shared buffer and Rotation is right for vectors of any length.
+ Everything is passed by reference, as MSVC cannot pass aligned types by value on x86. Matrices are column major,
+ as OpenGL has them*/
+
+#if defined( SIMDMATH_SCALAR )
+#elif defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define SIMDMATH_SSE
+#include <xmmintrin.h>
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#define SIMDMATH_NEON
+#include <arm_neon.h>
+#else
+#define SIMDMATH_SCALAR
+#endif
+#include <math.h>
+
+#ifdef _MSC_VER
+#define SIMDMATH_ALIGN __declspec( align( 16 ) )
+#else
+#define SIMDMATH_ALIGN __attribute__(( aligned( 16 ) ))
+#endif
+
+class Simd
+{
+public:
+	static float const PI;
+
+	//the four floats of a register
+#if defined( SIMDMATH_SSE )
+	typedef __m128 Register;
+#elif defined( SIMDMATH_NEON )
+	typedef float32x4_t Register;
+#else
+	struct Register
+	{
+		float v[ 4 ];
+	};
+#endif
+
+	//built from floats in a register, as writing the floats to memory one at a time and loading them back as one
+	//stalls on the stores
+	struct SIMDMATH_ALIGN Vec3
+	{
+		union
+		{
+			struct
+			{
+				float x;
+				float y;
+				float z;
+				float w; //padding, whatever the math left there
+			};
+			Register v;
+		};
+		Vec3() {}
+		Vec3( float x, float y, float z ) : v( Set( x, y, z, 0.f ) ) {}
+		explicit Vec3( Register v ) : v( v ) {}
+		Register Get() const { return v; }
+	};
+	struct SIMDMATH_ALIGN Vec4
+	{
+		union
+		{
+			struct
+			{
+				float x;
+				float y;
+				float z;
+				float w;
+			};
+			Register v;
+		};
+		Vec4() {}
+		Vec4( float x, float y, float z, float w ) : v( Set( x, y, z, w ) ) {}
+		Vec4( Vec3 const & xyz, float w ) : v( Set( xyz.x, xyz.y, xyz.z, w ) ) {}
+		explicit Vec4( Register v ) : v( v ) {}
+		Register Get() const { return v; }
+	};
+	struct SIMDMATH_ALIGN Quat //x, y and z the vector part, w the real part
+	{
+		union
+		{
+			struct
+			{
+				float x;
+				float y;
+				float z;
+				float w;
+			};
+			Register v;
+		};
+		Quat() {}
+		Quat( float x, float y, float z, float w ) : v( Set( x, y, z, w ) ) {}
+		explicit Quat( Register v ) : v( v ) {}
+		Register Get() const { return v; }
+	};
+	struct SIMDMATH_ALIGN Mat4
+	{
+		float m[ 16 ];
+		Register Column( int c ) const { return Load( m + c * 4 ); }
+		static Mat4 Identity()
+		{
+			Mat4 out;
+			for( int e = 0; e < 16; ++e )
+				out.m[ e ] = e % 5 ? 0.f : 1.f;
+			return out;
+		}
+	};
+
+	static float Dot( Vec3 const & a, Vec3 const & b ) { return Sum3( Multiply( a.Get(), b.Get() ) ); }
+	static float Dot( Vec4 const & a, Vec4 const & b ) { return Sum( Multiply( a.Get(), b.Get() ) ); }
+	static Vec3 Cross( Vec3 const & a, Vec3 const & b )
+	{
+		Register const u = a.Get(), v = b.Get();
+		return Vec3( Subtract( Multiply( Shuffle< 1, 2, 0, 3 >( u ), Shuffle< 2, 0, 1, 3 >( v ) ),
+			Multiply( Shuffle< 2, 0, 1, 3 >( u ), Shuffle< 1, 2, 0, 3 >( v ) ) ) );
+	}
+	static float Length( Vec3 const & v ) { return sqrt( Dot( v, v ) ); }
+	static float Length( Vec4 const & v ) { return sqrt( Dot( v, v ) ); }
+	static Vec3 Normalize( Vec3 const & v ) { return Vec3( Divide( v.Get(), Splat( Length( v ) ) ) ); }
+	static Vec4 Normalize( Vec4 const & v ) { return Vec4( Divide( v.Get(), Splat( Length( v ) ) ) ); }
+	//v with the given length, or 0 for a length of 0
+	static Vec4 Scale( Vec4 const & v, float Length )
+	{
+		if( Length == 0.f )
+			return Vec4( 0.f, 0.f, 0.f, 0.f );
+		return Vec4( Multiply( v.Get(), Splat( Length / Simd::Length( v ) ) ) );
+	}
+	//the point transformed and divided by w, 0 where w is
+	static Vec3 TransformCoord( Mat4 const & m, Vec3 const & v )
+	{
+		Register const p = v.Get();
+		Register const out = Add( Add( Multiply( m.Column( 0 ), Shuffle< 0, 0, 0, 0 >( p ) ), Multiply( m.Column( 1 ), Shuffle< 1, 1, 1, 1 >( p ) ) ),
+			Add( Multiply( m.Column( 2 ), Shuffle< 2, 2, 2, 2 >( p ) ), m.Column( 3 ) ) );
+		Register const w = Shuffle< 3, 3, 3, 3 >( out );
+		return First( w ) ? Vec3( Divide( out, w ) ) : Vec3( 0.f, 0.f, 0.f );
+	}
+	//a * b
+	static Mat4 Multiply( Mat4 const & a, Mat4 const & b )
+	{
+		Mat4 out;
+		for( int c = 0; c < 4; ++c )
+		{
+			float const * const column = b.m + c * 4;
+			Store( out.m + c * 4, Add( Add( Multiply( a.Column( 0 ), Splat( column[ 0 ] ) ), Multiply( a.Column( 1 ), Splat( column[ 1 ] ) ) ),
+				Add( Multiply( a.Column( 2 ), Splat( column[ 2 ] ) ), Multiply( a.Column( 3 ), Splat( column[ 3 ] ) ) ) ) );
+		}
+		return out;
+	}
+
+	//a * b, as QuaternionMultiply
+	static Quat Multiply( Quat const & a, Quat const & b )
+	{
+		Register const q = b.Get();
+		Register out = Multiply( Splat( a.w ), q );
+		out = Add( out, Multiply( Multiply( Splat( a.x ), Shuffle< 3, 2, 1, 0 >( q ) ), Set( 1.f, -1.f, 1.f, -1.f ) ) );
+		out = Add( out, Multiply( Multiply( Splat( a.y ), Shuffle< 2, 3, 0, 1 >( q ) ), Set( 1.f, 1.f, -1.f, -1.f ) ) );
+		out = Add( out, Multiply( Multiply( Splat( a.z ), Shuffle< 1, 0, 3, 2 >( q ) ), Set( -1.f, 1.f, 1.f, -1.f ) ) );
+		return Quat( out );
+	}
+	static Quat Conjugate( Quat const & q ) { return Quat( Multiply( q.Get(), Set( -1.f, -1.f, -1.f, 1.f ) ) ); }
+	static Quat Normalize( Quat const & q ) { return Quat( Divide( q.Get(), Splat( sqrt( Sum( Multiply( q.Get(), q.Get() ) ) ) ) ) ); }
+	//q v q', for a unit q, without the two quaternion products
+	static Vec3 Rotate( Quat const & q, Vec3 const & v )
+	{
+		Vec3 const axis( q.x, q.y, q.z );
+		Vec3 const t( Multiply( Cross( axis, v ).Get(), Splat( 2.f ) ) );
+		return Vec3( Add( Add( v.Get(), Multiply( Splat( q.w ), t.Get() ) ), Cross( axis, t ).Get() ) );
+	}
+	//towards b the short way round, as QuaternionLerp; not normalised
+	static Quat Lerp( Quat const & a, Quat const & b, float t )
+	{
+		float const towards = Sum( Multiply( a.Get(), b.Get() ) ) < 0.f ? -t : t;
+		return Quat( Add( Multiply( a.Get(), Splat( 1.f - t ) ), Multiply( b.Get(), Splat( towards ) ) ) );
+	}
+	//as QuaternionSlerp, which goes the long way round when a and b are more than 90 degrees apart
+	static Quat Slerp( Quat const & a, Quat const & b, float t )
+	{
+		float dot = Sum( Multiply( a.Get(), b.Get() ) );
+		dot = dot < -1.f ? -1.f : dot > 1.f ? 1.f : dot;
+		float omega = acos( dot );
+		if( fabs( omega ) < 1e-10f )
+			omega = 1e-10f;
+		float const som = sin( omega );
+		return Quat( Add( Multiply( a.Get(), Splat( sin( ( 1.f - t ) * omega ) / som ) ), Multiply( b.Get(), Splat( sin( t * omega ) / som ) ) ) );
+	}
+	//Theta radians around the unit Axis
+	static Quat AxisAngle( Vec3 const & Axis, float Theta )
+	{
+		float const s = sin( Theta / 2.f );
+		return Quat( Axis.x * s, Axis.y * s, Axis.z * s, cos( Theta / 2.f ) );
+	}
+	//the shortest rotation taking the direction of u onto that of v
+	static Quat Rotation( Vec3 const & u, Vec3 const & v )
+	{
+		float const lengths = sqrt( Dot( u, u ) * Dot( v, v ) );
+		float const real = lengths + Dot( u, v );
+		if( real < 1e-6f * lengths )
+		{
+			//opposite, so half a turn around any axis at right angles to them
+			Vec3 const axis = fabs( u.x ) > fabs( u.z ) ? Vec3( -u.y, u.x, 0.f ) : Vec3( 0.f, -u.z, u.y );
+			return Normalize( Quat( axis.x, axis.y, axis.z, 0.f ) );
+		}
+		Vec3 const axis = Cross( u, v );
+		return Normalize( Quat( axis.x, axis.y, axis.z, real ) );
+	}
+	//the rotation matrix of a unit quaternion, as QuaternionToMatrix makes it
+	static Mat4 ToMatrix( Quat const & q )
+	{
+		float const xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float const xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float const xw = q.x * q.w, yw = q.y * q.w, zw = q.z * q.w;
+		Mat4 out;
+		Store( out.m + 0, Set( 1.f - 2.f * ( yy + zz ), 2.f * ( xy + zw ), 2.f * ( xz - yw ), 0.f ) );
+		Store( out.m + 4, Set( 2.f * ( xy - zw ), 1.f - 2.f * ( xx + zz ), 2.f * ( yz + xw ), 0.f ) );
+		Store( out.m + 8, Set( 2.f * ( xz + yw ), 2.f * ( yz - xw ), 1.f - 2.f * ( xx + yy ), 0.f ) );
+		Store( out.m + 12, Set( 0.f, 0.f, 0.f, 1.f ) );
+		return out;
+	}
+
+	//the batch kernels; Out may be In, or A or B
+	static void TransformCoords( Mat4 const & m, Vec3 const * In, Vec3 * Out, int Count );
+	static void Normalize( Vec3 const * In, Vec3 * Out, int Count );
+	static void Multiply( Quat const * A, Quat const * B, Quat * Out, int Count );
+
+private:
+#if defined( SIMDMATH_SSE )
+	static Register Load( float const * Aligned ) { return _mm_load_ps( Aligned ); }
+	static void Store( float * Aligned, Register v ) { _mm_store_ps( Aligned, v ); }
+	static Register Set( float x, float y, float z, float w ) { return _mm_setr_ps( x, y, z, w ); }
+	static Register Splat( float v ) { return _mm_set1_ps( v ); }
+	static Register Add( Register a, Register b ) { return _mm_add_ps( a, b ); }
+	static Register Subtract( Register a, Register b ) { return _mm_sub_ps( a, b ); }
+	static Register Multiply( Register a, Register b ) { return _mm_mul_ps( a, b ); }
+	static Register Divide( Register a, Register b ) { return _mm_div_ps( a, b ); }
+	static Register SquareRoot( Register v ) { return _mm_sqrt_ps( v ); }
+	template< int X, int Y, int Z, int W > static Register Shuffle( Register v ) { return _mm_shuffle_ps( v, v, _MM_SHUFFLE( W, Z, Y, X ) ); }
+	static float First( Register v ) { return _mm_cvtss_f32( v ); }
+	static float Sum( Register v )
+	{
+		Register const pairs = _mm_add_ps( v, Shuffle< 1, 0, 3, 2 >( v ) );
+		return _mm_cvtss_f32( _mm_add_ss( pairs, Shuffle< 2, 3, 0, 1 >( pairs ) ) );
+	}
+	static float Sum3( Register v ) { return _mm_cvtss_f32( _mm_add_ss( _mm_add_ss( v, Shuffle< 1, 1, 1, 1 >( v ) ), Shuffle< 2, 2, 2, 2 >( v ) ) ); }
+	static void Transpose( Register & a, Register & b, Register & c, Register & d ) { _MM_TRANSPOSE4_PS( a, b, c, d ); }
+#elif defined( SIMDMATH_NEON )
+	static Register Load( float const * Aligned ) { return vld1q_f32( Aligned ); }
+	static void Store( float * Aligned, Register v ) { vst1q_f32( Aligned, v ); }
+	static Register Set( float x, float y, float z, float w )
+	{
+		float const v[ 4 ] = { x, y, z, w };
+		return vld1q_f32( v );
+	}
+	static Register Splat( float v ) { return vdupq_n_f32( v ); }
+	static Register Add( Register a, Register b ) { return vaddq_f32( a, b ); }
+	static Register Subtract( Register a, Register b ) { return vsubq_f32( a, b ); }
+	static Register Multiply( Register a, Register b ) { return vmulq_f32( a, b ); }
+	static Register Divide( Register a, Register b ) { return vdivq_f32( a, b ); }
+	static Register SquareRoot( Register v ) { return vsqrtq_f32( v ); }
+	template< int X, int Y, int Z, int W > static Register Shuffle( Register v )
+	{
+		//a byte table lookup, the one shuffle NEON has for any order
+		uint8_t const bytes[ 16 ] = { X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3, Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+			Z * 4, Z * 4 + 1, Z * 4 + 2, Z * 4 + 3, W * 4, W * 4 + 1, W * 4 + 2, W * 4 + 3 };
+		return vreinterpretq_f32_u8( vqtbl1q_u8( vreinterpretq_u8_f32( v ), vld1q_u8( bytes ) ) );
+	}
+	static float First( Register v ) { return vgetq_lane_f32( v, 0 ); }
+	static float Sum( Register v ) { return vaddvq_f32( v ); }
+	static float Sum3( Register v ) { return vgetq_lane_f32( v, 0 ) + vgetq_lane_f32( v, 1 ) + vgetq_lane_f32( v, 2 ); }
+	static void Transpose( Register & a, Register & b, Register & c, Register & d )
+	{
+		float32x4_t const ab0 = vtrn1q_f32( a, b ), ab1 = vtrn2q_f32( a, b ), cd0 = vtrn1q_f32( c, d ), cd1 = vtrn2q_f32( c, d );
+		a = vreinterpretq_f32_f64( vtrn1q_f64( vreinterpretq_f64_f32( ab0 ), vreinterpretq_f64_f32( cd0 ) ) );
+		b = vreinterpretq_f32_f64( vtrn1q_f64( vreinterpretq_f64_f32( ab1 ), vreinterpretq_f64_f32( cd1 ) ) );
+		c = vreinterpretq_f32_f64( vtrn2q_f64( vreinterpretq_f64_f32( ab0 ), vreinterpretq_f64_f32( cd0 ) ) );
+		d = vreinterpretq_f32_f64( vtrn2q_f64( vreinterpretq_f64_f32( ab1 ), vreinterpretq_f64_f32( cd1 ) ) );
+	}
+#else
+	static Register Load( float const * Aligned )
+	{
+		Register out = { { Aligned[ 0 ], Aligned[ 1 ], Aligned[ 2 ], Aligned[ 3 ] } };
+		return out;
+	}
+	static void Store( float * Aligned, Register v )
+	{
+		for( int l = 0; l < 4; ++l )
+			Aligned[ l ] = v.v[ l ];
+	}
+	static Register Set( float x, float y, float z, float w )
+	{
+		Register out = { { x, y, z, w } };
+		return out;
+	}
+	static Register Splat( float v ) { return Set( v, v, v, v ); }
+	static Register Add( Register a, Register b ) { return Set( a.v[ 0 ] + b.v[ 0 ], a.v[ 1 ] + b.v[ 1 ], a.v[ 2 ] + b.v[ 2 ], a.v[ 3 ] + b.v[ 3 ] ); }
+	static Register Subtract( Register a, Register b ) { return Set( a.v[ 0 ] - b.v[ 0 ], a.v[ 1 ] - b.v[ 1 ], a.v[ 2 ] - b.v[ 2 ], a.v[ 3 ] - b.v[ 3 ] ); }
+	static Register Multiply( Register a, Register b ) { return Set( a.v[ 0 ] * b.v[ 0 ], a.v[ 1 ] * b.v[ 1 ], a.v[ 2 ] * b.v[ 2 ], a.v[ 3 ] * b.v[ 3 ] ); }
+	static Register Divide( Register a, Register b ) { return Set( a.v[ 0 ] / b.v[ 0 ], a.v[ 1 ] / b.v[ 1 ], a.v[ 2 ] / b.v[ 2 ], a.v[ 3 ] / b.v[ 3 ] ); }
+	static Register SquareRoot( Register v ) { return Set( sqrt( v.v[ 0 ] ), sqrt( v.v[ 1 ] ), sqrt( v.v[ 2 ] ), sqrt( v.v[ 3 ] ) ); }
+	template< int X, int Y, int Z, int W > static Register Shuffle( Register v ) { return Set( v.v[ X ], v.v[ Y ], v.v[ Z ], v.v[ W ] ); }
+	static float First( Register v ) { return v.v[ 0 ]; }
+	static float Sum( Register v ) { return ( v.v[ 0 ] + v.v[ 1 ] ) + ( v.v[ 2 ] + v.v[ 3 ] ); }
+	static float Sum3( Register v ) { return v.v[ 0 ] + v.v[ 1 ] + v.v[ 2 ]; }
+	static void Transpose( Register & a, Register & b, Register & c, Register & d )
+	{
+		Register const in[ 4 ] = { a, b, c, d };
+		Register * const out[ 4 ] = { &a, &b, &c, &d };
+		for( int r = 0; r < 4; ++r )
+		{
+			for( int l = 0; l < 4; ++l )
+				out[ r ]->v[ l ] = in[ l ].v[ r ];
+		}
+	}
+#endif
+};
+
+#endif
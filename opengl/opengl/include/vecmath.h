@@ -0,0 +1,221 @@
+#ifndef VECMATH_H
+#define VECMATH_H
+
+#include <math.h>
+
+/*the vectors and the quaternion and matrix math the program moves things with, out of Program so the math
+ benchmark times the very functions the scene uses. Matrices are 16 floats, column major as OpenGL has them*/
+struct Vec3 //serve as position or color
+{
+	union
+	{
+		struct
+		{
+			float x;
+			float y;
+			float z;
+		};
+		struct
+		{
+			float r;
+			float g;
+			float b;
+		};
+	};
+	Vec3() {}
+	Vec3( float x, float y, float z ) : x( x ), y( y ), z( z ) {}
+};
+struct Vec4 //serve as homogenous position or color, with alpha component
+{
+	union
+	{
+		struct
+		{
+			float x;
+			float y;
+			float z;
+			float w;
+		};
+		struct
+		{
+			float r;
+			float g;
+			float b;
+			float a;
+		};
+	};
+	Vec4(){}
+	Vec4( float x, float y, float z, float w ) : 
+		x( x ), y( y ), z( z ), w( w ) {}
+		Vec4( Vec3 v, float w ) : x( v.x ), y( v.y ), z( v.z ), w( w ) {}
+};
+inline Vec4 QuaternionMultiply( Vec4 q1, Vec4 q2 )
+{
+	return Vec4( q1.x * q2.w + q1.y * q2.z - q1.z * q2.y + q1.w * q2.x,
+		-q1.x * q2.z + q1.y * q2.w + q1.z * q2.x + q1.w * q2.y,
+		q1.x * q2.y - q1.y * q2.x + q1.z * q2.w + q1.w * q2.z,
+		-q1.x * q2.x - q1.y * q2.y - q1.z * q2.z + q1.w * q2.w );
+}
+inline float * QuaternionToMatrix( Vec4 quat )
+{
+	//get a rotation matrix from our quaternion
+	static float m[ 16 ];
+	m[ 0*4 + 0 ] = m[ 1*4 + 1 ] = m[ 2*4 + 2 ] = m[ 3*4 + 3 ] = 1.f;
+	m[ 0*4 + 0 ] = 1.0f - 2.0f * (quat.y * quat.y + quat.z * quat.z);
+	m[ 0*4 + 1 ] = 2.0f * (quat.x *quat.y + quat.z * quat.w);
+	m[ 0*4 + 2 ] = 2.0f * (quat.x * quat.z - quat.y * quat.w);
+	m[ 1*4 + 0 ] = 2.0f * (quat.x * quat.y - quat.z * quat.w);
+	m[ 1*4 + 1 ] = 1.0f - 2.0f * (quat.x * quat.x + quat.z * quat.z);
+	m[ 1*4 + 2 ] = 2.0f * (quat.y *quat.z + quat.x *quat.w);
+	m[ 2*4 + 0 ] = 2.0f * (quat.x * quat.z + quat.y * quat.w);
+	m[ 2*4 + 1 ] = 2.0f * (quat.y *quat.z - quat.x *quat.w);
+	m[ 2*4 + 2 ] = 1.0f - 2.0f * (quat.x * quat.x + quat.y * quat.y);
+	return m;
+}
+inline Vec4 QuaternionLerp( Vec4 quat1, Vec4 quat2, float t )
+{
+	//Linear intERPolation
+	float dot, epsilon;
+	Vec4 out;
+	epsilon = 1.0f;
+	dot = quat1.x * quat2.x + quat1.y * quat2.y + quat1.z * quat2.z + quat1.w * quat2.w;
+	if ( dot < 0.0f ) epsilon = -1.0f;
+	out.x = ( 1.0f - t ) * quat1.x + epsilon * t * quat2.x;
+	out.y = ( 1.0f - t ) * quat1.y + epsilon * t * quat2.y;
+	out.z = ( 1.0f - t ) * quat1.z + epsilon * t * quat2.z;
+	out.w = ( 1.0f - t ) * quat1.w + epsilon * t * quat2.w;
+	return out;
+}
+inline Vec4 QuaternionSlerp( Vec4 q0, Vec4 q1, float t )
+{
+	//Spherical Linear intERPolation
+	float dot = q0.x*q1.x + q0.y*q1.y + q0.z*q1.z + q0.w*q1.w;
+
+	if( dot < -1.f ) dot = -1.f;
+	else if( dot > 1.f ) dot = 1.f;
+
+	float omega = acos( dot );
+
+	if( fabs( omega ) < 1e-10f )
+	  omega = 1e-10f;
+
+	float som = sin(omega);
+	float st0 = sin((1-t) * omega) / som;
+	float st1 = sin(t * omega) / som;
+    
+	return Vec4( q0.x*st0 + q1.x*st1,
+		q0.y*st0 + q1.y*st1,
+		q0.z*st0 + q1.z*st1,
+		q0.w*st0 + q1.w*st1);
+  }
+inline Vec4 QuaternionConjugate( Vec4 qu )
+{
+	return Vec4( -qu.x, -qu.y, -qu.z, qu.w );
+}
+inline Vec3 TransformCoord( float const * pm, Vec3 vec ) //transform a single point
+{
+	Vec3 out;
+	float norm;
+
+	//norm is our 'w' component in the vector <x,y,z,w>, it's not really for normalizing
+	norm = pm[ 0*4 + 3 ] * vec.x + pm[ 1*4 + 3 ] * vec.y + pm[ 2*4 + 3 ] * vec.z + pm[ 3*4 + 3 ];
+
+	if ( norm )
+	{
+		//divide by 'w' component for homogenous space
+		out.x = ( pm[ 0*4 + 0 ] * vec.x + pm[ 1*4 + 0 ] * vec.y + pm[ 2*4 + 0 ] * vec.z + pm[ 3*4 + 0 ] ) / norm;
+		out.y = ( pm[ 0*4 + 1 ] * vec.x + pm[ 1*4 + 1 ] * vec.y + pm[ 2*4 + 1 ] * vec.z + pm[ 3*4 + 1 ] ) / norm;
+		out.z = ( pm[ 0*4 + 2 ] * vec.x + pm[ 1*4 + 2 ] * vec.y + pm[ 2*4 + 2 ] * vec.z + pm[ 3*4 + 2 ] ) / norm;
+	}
+	else
+	{
+		out.x = 0.0f;
+		out.y = 0.0f;
+		out.z = 0.0f;
+	}
+	return out;
+}
+inline Vec3 CrossProduct( Vec3 vec1, Vec3 vec2 )
+{
+	Vec3 vec_cross;
+	vec_cross.x = vec1.y * vec2.z - vec2.y * vec1.z;
+	vec_cross.y = vec1.z * vec2.x - vec2.z * vec1.x;
+	vec_cross.z = vec1.x * vec2.y - vec2.x * vec1.y;
+	return vec_cross;
+}
+inline Vec3 Normalize( Vec3 vec )
+{
+	float magnitude = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z );
+	vec.x /= magnitude;
+	vec.y /= magnitude;
+	vec.z /= magnitude;
+	return vec;
+}
+inline Vec4 Normalize( Vec4 vec )
+{
+	float magnitude = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
+	vec.x /= magnitude;
+	vec.y /= magnitude;
+	vec.z /= magnitude;
+	vec.w /= magnitude;
+	return vec;
+}
+inline Vec4 Scale( Vec4 vec, float scalefac )
+{
+	if( scalefac == 0.f )
+		return Vec4( 0.f, 0.f, 0.f, 0.f );
+	float mag = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
+	vec.x *= scalefac / mag;
+	vec.y *= scalefac / mag;
+	vec.z *= scalefac / mag;
+	vec.w *= scalefac / mag;
+	return vec;
+}
+inline float GetScale( Vec4 vec )
+{
+	return sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
+}
+inline float DotProduct( Vec3 vec1, Vec3 vec2 )
+{
+	//probably the easiest
+	vec1 = Normalize( vec1 );
+	vec2 = Normalize( vec2 );
+	return vec1.x * vec2.x + vec1.y * vec2.y + vec1.z * vec2.z;
+}
+inline Vec4 QuaternionAxisAngle( Vec3 Axis, float Theta )
+{
+	return Vec4( Axis.x * sin( Theta / 2.f ),
+		Axis.y * sin( Theta / 2.f ),
+		Axis.z * sin( Theta / 2.f ),
+		cos( Theta / 2.f ) );
+}
+inline float ToRadians( float degrees )
+{
+	return degrees * 2.f * acos( 0.f ) /180.f;
+}
+inline Vec3 ToVec3( Vec4 vec )
+{
+	return Vec3( vec.x, vec.y, vec.z );
+}
+inline Vec4 CalculateRotation( Vec3 u, Vec3 v )
+{
+	float norm_u_norm_v = sqrt( DotProduct( u, u ) * DotProduct( v, v ) );
+	float real_part = norm_u_norm_v + DotProduct( u, v );
+	Vec3 w;
+
+	if ( real_part < 1.e-6f * norm_u_norm_v )
+	{
+		/*If u and v are exactly opposite then rotate 180 degrees
+		 around an arbitrary orthogonal axis*/
+		real_part = 0.0f;
+		w = abs( u.x ) > abs( u.z ) ? Vec3( -u.y, u.x, 0.f )
+								: Vec3( 0.f, -u.z, u.y );
+	}
+	else
+		w = CrossProduct( u, v );
+
+	return Normalize( Vec4( w, real_part ) );
+}
+
+
+#endif
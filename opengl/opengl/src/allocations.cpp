@@ -0,0 +1,176 @@
+#include <allocations.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#ifdef _WIN32
+#define ALLOCATIONS_THREAD_LOCAL __declspec( thread )
+#else
+#define ALLOCATIONS_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+	enum Mode
+	{
+		OFF_MODE,
+		REPORT_MODE,
+		ASSERT_MODE
+	};
+
+	struct RegionCounts
+	{
+		char const * Name;
+		unsigned long Entries;
+		Allocations::Counts Allocated;
+	};
+
+	ALLOCATIONS_THREAD_LOCAL Allocations::Counts ThreadCounts = { 0, 0 };
+	ALLOCATIONS_THREAD_LOCAL bool InFrame = false; //only ever set on the main thread
+
+	Mode CurrentMode = OFF_MODE;
+	unsigned Interval = 0;
+	unsigned Frames = 0; //begun so far
+	Allocations::Counts FrameStart;
+	//since the last report
+	unsigned ReportFrames = 0;
+	Allocations::Counts Summed = { 0, 0 };
+	unsigned long Worst = 0;
+	RegionCounts Regions[ Allocations::MAX_REGIONS ];
+	int RegionCount = 0;
+}
+
+void * operator new( size_t Bytes )
+{
+	Allocations::Allocated( Bytes );
+	void * const memory = malloc( Bytes ? Bytes : 1 );
+	if( !memory )
+		throw std::bad_alloc();
+	return memory;
+}
+void * operator new[]( size_t Bytes )
+{
+	return operator new( Bytes );
+}
+void * operator new( size_t Bytes, std::nothrow_t const & ) throw()
+{
+	Allocations::Allocated( Bytes );
+	return malloc( Bytes ? Bytes : 1 );
+}
+void * operator new[]( size_t Bytes, std::nothrow_t const & Tag ) throw()
+{
+	return operator new( Bytes, Tag );
+}
+void operator delete( void * Memory ) throw()
+{
+	free( Memory );
+}
+void operator delete[]( void * Memory ) throw()
+{
+	free( Memory );
+}
+void operator delete( void * Memory, std::nothrow_t const & ) throw()
+{
+	free( Memory );
+}
+void operator delete[]( void * Memory, std::nothrow_t const & ) throw()
+{
+	free( Memory );
+}
+
+Allocations::Region::Region( char const * Name ) : m_name( Name ), m_start( ThreadCounts )
+{
+}
+
+Allocations::Region::~Region()
+{
+	int r = 0;
+	while( r < RegionCount && Regions[ r ].Name != m_name )
+		++r;
+	if( r == RegionCount )
+	{
+		if( RegionCount == MAX_REGIONS )
+			return;
+		memset( &Regions[ RegionCount ], 0, sizeof( Regions[ 0 ] ) );
+		Regions[ RegionCount++ ].Name = m_name;
+	}
+	++Regions[ r ].Entries;
+	Regions[ r ].Allocated.Allocations += ThreadCounts.Allocations - m_start.Allocations;
+	Regions[ r ].Allocated.Bytes += ThreadCounts.Bytes - m_start.Bytes;
+}
+
+void Allocations::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-allocations" ) )
+			continue;
+
+		int const frames = i + 2 < argc ? atoi( argv[ i + 2 ] ) : 0;
+		if( frames <= 0 || ( strcmp( argv[ i + 1 ], "report" ) && strcmp( argv[ i + 1 ], "assert" ) ) )
+		{
+			printf( "-allocations needs report <frames> (what each frame and region allocates, every <frames> frames) or\n"
+				"assert <frames> (abort on any allocation in a frame after the first <frames>)\n" );
+			exit( 1 );
+		}
+		CurrentMode = strcmp( argv[ i + 1 ], "assert" ) ? REPORT_MODE : ASSERT_MODE;
+		Interval = (unsigned)frames;
+		for( int j = i + 3; j <= argc; ++j )
+			argv[ j - 3 ] = argv[ j ];
+		argc -= 3;
+		return;
+	}
+}
+
+Allocations::Counts Allocations::Thread()
+{
+	return ThreadCounts;
+}
+
+void Allocations::BeginFrame()
+{
+	++Frames;
+	FrameStart = ThreadCounts;
+	InFrame = true;
+}
+
+void Allocations::EndFrame()
+{
+	InFrame = false;
+	if( CurrentMode != REPORT_MODE )
+		return;
+
+	unsigned long const allocations = ThreadCounts.Allocations - FrameStart.Allocations;
+	Summed.Allocations += allocations;
+	Summed.Bytes += ThreadCounts.Bytes - FrameStart.Bytes;
+	if( allocations > Worst )
+		Worst = allocations;
+	if( ++ReportFrames < Interval )
+		return;
+
+	double const frames = ReportFrames;
+	fprintf( stderr, "allocations frames=%u per_frame=%.2f bytes_per_frame=%.1f worst_frame=%lu\n", ReportFrames,
+		Summed.Allocations / frames, Summed.Bytes / frames, Worst );
+	for( int r = 0; r < RegionCount; ++r )
+	{
+		fprintf( stderr, "allocations region=%s entries=%lu allocations=%lu bytes=%llu\n", Regions[ r ].Name, Regions[ r ].Entries,
+			Regions[ r ].Allocated.Allocations, Regions[ r ].Allocated.Bytes );
+	}
+	ReportFrames = 0;
+	Summed.Allocations = 0;
+	Summed.Bytes = 0;
+	Worst = 0;
+	RegionCount = 0;
+}
+
+void Allocations::Allocated( unsigned long long Bytes )
+{
+	++ThreadCounts.Allocations;
+	ThreadCounts.Bytes += Bytes;
+	if( InFrame && CurrentMode == ASSERT_MODE && Frames > Interval )
+	{
+		InFrame = false; //fprintf could come back here
+		fprintf( stderr, "allocations: %llu bytes allocated in frame %u, past the %u warmup frames\n", Bytes, Frames, Interval );
+		abort();
+	}
+}
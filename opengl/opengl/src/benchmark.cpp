@@ -0,0 +1,63 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+Benchmark * Benchmark::s_first = NULL;
+void (*Benchmark::s_scene)() = NULL;
+
+Benchmark::Benchmark( char const * Name, char const * Description ) : m_name( Name ), m_description( Description ), m_next( s_first )
+{
+	s_first = this;
+}
+
+Benchmark * Benchmark::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-benchmark" ) )
+			continue;
+
+		char const * name = i + 1 < argc ? argv[ i + 1 ] : "";
+		Benchmark * found = s_first;
+		while( found && strcmp( found->m_name, name ) )
+			found = found->m_next;
+		if( !found )
+		{
+			printf( "unknown benchmark \"%s\", available:\n", name );
+			for( Benchmark * b = s_first; b; b = b->m_next )
+				printf( "  %-12s %s\n", b->m_name, b->m_description );
+			exit( 1 );
+		}
+
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return found;
+	}
+	return NULL;
+}
+
+double Benchmark::Now()
+{
+	return glutGetElapsedTimeNs() * 1e-9;
+}
+
+void Benchmark::SetScene( void (*Draw)() )
+{
+	s_scene = Draw;
+}
+
+void Benchmark::DrawScene()
+{
+	if( s_scene )
+		s_scene();
+}
+
+void Benchmark::Report( char const * Case, char const * Metric, double Value, char const * Unit ) const
+{
+	printf( "benchmark=%s case=%s %s=%.6g %s\n", m_name, Case, Metric, Value, Unit );
+	fflush( stdout );
+}
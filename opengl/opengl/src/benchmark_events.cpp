@@ -0,0 +1,96 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+
+/*injects bursts of synthetic input through the window system (pointer warps, which come back as motion events, and
+ window resizes, which come back as configure and expose events) and compares the events the window system sent
+ against those that reached the program, with GLUT_COALESCE_EVENTS on and then off; runs fine under Xvfb*/
+class EventsBenchmark : public Benchmark
+{
+	enum { FRAMES = 120, WARPS = 64, RESIZE_EVERY = 4 };
+
+	int m_coalesce; //1 for the first pass, 0 for the second
+	int m_frame;
+	int m_width;
+	int m_height;
+	double m_elapsed;
+	static int s_callbacks;
+
+	static void MotionFunc( int, int )
+	{
+		++s_callbacks;
+	}
+	void Begin()
+	{
+		static GLenum const counters[] = { GLUT_MOTION_EVENTS_RAW, GLUT_MOTION_EVENTS_DELIVERED, GLUT_CONFIGURE_EVENTS_RAW,
+			GLUT_CONFIGURE_EVENTS_DELIVERED, GLUT_EXPOSE_EVENTS_RAW, GLUT_EXPOSE_EVENTS_DELIVERED };
+		for( unsigned u = 0; u < sizeof( counters ) / sizeof( *counters ); ++u )
+			glutSetOption( counters[ u ], 0 );
+		glutSetOption( GLUT_COALESCE_EVENTS, m_coalesce );
+		s_callbacks = 0;
+		m_frame = 0;
+		m_elapsed = 0.0;
+	}
+	void End()
+	{
+		char const * const mode = m_coalesce ? "coalesced" : "uncoalesced";
+		char name[ 64 ];
+		static char const * const kinds[] = { "motion", "configure", "expose" };
+		static GLenum const raw[] = { GLUT_MOTION_EVENTS_RAW, GLUT_CONFIGURE_EVENTS_RAW, GLUT_EXPOSE_EVENTS_RAW };
+		static GLenum const delivered[] = { GLUT_MOTION_EVENTS_DELIVERED, GLUT_CONFIGURE_EVENTS_DELIVERED, GLUT_EXPOSE_EVENTS_DELIVERED };
+		for( int u = 0; u < 3; ++u )
+		{
+			sprintf( name, "%s_%s", mode, kinds[ u ] );
+			Report( name, "raw", glutGet( raw[ u ] ), "events" );
+			Report( name, "delivered", glutGet( delivered[ u ] ), "events" );
+		}
+		Report( mode, "motion_callbacks", s_callbacks, "calls" );
+		Report( mode, "inject_frame_ms", m_elapsed * 1000.0 / FRAMES, "ms" );
+	}
+
+public:
+	EventsBenchmark() : Benchmark( "events", "synthetic motion/resize bursts, raw against delivered events with and without coalescing" ),
+		m_coalesce( 1 ), m_frame( 0 ), m_width( 0 ), m_height( 0 ), m_elapsed( 0.0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d frames per pass, %d pointer warps per frame, a resize every %d frames\n", FRAMES, WARPS, RESIZE_EVERY );
+		m_width = glutGet( GLUT_WINDOW_WIDTH );
+		m_height = glutGet( GLUT_WINDOW_HEIGHT );
+		glutPassiveMotionFunc( &MotionFunc );
+		glutMotionFunc( &MotionFunc );
+		Begin();
+	}
+	bool Frame()
+	{
+		//everything injected here is read back on the next pass of the main loop, as one burst
+		double const start = Now();
+		for( int u = 0; u < WARPS; ++u )
+			glutWarpPointer( 1 + u * ( m_width - 2 ) / WARPS, m_height / 2 );
+		if( m_frame % RESIZE_EVERY == 0 )
+			glutReshapeWindow( m_width - ( m_frame / RESIZE_EVERY % 2 ) * 16, m_height );
+		m_elapsed += Now() - start;
+
+		if( ++m_frame < FRAMES )
+			return true;
+
+		End();
+		if( m_coalesce )
+		{
+			m_coalesce = 0;
+			Begin();
+			return true;
+		}
+
+		glutSetOption( GLUT_COALESCE_EVENTS, GL_TRUE );
+		glutReshapeWindow( m_width, m_height );
+		glutPassiveMotionFunc( NULL );
+		glutMotionFunc( NULL );
+		return false;
+	}
+};
+
+int EventsBenchmark::s_callbacks = 0;
+static EventsBenchmark events;
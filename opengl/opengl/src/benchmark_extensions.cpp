@@ -0,0 +1,108 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*extension lookup against a synthetic 20 KB extension string, made of the context's own extensions repeated:
+ glewIsSupported parses it in one pass, looking each name up in GLEW's sorted table, against the search
+ glewContextInit used to do, walking the whole string once for every extension it knows, half of which are absent*/
+class ExtensionsBenchmark : public Benchmark
+{
+	enum { STRING_BYTES = 20 * 1024, REPEATS = 20 };
+
+	//what _glewSearchExtension does
+	static bool LinearSearch( char const * Name, char const * Start, char const * End )
+	{
+		size_t const len = strlen( Name );
+		for( char const * p = Start; p < End; )
+		{
+			char const * space = strchr( p, ' ' );
+			size_t const n = space ? space - p : strlen( p );
+			if( n == len && !memcmp( p, Name, n ) )
+				return true;
+			p += n + 1;
+		}
+		return false;
+	}
+
+public:
+	ExtensionsBenchmark() : Benchmark( "extensions", "GLEW extension lookup, sorted table against a linear search of a 20 KB string" )
+	{
+	}
+	void Setup()
+	{
+		double start = Now();
+		for( int u = 0; u < REPEATS; ++u )
+			glewInit();
+		Report( "init", "glewinit_ms", ( Now() - start ) * 1000.0 / REPEATS, "ms" );
+
+		std::vector< std::string > names;
+		GLint count = 0;
+		glGetIntegerv( GL_NUM_EXTENSIONS, &count );
+		for( GLint u = 0; u < count && glGetStringi; ++u )
+			names.push_back( (char const *)glGetStringi( GL_EXTENSIONS, u ) );
+		if( names.empty() )
+		{
+			char const * s = (char const *)glGetString( GL_EXTENSIONS );
+			for( char const * p = s; p && *p; )
+			{
+				size_t const n = strcspn( p, " " );
+				if( n )
+					names.push_back( std::string( p, n ) );
+				p += n + ( p[ n ] == ' ' );
+			}
+		}
+		//only those GLEW knows about, anything else fails glewIsSupported
+		std::vector< std::string > known;
+		for( size_t u = 0; u < names.size(); ++u )
+			if( glewIsSupported( names[ u ].c_str() ) )
+				known.push_back( names[ u ] );
+		names.swap( known );
+		if( names.empty() )
+		{
+			printf( "the context reports no extensions GLEW knows\n" );
+			return;
+		}
+
+		std::string synthetic;
+		for( size_t u = 0; synthetic.size() < STRING_BYTES; ++u )
+			synthetic += names[ u % names.size() ] + ' ';
+		synthetic.erase( synthetic.size() - 1 );
+		printf( "%d extensions, %u byte string, %d repeats\n", (int)names.size(), (unsigned)synthetic.size(), REPEATS );
+
+		//everything in the string is supported, so glewIsSupported has to get to the end of it
+		int supported = 0;
+		start = Now();
+		for( int u = 0; u < REPEATS; ++u )
+			supported += glewIsSupported( synthetic.c_str() );
+		double const table = ( Now() - start ) * 1000.0 / REPEATS;
+		if( supported != REPEATS )
+			printf( "glewIsSupported rejected the context's own extensions\n" );
+
+		std::vector< std::string > queries( names );
+		for( size_t u = 0; u < names.size(); ++u )
+			queries.push_back( names[ u ] + "_absent" );
+		char const * const end = synthetic.c_str() + synthetic.size();
+		int found = 0;
+		start = Now();
+		for( int u = 0; u < REPEATS; ++u )
+			for( size_t v = 0; v < queries.size(); ++v )
+				found += LinearSearch( queries[ v ].c_str(), synthetic.c_str(), end );
+		double const linear = ( Now() - start ) * 1000.0 / REPEATS;
+		if( found != (int)names.size() * REPEATS )
+			printf( "linear search found %d of %d\n", found / REPEATS, (int)names.size() );
+
+		Report( "table", "lookup_ms", table, "ms" );
+		Report( "linear", "lookup_ms", linear, "ms" );
+		Report( "table", "speedup", linear / table, "x" );
+	}
+	bool Frame()
+	{
+		return false;
+	}
+};
+
+static ExtensionsBenchmark extensions;
@@ -0,0 +1,151 @@
+#ifndef _WIN32 //glutFdFunc callbacks never fire on Windows
+
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/*services pipes from the main loop through glutFdFunc: a child process stands in for an input source, writing
+ a timestamped event down one pipe every millisecond, and every event is acknowledged back up another pipe from the
+ write callback; dispatch latency is the time from the child's write to the read callback, and the CPU the main loop
+ spends over the run shows whether anything is busy polling*/
+class FdBenchmark : public Benchmark
+{
+	enum { EVENTS = 2000, INTERVAL_US = 1000 };
+
+	int m_events[ 2 ]; //child -> main loop
+	int m_acks[ 2 ]; //main loop -> child
+	pid_t m_child;
+	int m_pendingacks;
+	bool m_done;
+	double m_start;
+	double m_cpustart;
+	std::vector< double > m_latency;
+	static FdBenchmark * s_instance;
+
+	static double CpuTime()
+	{
+		rusage usage;
+		getrusage( RUSAGE_SELF, &usage );
+		return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) * 1e-6;
+	}
+	//the child shares our copy of freeglut's clock origin, so its Now() lines up with ours
+	void Child()
+	{
+		close( m_events[ 0 ] );
+		close( m_acks[ 1 ] );
+		fcntl( m_acks[ 0 ], F_SETFL, O_NONBLOCK );
+		char acks[ 256 ];
+		for( int u = 0; u < EVENTS; ++u )
+		{
+			usleep( INTERVAL_US );
+			double const stamp = Now();
+			if( write( m_events[ 1 ], &stamp, sizeof( stamp ) ) != sizeof( stamp ) )
+				break;
+			while( read( m_acks[ 0 ], acks, sizeof( acks ) ) > 0 )
+				;
+		}
+		_exit( 0 );
+	}
+	static void Readable( int Fd )
+	{
+		FdBenchmark & self = *s_instance;
+		double stamps[ 64 ];
+		ssize_t got = read( Fd, stamps, sizeof( stamps ) );
+		if( got > 0 )
+		{
+			double const now = Now();
+			for( unsigned u = 0; u < got / sizeof( double ); ++u )
+				self.m_latency.push_back( ( now - stamps[ u ] ) * 1e6 );
+			self.m_pendingacks += (int)( got / sizeof( double ) );
+			glutFdFunc( self.m_acks[ 1 ], NULL, &Writable );
+			return;
+		}
+		if( got < 0 )
+			return; //EAGAIN, someone else got there first
+
+		//the child is done
+		glutFdFunc( Fd, NULL, NULL );
+		glutFdFunc( self.m_acks[ 1 ], NULL, NULL );
+		self.Finish();
+	}
+	static void Writable( int Fd )
+	{
+		FdBenchmark & self = *s_instance;
+		while( self.m_pendingacks && write( Fd, "", 1 ) == 1 )
+			--self.m_pendingacks;
+		if( !self.m_pendingacks )
+			glutFdFunc( Fd, NULL, NULL );
+	}
+	void Finish()
+	{
+		double const elapsed = Now() - m_start;
+		double const cpu = CpuTime() - m_cpustart;
+		close( m_events[ 0 ] );
+		close( m_acks[ 1 ] );
+		waitpid( m_child, NULL, 0 );
+
+		std::sort( m_latency.begin(), m_latency.end() );
+		Report( "pipe", "events", (double)m_latency.size(), "" );
+		if( !m_latency.empty() )
+		{
+			Report( "pipe", "p50_latency_us", m_latency[ m_latency.size() / 2 ], "us" );
+			Report( "pipe", "p99_latency_us", m_latency[ m_latency.size() * 99 / 100 ], "us" );
+			Report( "pipe", "max_latency_us", m_latency.back(), "us" );
+		}
+		Report( "pipe", "main_loop_cpu", cpu * 100.0 / elapsed, "%" );
+		m_done = true;
+	}
+
+public:
+	FdBenchmark() : Benchmark( "fd", "pipe events dispatched through glutFdFunc, latency and main loop CPU" ),
+		m_child( -1 ), m_pendingacks( 0 ), m_done( false ), m_start( 0.0 ), m_cpustart( 0.0 )
+	{
+		s_instance = this;
+	}
+	void Setup()
+	{
+		printf( "%d events, one every %d us\n", EVENTS, INTERVAL_US );
+		//with an idle callback the loop never sleeps, which would hide any busy polling
+		glutIdleFunc( NULL );
+
+		if( pipe( m_events ) || pipe( m_acks ) )
+		{
+			perror( "pipe" );
+			m_done = true;
+			return;
+		}
+		m_start = Now();
+		m_cpustart = CpuTime();
+		m_child = fork();
+		if( m_child < 0 )
+		{
+			perror( "fork" );
+			m_done = true;
+			return;
+		}
+		if( !m_child )
+			Child();
+
+		close( m_events[ 1 ] );
+		close( m_acks[ 0 ] );
+		fcntl( m_events[ 0 ], F_SETFL, O_NONBLOCK );
+		fcntl( m_acks[ 1 ], F_SETFL, O_NONBLOCK );
+		glutFdFunc( m_events[ 0 ], &Readable, NULL );
+	}
+	bool Frame()
+	{
+		return !m_done;
+	}
+};
+
+FdBenchmark * FdBenchmark::s_instance = NULL;
+static FdBenchmark fd;
+
+#endif
@@ -0,0 +1,66 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+
+/*10k window geometry glutGet calls a frame, answered from freeglut's ConfigureNotify cache and then with
+ GLUT_GEOMETRY_EXACT, where under X each one is a round-trip to the server*/
+class GeometryBenchmark : public Benchmark
+{
+	enum { CALLS = 10000, WARMUP_FRAMES = 2, MEASURED_FRAMES = 10 };
+
+	int m_exact; //0 while measuring the cache, 1 for exact
+	int m_frame;
+	double m_elapsed;
+	double m_results[ 2 ];
+	int m_checksum; //keeps the calls from being optimised away, and both modes should agree on it
+
+public:
+	GeometryBenchmark() : Benchmark( "geometry", "10k glutGet window geometry queries per frame, cached against exact" ),
+		m_exact( 0 ), m_frame( 0 ), m_elapsed( 0.0 ), m_checksum( 0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d glutGet calls per frame, %d frames per case\n", CALLS, MEASURED_FRAMES );
+	}
+	bool Frame()
+	{
+		static GLenum const queries[] = { GLUT_WINDOW_X, GLUT_WINDOW_Y, GLUT_WINDOW_WIDTH, GLUT_WINDOW_HEIGHT,
+			GLUT_WINDOW_BORDER_WIDTH, GLUT_WINDOW_HEADER_HEIGHT };
+		int const count = sizeof( queries ) / sizeof( *queries );
+
+		glutSetOption( GLUT_GEOMETRY_EXACT, m_exact );
+		int checksum = 0;
+		double start = Now();
+		for( int u = 0; u < CALLS; ++u )
+			checksum += glutGet( queries[ u % count ] );
+		double elapsed = Now() - start;
+
+		if( m_frame++ >= WARMUP_FRAMES )
+			m_elapsed += elapsed;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		char const * const mode = m_exact ? "exact" : "cached";
+		m_results[ m_exact ] = m_elapsed * 1000.0 / MEASURED_FRAMES;
+		Report( mode, "frame_ms", m_results[ m_exact ], "ms" );
+		Report( mode, "ns_per_call", m_elapsed * 1e9 / ( (double)MEASURED_FRAMES * CALLS ), "ns" );
+		if( m_exact && checksum != m_checksum )
+			printf( "cached and exact geometry disagree: %d against %d\n", m_checksum, checksum );
+		m_checksum = checksum;
+		m_frame = 0;
+		m_elapsed = 0.0;
+
+		if( !m_exact )
+		{
+			m_exact = 1;
+			return true;
+		}
+		Report( "cached", "speedup", m_results[ 1 ] / m_results[ 0 ], "x" );
+		glutSetOption( GLUT_GEOMETRY_EXACT, GL_FALSE );
+		return false;
+	}
+};
+
+static GeometryBenchmark geometry;
@@ -0,0 +1,60 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+
+/*context init cost of glewInit resolving every entry point up front against glewLazy, where each one resolves itself
+ on its first call instead; the price of that is paid on the first call, so it is measured against a second call*/
+class GlewBenchmark : public Benchmark
+{
+	enum { REPEATS = 50 };
+
+	double InitMs( GLboolean Lazy ) const
+	{
+		glewLazy = Lazy;
+		double start = Now();
+		for( int u = 0; u < REPEATS; ++u )
+			glewInit();
+		return ( Now() - start ) * 1000.0 / REPEATS;
+	}
+
+public:
+	GlewBenchmark() : Benchmark( "glewinit", "glewInit resolving every entry point against lazy first-call resolution" )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d glewInit calls per case\n", REPEATS );
+		GLboolean const lazy = glewLazy;
+
+		double const eager = InitMs( GL_FALSE );
+		Report( "eager", "init_ms", eager, "ms" );
+		double const deferred = InitMs( GL_TRUE );
+		Report( "lazy", "init_ms", deferred, "ms" );
+		Report( "lazy", "speedup", eager / deferred, "x" );
+
+		//every glewInit puts the stubs back, so each repeat sees a first call again
+		double first = 0.0, second = 0.0;
+		for( int u = 0; u < REPEATS; ++u )
+		{
+			glewInit();
+			double const start = Now();
+			glIsBuffer( 0 );
+			double const middle = Now();
+			glIsBuffer( 0 );
+			first += middle - start;
+			second += Now() - middle;
+		}
+		Report( "lazy", "first_call_ns", first * 1e9 / REPEATS, "ns" );
+		Report( "lazy", "second_call_ns", second * 1e9 / REPEATS, "ns" );
+
+		glewLazy = lazy;
+		glewInit();
+	}
+	bool Frame()
+	{
+		return false;
+	}
+};
+
+static GlewBenchmark glew;
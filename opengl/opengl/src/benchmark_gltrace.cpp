@@ -0,0 +1,75 @@
+#ifndef GL_TRACE
+#define GL_TRACE //this file's own calls are always traced, so the overhead can be measured in any build
+#endif
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <gltrace.h>
+#include <stdio.h>
+
+/*what tracing a GL call costs, glRotatef called bare against through the trace macro, and what the tracer counts for
+ a frame of the scene; the scene is only counted in a build with GL_TRACE defined*/
+class GLTraceBenchmark : public Benchmark
+{
+	enum { WARMUP_FRAMES = 5, MEASURED_FRAMES = 50, CALLS = 20000 };
+
+	int m_frame;
+	double m_raw;
+	double m_traced;
+	double m_calls;
+	double m_gl;
+	double m_bytes;
+
+public:
+	GLTraceBenchmark() : Benchmark( "gltrace", "ns per glRotatef with and without the trace macro, and the scene's traced calls per frame" ),
+		m_frame( 0 ), m_raw( 0.0 ), m_traced( 0.0 ), m_calls( 0.0 ), m_gl( 0.0 ), m_bytes( 0.0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d frames of %d calls each way and the scene\n", MEASURED_FRAMES, CALLS );
+	}
+	bool Frame()
+	{
+		//the parentheses keep the macro from expanding
+		(glPushMatrix)();
+		double const start = Now();
+		for( int u = 0; u < CALLS; ++u )
+			(glRotatef)( 1.f, 0.f, 1.f, 0.f );
+		double const middle = Now();
+		for( int u = 0; u < CALLS; ++u )
+			glRotatef( 1.f, 0.f, 1.f, 0.f );
+		double const end = Now();
+		(glPopMatrix)();
+
+		GLTrace::Totals const before = GLTrace::FrameTotals();
+		DrawScene();
+		GLTrace::Totals const after = GLTrace::FrameTotals();
+
+		if( m_frame++ < WARMUP_FRAMES )
+			return true;
+		m_raw += middle - start;
+		m_traced += end - middle;
+		m_calls += after.Calls - before.Calls;
+		m_gl += after.Seconds - before.Seconds;
+		m_bytes += after.Bytes - before.Bytes;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		double const calls = (double)CALLS * MEASURED_FRAMES;
+		Report( "raw", "call_ns", m_raw * 1e9 / calls, "ns" );
+		Report( "traced", "call_ns", m_traced * 1e9 / calls, "ns" );
+		Report( "traced", "overhead_ns", ( m_traced - m_raw ) * 1e9 / calls, "ns" );
+		if( !m_calls )
+		{
+			printf( "the scene was built without GL_TRACE, so none of its calls were counted\n" );
+			return false;
+		}
+		Report( "scene", "calls", m_calls / MEASURED_FRAMES, "" );
+		Report( "scene", "gl_ms", m_gl * 1000.0 / MEASURED_FRAMES, "ms" );
+		Report( "scene", "uploaded", m_bytes / MEASURED_FRAMES, "bytes" );
+		return false;
+	}
+};
+
+static GLTraceBenchmark gltrace;
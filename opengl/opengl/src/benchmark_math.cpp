@@ -0,0 +1,632 @@
+#include <benchmark.h>
+#include <vecmath.h>
+#include <simdmath.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+namespace
+{
+	enum { INPUTS = 4096, ROUNDS = 32, PASSES = 9 };
+
+	struct Matrix
+	{
+		float m[ 16 ];
+	};
+
+	//the inputs, drawn once from a fixed seed so every run and every commit times the same numbers
+	Vec4 Rotations[ INPUTS ]; //unit quaternions
+	Vec4 Targets[ INPUTS ]; //unit quaternions
+	Vec3 Points[ INPUTS ]; //anywhere in and around the terrarium
+	Vec3 Directions[ INPUTS ]; //unit vectors
+	float Amounts[ INPUTS ]; //interpolation parameters, 0 to 1
+	float Scales[ INPUTS ]; //speeds per frame and the like
+	Matrix Transforms[ INPUTS ]; //a rotation and a translation, as QuaternionToMatrix and glTranslatef make them
+	//the same again for simdmath.h
+	Simd::Quat SimdRotations[ INPUTS ];
+	Simd::Quat SimdTargets[ INPUTS ];
+	Simd::Vec3 SimdPoints[ INPUTS ];
+	Simd::Vec3 SimdDirections[ INPUTS ];
+	Simd::Mat4 SimdTransforms[ INPUTS ];
+
+	float volatile Sink; //what the timed loops leave behind, so they cannot be dropped
+
+	//xorshift, rather than rand(), so the scene's own random sequence is left alone
+	unsigned Seed = 2463534242u;
+	float Random( float Low, float High )
+	{
+		Seed ^= Seed << 13;
+		Seed ^= Seed >> 17;
+		Seed ^= Seed << 5;
+		return Low + ( High - Low ) * (float)( Seed >> 8 ) / (float)( 1 << 24 );
+	}
+
+	Vec4 RandomRotation()
+	{
+		for( ;; )
+		{
+			Vec4 const q( Random( -1.f, 1.f ), Random( -1.f, 1.f ), Random( -1.f, 1.f ), Random( -1.f, 1.f ) );
+			float const length = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+			if( length > 0.01f && length <= 1.f ) //uniform over the sphere once normalised
+				return Normalize( q );
+		}
+	}
+
+	void MakeInputs()
+	{
+		for( int i = 0; i < INPUTS; ++i )
+		{
+			Rotations[ i ] = RandomRotation();
+			Targets[ i ] = RandomRotation();
+			Points[ i ] = Vec3( Random( -20.f, 20.f ), Random( -20.f, 20.f ), Random( -20.f, 20.f ) );
+			Directions[ i ] = ToVec3( RandomRotation() );
+			Directions[ i ] = Normalize( Directions[ i ] );
+			Amounts[ i ] = Random( 0.f, 1.f );
+			Scales[ i ] = Random( 0.01f, 2.f );
+			memcpy( Transforms[ i ].m, QuaternionToMatrix( Rotations[ i ] ), sizeof( Transforms[ i ].m ) );
+			Transforms[ i ].m[ 12 ] = Points[ i ].x;
+			Transforms[ i ].m[ 13 ] = Points[ i ].y;
+			Transforms[ i ].m[ 14 ] = Points[ i ].z;
+
+			SimdRotations[ i ] = Simd::Quat( Rotations[ i ].x, Rotations[ i ].y, Rotations[ i ].z, Rotations[ i ].w );
+			SimdTargets[ i ] = Simd::Quat( Targets[ i ].x, Targets[ i ].y, Targets[ i ].z, Targets[ i ].w );
+			SimdPoints[ i ] = Simd::Vec3( Points[ i ].x, Points[ i ].y, Points[ i ].z );
+			SimdDirections[ i ] = Simd::Vec3( Directions[ i ].x, Directions[ i ].y, Directions[ i ].z );
+			memcpy( SimdTransforms[ i ].m, Transforms[ i ].m, sizeof( SimdTransforms[ i ].m ) );
+		}
+	}
+
+	//a component of each result, to chain the next call on in the latency loops
+	float Link( float Value ) { return Value; }
+	float Link( Vec3 const & Value ) { return Value.x; }
+	float Link( Vec4 const & Value ) { return Value.x; }
+	float Link( Matrix const & Value ) { return Value.m[ 0 ]; }
+	float Link( Simd::Vec3 const & Value ) { return Value.x; }
+	float Link( Simd::Vec4 const & Value ) { return Value.x; }
+	float Link( Simd::Quat const & Value ) { return Value.x; }
+	float Link( Simd::Mat4 const & Value ) { return Value.m[ 0 ]; }
+
+	//the largest difference of a result, of either library, from the same math done in double
+	double Error( float Got, double Want )
+	{
+		return fabs( Got - Want );
+	}
+	template< class Vector > double Error( Vector const & Got, double X, double Y, double Z )
+	{
+		double const x = fabs( Got.x - X ), y = fabs( Got.y - Y ), z = fabs( Got.z - Z );
+		return x > y ? ( x > z ? x : z ) : ( y > z ? y : z );
+	}
+	template< class Vector > double Error( Vector const & Got, double X, double Y, double Z, double W )
+	{
+		double const xyz = Error( Got, X, Y, Z ), w = fabs( Got.w - W );
+		return xyz > w ? xyz : w;
+	}
+	template< class Vector > double Error( Vector const & Got, double Length, double X, double Y, double Z, double W )
+	{
+		return Error( Got, X / Length, Y / Length, Z / Length, W / Length );
+	}
+	template< class Vector > double TransformError( Vector const & Got, float const * m, Vec3 const & Point )
+	{
+		double const x = Point.x, y = Point.y, z = Point.z;
+		double want[ 4 ];
+		for( int r = 0; r < 4; ++r )
+			want[ r ] = m[ 0*4 + r ] * x + m[ 1*4 + r ] * y + m[ 2*4 + r ] * z + m[ 3*4 + r ];
+		return Error( Got, want[ 0 ] / want[ 3 ], want[ 1 ] / want[ 3 ], want[ 2 ] / want[ 3 ] );
+	}
+
+	/*each case calls one function on the i'th inputs, with Glue added to one of them; Glue is 0, but as it comes from the
+	 last call's result in the latency loop the calls cannot overlap there. Error redoes the call in double*/
+	struct GlueCase
+	{
+		typedef Vec3 Result;
+		static char const * Name() { return "glue"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec3 u = Points[ i ];
+			u.x += Glue;
+			return u;
+		}
+		template< class Got > static double Error( Got const &, int ) { return 0.0; }
+	};
+
+	struct MultiplyCase
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "QuaternionMultiply"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec4 q = Rotations[ i ];
+			q.x += Glue;
+			return QuaternionMultiply( q, Targets[ i ] );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			Vec4 const & a = Rotations[ i ], & b = Targets[ i ];
+			double const ax = a.x, ay = a.y, az = a.z, aw = a.w, bx = b.x, by = b.y, bz = b.z, bw = b.w;
+			return ::Error( got, ax * bw + ay * bz - az * by + aw * bx, -ax * bz + ay * bw + az * bx + aw * by,
+				ax * by - ay * bx + az * bw + aw * bz, -ax * bx - ay * by - az * bz + aw * bw );
+		}
+	};
+
+	struct SlerpCase
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "QuaternionSlerp"; }
+		static Result Call( int i, float Glue )
+		{
+			return QuaternionSlerp( Rotations[ i ], Targets[ i ], Amounts[ i ] + Glue );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			Vec4 const & a = Rotations[ i ], & b = Targets[ i ];
+			double const t = Amounts[ i ];
+			double dot = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z + (double)a.w * b.w;
+			dot = dot < -1.0 ? -1.0 : dot > 1.0 ? 1.0 : dot;
+			double const omega = acos( dot );
+			double const s0 = sin( ( 1.0 - t ) * omega ) / sin( omega ), s1 = sin( t * omega ) / sin( omega );
+			return ::Error( got, a.x * s0 + b.x * s1, a.y * s0 + b.y * s1, a.z * s0 + b.z * s1, a.w * s0 + b.w * s1 );
+		}
+	};
+
+	struct LerpCase
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "QuaternionLerp"; }
+		static Result Call( int i, float Glue )
+		{
+			return QuaternionLerp( Rotations[ i ], Targets[ i ], Amounts[ i ] + Glue );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			Vec4 const & a = Rotations[ i ], & b = Targets[ i ];
+			double const t = Amounts[ i ];
+			double const dot = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z + (double)a.w * b.w;
+			double const u = dot < 0.0 ? -t : t;
+			return ::Error( got, ( 1.0 - t ) * a.x + u * b.x, ( 1.0 - t ) * a.y + u * b.y, ( 1.0 - t ) * a.z + u * b.z,
+				( 1.0 - t ) * a.w + u * b.w );
+		}
+	};
+
+	struct ToMatrixCase
+	{
+		typedef Matrix Result;
+		static char const * Name() { return "QuaternionToMatrix"; }
+		static Result Call( int i, float Glue )
+		{
+			//copied out, as the caller has to before the next call overwrites it
+			Vec4 q = Rotations[ i ];
+			q.y += Glue; //m[ 0 ] does not depend on x
+			Matrix m;
+			memcpy( m.m, QuaternionToMatrix( q ), sizeof( m.m ) );
+			return m;
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			Vec4 const & q = Rotations[ i ];
+			double const x = q.x, y = q.y, z = q.z, w = q.w;
+			double const want[ 16 ] =
+			{
+				1.0 - 2.0 * ( y * y + z * z ), 2.0 * ( x * y + z * w ), 2.0 * ( x * z - y * w ), 0.0,
+				2.0 * ( x * y - z * w ), 1.0 - 2.0 * ( x * x + z * z ), 2.0 * ( y * z + x * w ), 0.0,
+				2.0 * ( x * z + y * w ), 2.0 * ( y * z - x * w ), 1.0 - 2.0 * ( x * x + y * y ), 0.0,
+				0.0, 0.0, 0.0, 1.0
+			};
+			double worst = 0.0;
+			for( int e = 0; e < 16; ++e )
+			{
+				double const error = ::Error( got.m[ e ], want[ e ] );
+				if( error > worst )
+					worst = error;
+			}
+			return worst;
+		}
+	};
+
+	struct TransformCase
+	{
+		typedef Vec3 Result;
+		static char const * Name() { return "TransformCoord"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec3 p = Points[ i ];
+			p.x += Glue;
+			return TransformCoord( Transforms[ i ].m, p );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			return TransformError( got, Transforms[ i ].m, Points[ i ] );
+		}
+	};
+
+	struct CrossCase
+	{
+		typedef Vec3 Result;
+		static char const * Name() { return "CrossProduct"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec3 u = Points[ i ];
+			u.y += Glue; //nor the cross product's x
+			return CrossProduct( u, Directions[ i ] );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			double const ux = Points[ i ].x, uy = Points[ i ].y, uz = Points[ i ].z;
+			double const vx = Directions[ i ].x, vy = Directions[ i ].y, vz = Directions[ i ].z;
+			return ::Error( got, uy * vz - vy * uz, uz * vx - vz * ux, ux * vy - vx * uy );
+		}
+	};
+
+	struct NormalizeCase
+	{
+		typedef Vec3 Result;
+		static char const * Name() { return "Normalize"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec3 u = Points[ i ];
+			u.x += Glue;
+			return Normalize( u );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			double const x = Points[ i ].x, y = Points[ i ].y, z = Points[ i ].z;
+			double const length = sqrt( x * x + y * y + z * z );
+			return ::Error( got, x / length, y / length, z / length );
+		}
+	};
+
+	struct Normalize4Case
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "Normalize4"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec4 q( Points[ i ], Scales[ i ] );
+			q.x += Glue;
+			return Normalize( q );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			double const x = Points[ i ].x, y = Points[ i ].y, z = Points[ i ].z, w = Scales[ i ];
+			return ::Error( got, sqrt( x * x + y * y + z * z + w * w ), x, y, z, w );
+		}
+	};
+
+	struct ScaleCase
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "Scale"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec4 q = Rotations[ i ];
+			q.x += Glue;
+			return Scale( q, Scales[ i ] );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			Vec4 const & q = Rotations[ i ];
+			double const x = q.x, y = q.y, z = q.z, w = q.w;
+			return ::Error( got, sqrt( x * x + y * y + z * z + w * w ) / Scales[ i ], x, y, z, w );
+		}
+	};
+
+	struct DotCase
+	{
+		typedef float Result;
+		static char const * Name() { return "DotProduct"; }
+		static Result Call( int i, float Glue )
+		{
+			Vec3 u = Points[ i ];
+			u.x += Glue;
+			return DotProduct( u, Directions[ i ] );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			double const ux = Points[ i ].x, uy = Points[ i ].y, uz = Points[ i ].z;
+			double const vx = Directions[ i ].x, vy = Directions[ i ].y, vz = Directions[ i ].z;
+			double const lengths = sqrt( ux * ux + uy * uy + uz * uz ) * sqrt( vx * vx + vy * vy + vz * vz );
+			return ::Error( got, ( ux * vx + uy * vy + uz * vz ) / lengths );
+		}
+	};
+
+	struct RotationCase
+	{
+		typedef Vec4 Result;
+		static char const * Name() { return "CalculateRotation"; }
+		//v is not unit length, as the rotation between two vectors takes any; CalculateRotation's DotProduct normalises
+		//both, making its |u||v| term 1 where it should be |v|, so this case's error is the function's, not rounding
+		static Result Call( int i, float Glue )
+		{
+			Vec3 u = Directions[ i ];
+			u.x += Glue;
+			return CalculateRotation( u, ToVec3( Targets[ i ] ) );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			//the rotation taking u onto v: the cross product, and |u||v| + u.v, normalised
+			double const ux = Directions[ i ].x, uy = Directions[ i ].y, uz = Directions[ i ].z;
+			double const vx = Targets[ i ].x, vy = Targets[ i ].y, vz = Targets[ i ].z;
+			double const x = uy * vz - vy * uz, y = uz * vx - vz * ux, z = ux * vy - vx * uy;
+			double const w = sqrt( ( ux * ux + uy * uy + uz * uz ) * ( vx * vx + vy * vy + vz * vz ) ) + ux * vx + uy * vy + uz * vz;
+			return ::Error( got, sqrt( x * x + y * y + z * z + w * w ), x, y, z, w );
+		}
+	};
+	//simdmath.h's versions, checked against the same references; the glued input is built whole, as changing one float
+	//of a vector in memory and loading it back as a register stalls on the store
+	struct SimdMultiplyCase : MultiplyCase
+	{
+		typedef Simd::Quat Result;
+		static char const * Name() { return "simd_QuaternionMultiply"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Quat const & q = SimdRotations[ i ];
+			return Simd::Multiply( Simd::Quat( q.x + Glue, q.y, q.z, q.w ), SimdTargets[ i ] );
+		}
+	};
+
+	struct SimdSlerpCase : SlerpCase
+	{
+		typedef Simd::Quat Result;
+		static char const * Name() { return "simd_QuaternionSlerp"; }
+		static Result Call( int i, float Glue )
+		{
+			return Simd::Slerp( SimdRotations[ i ], SimdTargets[ i ], Amounts[ i ] + Glue );
+		}
+	};
+
+	struct SimdLerpCase : LerpCase
+	{
+		typedef Simd::Quat Result;
+		static char const * Name() { return "simd_QuaternionLerp"; }
+		static Result Call( int i, float Glue )
+		{
+			return Simd::Lerp( SimdRotations[ i ], SimdTargets[ i ], Amounts[ i ] + Glue );
+		}
+	};
+
+	struct SimdToMatrixCase : ToMatrixCase
+	{
+		typedef Simd::Mat4 Result;
+		static char const * Name() { return "simd_QuaternionToMatrix"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Quat const & q = SimdRotations[ i ];
+			return Simd::ToMatrix( Simd::Quat( q.x, q.y + Glue, q.z, q.w ) );
+		}
+	};
+
+	struct SimdTransformCase : TransformCase
+	{
+		typedef Simd::Vec3 Result;
+		static char const * Name() { return "simd_TransformCoord"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & p = SimdPoints[ i ];
+			return Simd::TransformCoord( SimdTransforms[ i ], Simd::Vec3( p.x + Glue, p.y, p.z ) );
+		}
+	};
+
+	struct SimdCrossCase : CrossCase
+	{
+		typedef Simd::Vec3 Result;
+		static char const * Name() { return "simd_CrossProduct"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & u = SimdPoints[ i ];
+			return Simd::Cross( Simd::Vec3( u.x, u.y + Glue, u.z ), SimdDirections[ i ] );
+		}
+	};
+
+	struct SimdNormalizeCase : NormalizeCase
+	{
+		typedef Simd::Vec3 Result;
+		static char const * Name() { return "simd_Normalize"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & u = SimdPoints[ i ];
+			return Simd::Normalize( Simd::Vec3( u.x + Glue, u.y, u.z ) );
+		}
+	};
+
+	struct SimdNormalize4Case : Normalize4Case
+	{
+		typedef Simd::Vec4 Result;
+		static char const * Name() { return "simd_Normalize4"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & u = SimdPoints[ i ];
+			return Simd::Normalize( Simd::Vec4( u.x + Glue, u.y, u.z, Scales[ i ] ) );
+		}
+	};
+
+	struct SimdScaleCase : ScaleCase
+	{
+		typedef Simd::Vec4 Result;
+		static char const * Name() { return "simd_Scale"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Quat const & q = SimdRotations[ i ];
+			return Simd::Scale( Simd::Vec4( q.x + Glue, q.y, q.z, q.w ), Scales[ i ] );
+		}
+	};
+
+	//Dot does not normalise, so this is the plain dot product
+	struct SimdDotCase
+	{
+		typedef float Result;
+		static char const * Name() { return "simd_Dot"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & u = SimdPoints[ i ];
+			return Simd::Dot( Simd::Vec3( u.x + Glue, u.y, u.z ), SimdDirections[ i ] );
+		}
+		template< class Got > static double Error( Got const & got, int i )
+		{
+			return ::Error( got, (double)Points[ i ].x * Directions[ i ].x + (double)Points[ i ].y * Directions[ i ].y +
+				(double)Points[ i ].z * Directions[ i ].z );
+		}
+	};
+
+	struct SimdRotationCase : RotationCase
+	{
+		typedef Simd::Quat Result;
+		static char const * Name() { return "simd_Rotation"; }
+		static Result Call( int i, float Glue )
+		{
+			Simd::Vec3 const & u = SimdDirections[ i ];
+			Simd::Quat const & v = SimdTargets[ i ];
+			return Simd::Rotation( Simd::Vec3( u.x + Glue, u.y, u.z ), Simd::Vec3( v.x, v.y, v.z ) );
+		}
+	};
+
+	//the batch kernels over all the inputs at once, Run being one pass
+	struct BatchTransformCase
+	{
+		typedef Simd::Vec3 Result;
+		static char const * Name() { return "batch_TransformCoord"; }
+		static void Run( Result * Out ) { Simd::TransformCoords( SimdTransforms[ 0 ], SimdPoints, Out, INPUTS ); }
+		static double Error( Result const & got, int i ) { return TransformError( got, Transforms[ 0 ].m, Points[ i ] ); }
+	};
+
+	struct BatchNormalizeCase : NormalizeCase
+	{
+		typedef Simd::Vec3 Result;
+		static char const * Name() { return "batch_Normalize"; }
+		static void Run( Result * Out ) { Simd::Normalize( SimdPoints, Out, INPUTS ); }
+	};
+
+	struct BatchMultiplyCase : MultiplyCase
+	{
+		typedef Simd::Quat Result;
+		static char const * Name() { return "batch_QuaternionMultiply"; }
+		static void Run( Result * Out ) { Simd::Multiply( SimdRotations, SimdTargets, Out, INPUTS ); }
+	};
+}
+
+/*the time and accuracy of the math every entity update goes through, on random inputs of the sizes the scene uses.
+ Throughput is the time per call when consecutive calls are independent, latency when each call waits on the last
+ one's result; the latency loop's chaining costs what the "glue" case reports, which is included in every case's.
+ Accuracy is the largest difference of any component from the same math done in double. The "simd_" cases are
+ simdmath.h's counterparts of the same functions on the same inputs, and the "batch_" ones its array kernels*/
+class MathBenchmark : public Benchmark
+{
+	//the best of PASSES passes over the inputs, in ns per call
+	template< class Case > double Throughput()
+	{
+		static typename Case::Result results[ INPUTS ];
+		double best = 0.0;
+		for( int p = 0; p < PASSES; ++p )
+		{
+			double const start = Now();
+			for( int r = 0; r < ROUNDS; ++r )
+			{
+				for( int i = 0; i < INPUTS; ++i )
+					results[ i ] = Case::Call( i, 0.f );
+			}
+			double const seconds = Now() - start;
+			if( !p || seconds < best )
+				best = seconds;
+		}
+		for( int i = 0; i < INPUTS; ++i )
+			Sink = Sink + Link( results[ i ] );
+		return best * 1e9 / ( (double)ROUNDS * INPUTS );
+	}
+	template< class Case > double Latency()
+	{
+		double best = 0.0;
+		float glue = 0.f;
+		for( int p = 0; p < PASSES; ++p )
+		{
+			double const start = Now();
+			for( int r = 0; r < ROUNDS; ++r )
+			{
+				for( int i = 0; i < INPUTS; ++i )
+					glue = Link( Case::Call( i, glue ) ) * 0.f;
+			}
+			double const seconds = Now() - start;
+			if( !p || seconds < best )
+				best = seconds;
+		}
+		Sink = Sink + glue;
+		return best * 1e9 / ( (double)ROUNDS * INPUTS );
+	}
+	template< class Case > void Measure()
+	{
+		double worst = 0.0;
+		for( int i = 0; i < INPUTS; ++i )
+		{
+			double const error = Case::Error( Case::Call( i, 0.f ), i );
+			if( !( error <= worst ) ) //a NaN is the worst of all
+				worst = error;
+		}
+		Report( Case::Name(), "throughput_ns", Throughput< Case >(), "ns" );
+		Report( Case::Name(), "latency_ns", Latency< Case >(), "ns" );
+		Report( Case::Name(), "max_abs_error", worst, "" );
+	}
+	//a batch kernel's ns per element, the best of PASSES, and its error
+	template< class Case > void MeasureBatch()
+	{
+		static typename Case::Result results[ INPUTS ];
+		double best = 0.0;
+		for( int p = 0; p < PASSES; ++p )
+		{
+			double const start = Now();
+			for( int r = 0; r < ROUNDS; ++r )
+				Case::Run( results );
+			double const seconds = Now() - start;
+			if( !p || seconds < best )
+				best = seconds;
+		}
+		double worst = 0.0;
+		for( int i = 0; i < INPUTS; ++i )
+		{
+			double const error = Case::Error( results[ i ], i );
+			if( !( error <= worst ) )
+				worst = error;
+			Sink = Sink + Link( results[ i ] );
+		}
+		Report( Case::Name(), "throughput_ns", best * 1e9 / ( (double)ROUNDS * INPUTS ), "ns" );
+		Report( Case::Name(), "max_abs_error", worst, "" );
+	}
+
+public:
+	MathBenchmark() : Benchmark( "math", "ns per call of the quaternion and vector functions, independent and chained, and their error against double" )
+	{
+	}
+	void Setup()
+	{
+		MakeInputs();
+		printf( "%d random inputs, the best of %d passes of %d rounds each\n", INPUTS, PASSES, ROUNDS );
+	}
+	bool Frame()
+	{
+		Measure< GlueCase >();
+		Measure< MultiplyCase >();
+		Measure< SlerpCase >();
+		Measure< LerpCase >();
+		Measure< ToMatrixCase >();
+		Measure< TransformCase >();
+		Measure< CrossCase >();
+		Measure< NormalizeCase >();
+		Measure< Normalize4Case >();
+		Measure< ScaleCase >();
+		Measure< DotCase >();
+		Measure< RotationCase >();
+		Measure< SimdMultiplyCase >();
+		Measure< SimdSlerpCase >();
+		Measure< SimdLerpCase >();
+		Measure< SimdToMatrixCase >();
+		Measure< SimdTransformCase >();
+		Measure< SimdCrossCase >();
+		Measure< SimdNormalizeCase >();
+		Measure< SimdNormalize4Case >();
+		Measure< SimdScaleCase >();
+		Measure< SimdDotCase >();
+		Measure< SimdRotationCase >();
+		MeasureBatch< BatchTransformCase >();
+		MeasureBatch< BatchNormalizeCase >();
+		MeasureBatch< BatchMultiplyCase >();
+		return false;
+	}
+};
+
+static MathBenchmark math;
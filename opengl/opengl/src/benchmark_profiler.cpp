@@ -0,0 +1,96 @@
+#ifndef PROFILE
+#define PROFILE //this file's own scopes are always compiled, so their cost can be measured in any build
+#endif
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <profiler.h>
+#include <stdio.h>
+
+/*what a profiler scope costs recording and not, and the scene's frame time with its scopes recording against not,
+ alternating frame by frame so drift hits both alike; the scene only has scopes in a build with PROFILE defined.
+ With -profile the recording scopes are not timed, as they would push the scene's out of the trace's ring*/
+class ProfilerBenchmark : public Benchmark
+{
+	enum { WARMUP_FRAMES = 10, MEASURED_FRAMES = 200, SCOPES = 20000 };
+
+	bool m_enabled; //as -profile left it, put back at the end
+	int m_frame;
+	double m_idle;
+	double m_recording;
+	double m_frames[ 2 ]; //summed seconds with the scopes idle, then recording
+	double m_scopes; //the scene's, summed over the recording frames
+
+public:
+	ProfilerBenchmark() : Benchmark( "profiler", "ns per profiler scope idle and recording, and the scene's frame time with its scopes recording" ),
+		m_enabled( false ), m_frame( 0 ), m_idle( 0.0 ), m_recording( 0.0 ), m_scopes( 0.0 )
+	{
+		m_frames[ 0 ] = m_frames[ 1 ] = 0.0;
+	}
+	void Setup()
+	{
+		m_enabled = Profiler::Enabled();
+		printf( "%d frames of %d scopes each way, the scene alternately recording and not\n", MEASURED_FRAMES, SCOPES );
+		if( m_enabled )
+			printf( "-profile is recording the trace, so only the idle scopes are timed\n" );
+	}
+	bool Frame()
+	{
+		Profiler::Enable( false );
+		double const start = Now();
+		for( int u = 0; u < SCOPES; ++u )
+		{
+			PROFILE_SCOPE( "idle" );
+		}
+		double const middle = Now();
+		if( !m_enabled )
+		{
+			Profiler::Enable( true );
+			for( int u = 0; u < SCOPES; ++u )
+			{
+				PROFILE_SCOPE( "recording" );
+			}
+		}
+		double const end = Now();
+
+		bool const recording = m_frame & 1;
+		Profiler::Enable( recording );
+		unsigned long const recorded = Profiler::ThreadScopes();
+		double const before = Now();
+		DrawScene();
+		glFinish();
+		double const after = Now();
+		unsigned long const counted = Profiler::ThreadScopes() - recorded;
+		Profiler::Enable( m_enabled );
+
+		if( m_frame++ < WARMUP_FRAMES )
+			return true;
+		m_idle += middle - start;
+		m_recording += end - middle;
+		m_frames[ recording ] += after - before;
+		m_scopes += counted;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		double const scopes = (double)SCOPES * MEASURED_FRAMES;
+		double const frames = MEASURED_FRAMES / 2;
+		double const scope = m_recording / scopes;
+		Report( "idle", "scope_ns", m_idle * 1e9 / scopes, "ns" );
+		if( !m_enabled )
+			Report( "recording", "scope_ns", scope * 1e9, "ns" );
+		Report( "scene", "frame_ms", m_frames[ 0 ] * 1000.0 / frames, "ms" );
+		Report( "scene_profiled", "frame_ms", m_frames[ 1 ] * 1000.0 / frames, "ms" );
+		if( !m_scopes )
+		{
+			printf( "the scene was built without PROFILE, so it has no scopes to record\n" );
+			return false;
+		}
+		//the difference of the two frame times is mostly noise at this size, the scopes' own cost is not
+		Report( "scene_profiled", "scopes", m_scopes / frames, "" );
+		if( !m_enabled )
+			Report( "scene_profiled", "overhead", m_scopes * scope * 100.0 / m_frames[ 0 ], "%" );
+		return false;
+	}
+};
+
+static ProfilerBenchmark profiler;
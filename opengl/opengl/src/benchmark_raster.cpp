@@ -0,0 +1,124 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <rasteriser.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*the program's own scene, drawn by GL and mirrored into the CPU rasteriser, which renders each frame once on one
+ thread and again on one per core; its frame is diffed against the one GL drew, and the last of each is written out
+ as raster_cpu.ppm and raster_gl.ppm to look at*/
+class RasterBenchmark : public Benchmark
+{
+	enum { WARMUP_FRAMES = 2, MEASURED_FRAMES = 20, TOLERANCE = 8 };
+
+	Rasteriser m_raster;
+	int m_frame;
+	double m_setup;
+	double m_single;
+	double m_parallel;
+	double m_triangles;
+	double m_binned;
+	double m_fragments;
+	double m_error; //summed over every channel
+	double m_over; //pixels with a channel off by more than TOLERANCE
+	double m_pixels;
+	int m_maxerror;
+	std::vector< unsigned char > m_gl;
+
+	static void WritePPM( char const * FileName, unsigned char const * Rgba, int Width, int Height )
+	{
+		FILE * file = fopen( FileName, "wb" );
+		if( !file )
+		{
+			printf( "could not write %s\n", FileName );
+			return;
+		}
+		fprintf( file, "P6\n%d %d\n255\n", Width, Height );
+		for( int y = Height - 1; y >= 0; --y )
+			for( int x = 0; x < Width; ++x )
+				fwrite( Rgba + ( y * Width + x ) * 4, 3, 1, file );
+		fclose( file );
+	}
+	void Diff( unsigned char const * Cpu, int Pixels )
+	{
+		for( int u = 0; u < Pixels; ++u )
+		{
+			int worst = 0;
+			for( int c = 0; c < 3; ++c )
+			{
+				int const error = abs( Cpu[ u * 4 + c ] - m_gl[ u * 4 + c ] );
+				m_error += error;
+				worst = error > worst ? error : worst;
+			}
+			m_over += worst > TOLERANCE;
+			m_maxerror = worst > m_maxerror ? worst : m_maxerror;
+		}
+		m_pixels += Pixels;
+	}
+
+public:
+	RasterBenchmark() : Benchmark( "raster", "the scene through the tile-binned CPU rasteriser, Mtri/s and Mpix/s, diffed against GL" ),
+		m_frame( 0 ), m_setup( 0.0 ), m_single( 0.0 ), m_parallel( 0.0 ), m_triangles( 0.0 ), m_binned( 0.0 ), m_fragments( 0.0 ),
+		m_error( 0.0 ), m_over( 0.0 ), m_pixels( 0.0 ), m_maxerror( 0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d frames, 1 and %u threads, %dx%d tiles, differences over %d/255 counted\n", MEASURED_FRAMES,
+			Rasteriser::CoreCount(), (int)Rasteriser::TILE_SIZE, (int)Rasteriser::TILE_SIZE, (int)TOLERANCE );
+	}
+	bool Frame()
+	{
+		m_raster.Begin();
+		Rasteriser::Capture = &m_raster;
+		DrawScene();
+		Rasteriser::Capture = NULL;
+
+		int const width = m_raster.GetWidth(), height = m_raster.GetHeight();
+		m_gl.resize( width * height * 4 );
+		glReadPixels( 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &m_gl[ 0 ] );
+
+		double const single = m_raster.Render( 1 );
+		double const parallel = m_raster.Render( 0 );
+		if( m_frame++ < WARMUP_FRAMES )
+			return true;
+
+		Rasteriser::Stats const & stats = m_raster.GetStats();
+		m_setup += stats.SetupSeconds;
+		m_single += single;
+		m_parallel += parallel;
+		m_triangles += stats.Triangles;
+		m_binned += stats.Binned;
+		m_fragments += stats.Fragments;
+		Diff( m_raster.GetColorBuffer(), width * height );
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		Report( "setup", "triangles", m_triangles / MEASURED_FRAMES, "" );
+		Report( "setup", "binned", m_binned / MEASURED_FRAMES, "" );
+		Report( "setup", "fragments", m_fragments / MEASURED_FRAMES, "" );
+		Report( "setup", "frame_ms", m_setup * 1000.0 / MEASURED_FRAMES, "ms" );
+
+		static char const * const names[ 2 ] = { "single", "parallel" };
+		double const times[ 2 ] = { m_single, m_parallel };
+		for( int u = 0; u < 2; ++u )
+		{
+			Report( names[ u ], "frame_ms", times[ u ] * 1000.0 / MEASURED_FRAMES, "ms" );
+			Report( names[ u ], "triangles", m_triangles / ( m_setup + times[ u ] ) * 1e-6, "Mtri/s" );
+			Report( names[ u ], "pixels", m_fragments / times[ u ] * 1e-6, "Mpix/s" );
+		}
+		Report( "parallel", "threads", Rasteriser::CoreCount(), "" );
+		Report( "parallel", "speedup", m_single / m_parallel, "x" );
+
+		Report( "diff", "mean_abs_error", m_error / ( m_pixels * 3.0 ), "/255" );
+		Report( "diff", "max_error", m_maxerror, "/255" );
+		Report( "diff", "pixels_over_tolerance", m_over * 100.0 / m_pixels, "%" );
+		WritePPM( "raster_cpu.ppm", m_raster.GetColorBuffer(), width, height );
+		WritePPM( "raster_gl.ppm", &m_gl[ 0 ], width, height );
+		return false;
+	}
+};
+
+static RasterBenchmark raster;
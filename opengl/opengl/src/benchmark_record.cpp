@@ -0,0 +1,76 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <recorder.h>
+#include <stdio.h>
+
+/*the scene's frame time while every frame is recorded to a Y4M file, against without; recording should cost under
+ 5%. The frame time covers drawing, the readback and a glFinish, so GL's share of the work is measured as well*/
+class RecordBenchmark : public Benchmark
+{
+	enum { WARMUP_FRAMES = 10, MEASURED_FRAMES = 300 };
+
+	Recorder * m_recorder;
+	int m_recording; //0 for the first pass, 1 for the second
+	int m_frame;
+	double m_elapsed;
+	double m_results[ 2 ];
+
+public:
+	RecordBenchmark() : Benchmark( "record", "scene frame time recording every frame through the PBO ring to Y4M, against not recording" ),
+		m_recorder( NULL ), m_recording( 0 ), m_frame( 0 ), m_elapsed( 0.0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d frames per case, recording to record_benchmark.y4m, a ring of %d buffers\n", MEASURED_FRAMES, (int)Recorder::RING_SIZE );
+	}
+	bool Frame()
+	{
+		if( m_recording && !m_recorder )
+		{
+			m_recorder = new Recorder( "record_benchmark.y4m", Recorder::Y4M_FORMAT );
+			if( !m_recorder->IsOpen() )
+			{
+				printf( "could not open record_benchmark.y4m\n" );
+				return false;
+			}
+		}
+
+		double const start = Now();
+		DrawScene();
+		if( m_recorder )
+			m_recorder->Capture();
+		glFinish();
+		if( m_frame++ >= WARMUP_FRAMES )
+			m_elapsed += Now() - start;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		char const * const mode = m_recording ? "recording" : "plain";
+		m_results[ m_recording ] = m_elapsed * 1000.0 / MEASURED_FRAMES;
+		Report( mode, "frame_ms", m_results[ m_recording ], "ms" );
+		m_frame = 0;
+		m_elapsed = 0.0;
+		if( !m_recording )
+		{
+			m_recording = 1;
+			return true;
+		}
+
+		m_recorder->Finish();
+		Recorder::Stats const stats = m_recorder->GetStats();
+		Report( "recording", "overhead", ( m_results[ 1 ] / m_results[ 0 ] - 1.0 ) * 100.0, "%" );
+		Report( "recording", "written", stats.Written, "frames" );
+		Report( "recording", "dropped", stats.Dropped, "frames" );
+		Report( "recording", "mean_latency_ms", stats.Captured ? stats.Latency * 1000.0 / stats.Captured : 0.0, "ms" );
+		Report( "recording", "max_latency_ms", stats.MaxLatency * 1000.0, "ms" );
+		Report( "recording", "mean_stall_ms", stats.Captured ? stats.Stall * 1000.0 / stats.Captured : 0.0, "ms" );
+		delete m_recorder;
+		m_recorder = NULL;
+		remove( "record_benchmark.y4m" );
+		return false;
+	}
+};
+
+static RecordBenchmark record;
@@ -0,0 +1,93 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+
+/*draws each freeglut shape many times a frame, once from the geometry cache and once in immediate mode
+ (evaluators for the teapots, which get fewer calls since uncached they are two orders of magnitude slower)*/
+class ShapesBenchmark : public Benchmark
+{
+	enum { WARMUP_FRAMES = 2, MEASURED_FRAMES = 10, SHAPE_COUNT = 6 };
+
+	int m_shape;
+	int m_cached; //1 while measuring the cache, 0 for immediate mode
+	int m_frame;
+	double m_elapsed;
+	double m_results[ SHAPE_COUNT ][ 2 ];
+
+	static char const * ShapeName( int Shape )
+	{
+		static char const * const names[ SHAPE_COUNT ] = { "sphere", "cone", "cylinder", "torus", "solid_teapot", "wire_teapot" };
+		return names[ Shape ];
+	}
+	static int Calls( int Shape )
+	{
+		return Shape < 4 ? 10000 : 1000;
+	}
+	static void DrawShape( int Shape )
+	{
+		switch( Shape )
+		{
+		case 0: glutSolidSphere( 1.0, 16, 16 ); break;
+		case 1: glutSolidCone( 1.0, 2.0, 16, 8 ); break;
+		case 2: glutSolidCylinder( 1.0, 2.0, 16, 8 ); break;
+		case 3: glutSolidTorus( 0.3, 1.0, 16, 32 ); break;
+		case 4: glutSolidTeapot( 1.0 ); break;
+		case 5: glutWireTeapot( 1.0 ); break;
+		}
+	}
+
+public:
+	ShapesBenchmark() : Benchmark( "shapes", "glutSolid* sphere/cone/cylinder/torus, cached against immediate mode" ),
+		m_shape( 0 ), m_cached( 1 ), m_frame( 0 ), m_elapsed( 0.0 )
+	{
+	}
+	void Setup()
+	{
+		printf( "%d calls per frame (%d for the teapots), %d frames per case\n", Calls( 0 ), Calls( 4 ), MEASURED_FRAMES );
+	}
+	bool Frame()
+	{
+		glutSetOption( GLUT_GEOMETRY_CACHE, m_cached );
+		glDisable( GL_TEXTURE_2D );
+		glPushMatrix();
+		glTranslatef( 0.f, 0.f, -10.f );
+
+		//glFinish on both sides so the driver's share of the work lands in the measurement
+		glFinish();
+		double start = Now();
+		for( int u = 0, calls = Calls( m_shape ); u < calls; ++u )
+			DrawShape( m_shape );
+		glFinish();
+		double elapsed = Now() - start;
+
+		glPopMatrix();
+		glEnable( GL_TEXTURE_2D );
+
+		if( m_frame++ >= WARMUP_FRAMES )
+			m_elapsed += elapsed;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		double const frametime = m_elapsed * 1000.0 / MEASURED_FRAMES;
+		m_results[ m_shape ][ m_cached ] = frametime;
+		Report( ShapeName( m_shape ), m_cached ? "cached_frame_ms" : "immediate_frame_ms", frametime, "ms" );
+		m_frame = 0;
+		m_elapsed = 0.0;
+
+		if( m_cached )
+		{
+			m_cached = 0;
+			return true;
+		}
+		Report( ShapeName( m_shape ), "speedup", m_results[ m_shape ][ 0 ] / m_results[ m_shape ][ 1 ], "x" );
+		m_cached = 1;
+		if( ++m_shape < SHAPE_COUNT )
+			return true;
+
+		glutSetOption( GLUT_GEOMETRY_CACHE, GL_TRUE );
+		return false;
+	}
+};
+
+static ShapesBenchmark shapes;
@@ -0,0 +1,103 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+
+/*a few hundred short labels a frame, one GL call per glyph (or strip) against one text batch*/
+class TextBenchmark : public Benchmark
+{
+	enum { LABELS = 400, WARMUP_FRAMES = 2, MEASURED_FRAMES = 30, CASE_COUNT = 4 };
+
+	int m_case; //bitmap immediate, bitmap batched, stroke immediate, stroke batched
+	int m_frame;
+	double m_elapsed;
+	double m_results[ CASE_COUNT ];
+
+	static char const * CaseName( int Case )
+	{
+		static char const * const names[ CASE_COUNT ] = { "bitmap_immediate", "bitmap_batched", "stroke_immediate", "stroke_batched" };
+		return names[ Case ];
+	}
+	static void Label( int Index, char * Text )
+	{
+		sprintf( Text, "fish %03d", Index );
+	}
+	static void Position( int Index, float & x, float & y )
+	{
+		x = -8.f + ( Index % 20 ) * 0.8f;
+		y = -6.f + ( Index / 20 ) * 0.6f;
+	}
+	void DrawLabels()
+	{
+		char text[ 16 ];
+		float x, y;
+		bool const stroke = m_case >= 2;
+		bool const batched = m_case % 2 == 1;
+		float const scale = 0.002f;
+
+		if( batched )
+			glutTextBatchBegin( stroke ? GLUT_STROKE_ROMAN : GLUT_BITMAP_HELVETICA_10, stroke ? scale : 1.f );
+		for( int u = 0; u < LABELS; ++u )
+		{
+			Label( u, text );
+			Position( u, x, y );
+			if( batched )
+				glutTextBatchString( x, y, 0.f, (unsigned char const *)text );
+			else if( stroke )
+			{
+				glPushMatrix();
+				glTranslatef( x, y, 0.f );
+				glScalef( scale, scale, scale );
+				glutStrokeString( GLUT_STROKE_ROMAN, (unsigned char const *)text );
+				glPopMatrix();
+			}
+			else
+			{
+				glRasterPos3f( x, y, 0.f );
+				glutBitmapString( GLUT_BITMAP_HELVETICA_10, (unsigned char const *)text );
+			}
+		}
+		if( batched )
+			glutTextBatchEnd();
+	}
+
+public:
+	TextBenchmark() : Benchmark( "text", "400 bitmap and stroke labels a frame, per-glyph calls against glutTextBatch*" ),
+		m_case( 0 ), m_frame( 0 ), m_elapsed( 0.0 )
+	{
+	}
+	bool Frame()
+	{
+		glPushAttrib( GL_ENABLE_BIT );
+		glDisable( GL_LIGHTING );
+		glDisable( GL_TEXTURE_2D );
+		glDisable( GL_FOG );
+		glColor3f( 1.f, 1.f, 1.f );
+		glPushMatrix();
+		glTranslatef( 0.f, 0.f, -10.f );
+
+		glFinish();
+		double start = Now();
+		DrawLabels();
+		glFinish();
+		double elapsed = Now() - start;
+
+		glPopMatrix();
+		glPopAttrib();
+
+		if( m_frame++ >= WARMUP_FRAMES )
+			m_elapsed += elapsed;
+		if( m_frame < WARMUP_FRAMES + MEASURED_FRAMES )
+			return true;
+
+		m_results[ m_case ] = m_elapsed * 1000.0 / MEASURED_FRAMES;
+		Report( CaseName( m_case ), "frame_ms", m_results[ m_case ], "ms" );
+		if( m_case % 2 == 1 )
+			Report( CaseName( m_case ), "speedup", m_results[ m_case - 1 ] / m_results[ m_case ], "x" );
+		m_frame = 0;
+		m_elapsed = 0.0;
+		return ++m_case < CASE_COUNT;
+	}
+};
+
+static TextBenchmark text;
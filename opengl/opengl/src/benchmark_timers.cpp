@@ -0,0 +1,102 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*schedules 1e5 timers that stay pending for the whole run, then compares a periodic timer with a one-shot timer
+ re-armed at the end of its callback, both doing some simulated work per tick; lateness is measured against
+ the ideal start + n * period schedule, so drift shows up as lateness that keeps growing*/
+class TimersBenchmark : public Benchmark
+{
+	enum { PENDING = 100000, PERIOD_MS = 16, WORK_MS = 4, FIRES = 120 };
+	enum Phase { PERIODIC, REARM, DONE };
+
+	Phase m_phase;
+	int m_handle;
+	int m_fires;
+	double m_start;
+	double m_lateness[ 2 ][ FIRES ];
+	static TimersBenchmark * s_instance;
+
+	static void Pending( int )
+	{
+	}
+	static void Work()
+	{
+		double const until = Now() + WORK_MS / 1000.0;
+		while( Now() < until )
+			;
+	}
+	//records the tick, returns true once FIRES ticks have been seen
+	bool Tick()
+	{
+		m_lateness[ m_phase ][ m_fires ] = ( Now() - m_start ) * 1000.0 - ( m_fires + 1 ) * PERIOD_MS;
+		Work();
+		return ++m_fires == FIRES;
+	}
+	static void PeriodicFunc( int )
+	{
+		TimersBenchmark & self = *s_instance;
+		if( !self.Tick() )
+			return;
+		glutCancelTimer( self.m_handle );
+		self.m_phase = REARM;
+		self.m_fires = 0;
+		self.m_start = Now();
+		glutTimerFunc( PERIOD_MS, &RearmFunc, 0 );
+	}
+	static void RearmFunc( int )
+	{
+		TimersBenchmark & self = *s_instance;
+		if( self.Tick() )
+			self.m_phase = DONE;
+		else
+			glutTimerFunc( PERIOD_MS, &RearmFunc, 0 );
+	}
+	void ReportLateness( char const * Case, double const * Lateness ) const
+	{
+		double sum = 0.0, worst = 0.0;
+		for( int u = 0; u < FIRES; ++u )
+		{
+			sum += Lateness[ u ];
+			if( Lateness[ u ] > worst )
+				worst = Lateness[ u ];
+		}
+		Report( Case, "mean_lateness_ms", sum / FIRES, "ms" );
+		Report( Case, "max_lateness_ms", worst, "ms" );
+		Report( Case, "final_drift_ms", Lateness[ FIRES - 1 ], "ms" );
+	}
+
+public:
+	TimersBenchmark() : Benchmark( "timers", "timer insertion with 1e5 pending, periodic against re-armed timer drift" ),
+		m_phase( PERIODIC ), m_handle( 0 ), m_fires( 0 ), m_start( 0.0 )
+	{
+		s_instance = this;
+	}
+	void Setup()
+	{
+		printf( "%d pending timers, %d ms period, %d ms of work per tick, %d ticks per case\n", PENDING, PERIOD_MS, WORK_MS, FIRES );
+
+		//an hour or two out, none of these fire during the run
+		double start = Now();
+		for( int u = 0; u < PENDING; ++u )
+			glutTimerFunc( 3600000 + rand() % 3600000, &Pending, u );
+		Report( "insert", "ns_per_timer", ( Now() - start ) * 1e9 / PENDING, "ns" );
+
+		m_start = Now();
+		m_handle = glutPeriodicTimerFunc( PERIOD_MS, &PeriodicFunc, 0, GLUT_TIMER_CATCH_UP );
+	}
+	bool Frame()
+	{
+		if( m_phase != DONE )
+			return true;
+
+		ReportLateness( "periodic", m_lateness[ PERIODIC ] );
+		ReportLateness( "rearm", m_lateness[ REARM ] );
+		return false;
+	}
+};
+
+TimersBenchmark * TimersBenchmark::s_instance = NULL;
+static TimersBenchmark timers;
@@ -0,0 +1,139 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <benchmark.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <sys/select.h>
+#endif
+
+/*how promptly and how often the main loop wakes up: with the idle callback off, a periodic timer measures its
+ lateness against the ideal schedule, first alone and then with a slow-polling joystick callback registered,
+ which used to cap every sleep at 10 ms; wakeups are counted as voluntary context switches where there are any.
+ The same schedule is first run through a copy of the old wait, for a baseline*/
+class WakeupBenchmark : public Benchmark
+{
+	enum { PERIOD_MS = 16, FIRES = 125, JOYSTICK_POLL_MS = 250 };
+	enum Phase { TIMER, TIMER_JOYSTICK, DONE };
+
+	Phase m_phase;
+	int m_handle;
+	int m_fires;
+	double m_start;
+	long m_switches;
+	std::vector< double > m_lateness;
+	static WakeupBenchmark * s_instance;
+
+	static long ContextSwitches()
+	{
+#ifndef _WIN32
+		rusage usage;
+		getrusage( RUSAGE_SELF, &usage );
+		return usage.ru_nvcsw;
+#else
+		return 0;
+#endif
+	}
+	static void JoystickFunc( unsigned int, int, int, int )
+	{
+	}
+	void Begin()
+	{
+		m_fires = 0;
+		m_lateness.clear();
+		m_switches = ContextSwitches();
+		m_start = Now();
+		m_handle = glutPeriodicTimerFunc( PERIOD_MS, &TimerFunc, 0, GLUT_TIMER_CATCH_UP );
+	}
+	void End( char const * Case )
+	{
+		double const elapsed = Now() - m_start;
+		std::sort( m_lateness.begin(), m_lateness.end() );
+		Report( Case, "p50_lateness_us", m_lateness[ m_lateness.size() / 2 ], "us" );
+		Report( Case, "p99_lateness_us", m_lateness[ m_lateness.size() * 99 / 100 ], "us" );
+		Report( Case, "max_lateness_us", m_lateness.back(), "us" );
+#ifndef _WIN32
+		Report( Case, "wakeups_per_s", ( ContextSwitches() - m_switches ) / elapsed, "1/s" );
+#endif
+	}
+	//the old main loop's wait, outside the main loop: timers to the millisecond, each sleep a select() on the
+	//timeout alone, cut to 10 ms while a joystick callback is registered
+	void Baseline( char const * Case, bool Joystick )
+	{
+		m_lateness.clear();
+		m_switches = ContextSwitches();
+		m_start = Now();
+		for( int fires = 0; fires < FIRES; )
+		{
+			long const due = ( fires + 1 ) * PERIOD_MS;
+			long msec = due - (long)( ( Now() - m_start ) * 1000.0 );
+			if( msec <= 0 )
+			{
+				m_lateness.push_back( ( ( Now() - m_start ) * 1000.0 - due ) * 1000.0 );
+				++fires;
+				continue;
+			}
+			if( Joystick && msec > 10 )
+				msec = 10;
+#ifdef _WIN32
+			Sleep( (DWORD)msec );
+#else
+			timeval wait;
+			wait.tv_sec = msec / 1000;
+			wait.tv_usec = ( msec % 1000 ) * 1000;
+			select( 0, NULL, NULL, NULL, &wait );
+#endif
+		}
+		End( Case );
+	}
+	static void TimerFunc( int )
+	{
+		WakeupBenchmark & self = *s_instance;
+		self.m_lateness.push_back( ( ( Now() - self.m_start ) * 1000.0 - ( self.m_fires + 1 ) * PERIOD_MS ) * 1000.0 );
+		if( ++self.m_fires < FIRES )
+			return;
+
+		glutCancelTimer( self.m_handle );
+		if( self.m_phase == TIMER )
+		{
+			self.End( "timer" );
+			self.m_phase = TIMER_JOYSTICK;
+			glutJoystickFunc( &JoystickFunc, JOYSTICK_POLL_MS );
+			self.Begin();
+		}
+		else
+		{
+			self.End( "timer_joystick" );
+			glutJoystickFunc( NULL, -1 );
+			self.m_phase = DONE;
+		}
+	}
+
+public:
+	WakeupBenchmark() : Benchmark( "wakeup", "main loop timer lateness and wakeup rate, with and without a joystick callback" ),
+		m_phase( TIMER ), m_handle( 0 ), m_fires( 0 ), m_start( 0.0 ), m_switches( 0 )
+	{
+		s_instance = this;
+	}
+	void Setup()
+	{
+		printf( "%d ms periodic timer, %d ticks per case, joystick polled every %d ms\n", PERIOD_MS, FIRES, JOYSTICK_POLL_MS );
+		Baseline( "select_timer", false );
+		Baseline( "select_timer_joystick", true );
+		//with an idle callback the loop never sleeps
+		glutIdleFunc( NULL );
+		Begin();
+	}
+	bool Frame()
+	{
+		return m_phase != DONE;
+	}
+};
+
+WakeupBenchmark * WakeupBenchmark::s_instance = NULL;
+static WakeupBenchmark wakeup;
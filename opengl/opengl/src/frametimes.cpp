@@ -0,0 +1,201 @@
+#include <frametimes.h>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <gltrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+namespace
+{
+	//the index of the highest set bit, Value must not be 0
+	int HighestBit( unsigned long long Value )
+	{
+#ifdef _WIN32
+		//_BitScanReverse64 is only there for x64
+		unsigned long index;
+		if( _BitScanReverse( &index, (unsigned long)( Value >> 32 ) ) )
+			return (int)index + 32;
+		_BitScanReverse( &index, (unsigned long)Value );
+		return (int)index;
+#else
+		return 63 - __builtin_clzll( Value );
+#endif
+	}
+}
+
+void Histogram::Reset()
+{
+	memset( m_buckets, 0, sizeof( m_buckets ) );
+	m_count = 0;
+	m_min = ~0ull;
+	m_max = 0;
+}
+
+void Histogram::Record( unsigned long long Value )
+{
+	++m_buckets[ BucketOf( Value ) ];
+	++m_count;
+	if( Value < m_min )
+		m_min = Value;
+	if( Value > m_max )
+		m_max = Value;
+}
+
+unsigned long long Histogram::Percentile( double Percent ) const
+{
+	if( !m_count )
+		return 0;
+	unsigned long long target = (unsigned long long)ceil( Percent / 100.0 * m_count );
+	if( target < 1 )
+		target = 1;
+	if( target > m_count )
+		target = m_count;
+
+	unsigned long long seen = 0;
+	for( int b = 0; b < BUCKET_COUNT; ++b )
+	{
+		seen += m_buckets[ b ];
+		if( seen >= target )
+		{
+			unsigned long long const value = BucketHigh( b );
+			return value > m_max ? m_max : value < m_min ? m_min : value;
+		}
+	}
+	return m_max;
+}
+
+unsigned long long Histogram::BucketLow( int Bucket )
+{
+	if( Bucket < 2 * SUB_BUCKETS )
+		return Bucket;
+	int const shift = Bucket / SUB_BUCKETS - 1;
+	return (unsigned long long)( Bucket % SUB_BUCKETS + SUB_BUCKETS ) << shift;
+}
+
+unsigned long long Histogram::BucketHigh( int Bucket )
+{
+	if( Bucket < 2 * SUB_BUCKETS )
+		return Bucket;
+	return BucketLow( Bucket ) + ( 1ull << ( Bucket / SUB_BUCKETS - 1 ) ) - 1;
+}
+
+int Histogram::BucketOf( unsigned long long Value )
+{
+	if( Value < 2 * SUB_BUCKETS )
+		return (int)Value;
+	//the top SUB_BITS + 1 bits, the first of which is always set, pick the bucket within the power of two
+	int const shift = HighestBit( Value ) - SUB_BITS;
+	return shift * SUB_BUCKETS + (int)( Value >> shift );
+}
+
+FrameTimes::FrameTimes() : m_lastswap( 0 )
+{
+	strcpy( m_path, "frametimes.txt" );
+}
+
+void FrameTimes::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-frametimes" ) )
+			continue;
+
+		if( i + 1 >= argc || strlen( argv[ i + 1 ] ) >= sizeof( m_path ) )
+		{
+			printf( "-frametimes needs the path to write the frame time histograms to\n" );
+			exit( 1 );
+		}
+		strcpy( m_path, argv[ i + 1 ] );
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return;
+	}
+}
+
+void FrameTimes::Swapped( unsigned long long Now )
+{
+	if( m_lastswap )
+		Record( SWAP_INTERVAL, Now - m_lastswap );
+	m_lastswap = Now;
+}
+
+char const * FrameTimes::Name( Kind Which )
+{
+	static char const * const names[ KIND_COUNT ] = { "cpu", "sim", "interval" };
+	return names[ Which ];
+}
+
+void FrameTimes::DrawOverlay() const
+{
+	GLint viewport[ 4 ];
+	glGetIntegerv( GL_VIEWPORT, viewport );
+	glPushAttrib( GL_ENABLE_BIT | GL_CURRENT_BIT );
+	glDisable( GL_LIGHTING );
+	glDisable( GL_TEXTURE_2D );
+	glDisable( GL_DEPTH_TEST );
+	glDisable( GL_FOG );
+	glMatrixMode( GL_PROJECTION );
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho( 0.0, viewport[ 2 ], 0.0, viewport[ 3 ], -1.0, 1.0 );
+	glMatrixMode( GL_MODELVIEW );
+	glPushMatrix();
+	glLoadIdentity();
+
+	char line[ 128 ];
+	int const height = glutBitmapHeight( GLUT_BITMAP_8_BY_13 );
+	glColor3f( 1.f, 1.f, 0.f );
+	glutTextBatchBegin( GLUT_BITMAP_8_BY_13, 1.f );
+	for( int k = 0; k < KIND_COUNT; ++k )
+	{
+		Histogram const & histogram = m_histograms[ k ];
+		sprintf( line, "%-8s p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f ms", Name( (Kind)k ), histogram.Percentile( 50.0 ) * 1e-6,
+			histogram.Percentile( 95.0 ) * 1e-6, histogram.Percentile( 99.0 ) * 1e-6, histogram.Max() * 1e-6 );
+		glutTextBatchString( 8.f, (float)( viewport[ 3 ] - ( k + 1 ) * height - 4 ), 0.f, (unsigned char const *)line );
+	}
+	glutTextBatchEnd();
+
+	glPopMatrix();
+	glMatrixMode( GL_PROJECTION );
+	glPopMatrix();
+	glMatrixMode( GL_MODELVIEW );
+	glPopAttrib();
+}
+
+bool FrameTimes::Write() const
+{
+	FILE * const file = fopen( m_path, "w" );
+	if( !file )
+	{
+		fprintf( stderr, "could not write the frame times to %s\n", m_path );
+		return false;
+	}
+
+	//a summary line per histogram, then a line per bucket with anything in it, all in nanoseconds
+	for( int k = 0; k < KIND_COUNT; ++k )
+	{
+		Histogram const & histogram = m_histograms[ k ];
+		fprintf( file, "frametimes=%s count=%llu min=%llu p50=%llu p95=%llu p99=%llu max=%llu unit=ns\n", Name( (Kind)k ),
+			histogram.Count(), histogram.Min(), histogram.Percentile( 50.0 ), histogram.Percentile( 95.0 ),
+			histogram.Percentile( 99.0 ), histogram.Max() );
+	}
+	for( int k = 0; k < KIND_COUNT; ++k )
+	{
+		Histogram const & histogram = m_histograms[ k ];
+		for( int b = 0; b < Histogram::BUCKET_COUNT; ++b )
+		{
+			if( histogram.BucketCount( b ) )
+				fprintf( file, "frametimes=%s low=%llu high=%llu count=%llu\n", Name( (Kind)k ), Histogram::BucketLow( b ),
+					Histogram::BucketHigh( b ), histogram.BucketCount( b ) );
+		}
+	}
+	bool const written = !ferror( file );
+	fclose( file );
+	return written;
+}
@@ -0,0 +1,806 @@
+#define GLTRACE_REAL_CALLS //the hooks make the calls the trace macros stand for
+#include <glcapture.h>
+#include <gltrace.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool GLCapture::Capturing = false;
+FILE * GLCapture::s_file = NULL;
+std::vector< unsigned char > GLCapture::s_buffer;
+GLCapture::Header GLCapture::s_header;
+unsigned GLCapture::s_frames = 0;
+double GLCapture::s_calls = 0.0;
+double GLCapture::s_bytes = 0.0;
+unsigned GLCapture::s_skipped = 0;
+
+void GLCapture::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-capture" ) )
+			continue;
+
+		if( i + 2 >= argc || atoi( argv[ i + 2 ] ) <= 0 )
+		{
+			printf( "-capture needs a trace file and how many frames to capture after the setup\n" );
+			exit( 1 );
+		}
+#ifndef GL_TRACE
+		printf( "-capture needs a build with GL_TRACE defined\n" );
+		exit( 1 );
+#endif
+		s_file = fopen( argv[ i + 1 ], "wb" );
+		if( !s_file )
+		{
+			printf( "could not write the trace to \"%s\"\n", argv[ i + 1 ] );
+			exit( 1 );
+		}
+		memcpy( s_header.Magic, "GLCAPTUR", sizeof( s_header.Magic ) );
+		s_header.Version = VERSION;
+		s_header.Functions = GLTrace::FUNCTION_COUNT;
+		s_header.Frames = 0;
+		s_header.Width = s_header.Height = 0;
+		fwrite( &s_header, sizeof( s_header ), 1, s_file ); //rewritten on closing
+		s_frames = atoi( argv[ i + 2 ] );
+		Capturing = true;
+
+		for( int j = i + 3; j <= argc; ++j )
+			argv[ j - 3 ] = argv[ j ];
+		argc -= 3;
+		return;
+	}
+}
+
+void GLCapture::EndFrame()
+{
+	if( !Capturing )
+		return;
+
+	//the first frame with a viewport, which is usually the first
+	if( !s_header.Width )
+	{
+		GLint viewport[ 4 ];
+		glGetIntegerv( GL_VIEWPORT, viewport );
+		s_header.Width = viewport[ 2 ];
+		s_header.Height = viewport[ 3 ];
+	}
+	Put< unsigned char >( FRAME_END );
+	fwrite( &s_buffer[ 0 ], 1, s_buffer.size(), s_file );
+	s_buffer.clear();
+	if( ++s_header.Frames > s_frames )
+		Close();
+}
+
+void GLCapture::Close()
+{
+	if( !s_file )
+		return;
+
+	//a frame still open is left out
+	Capturing = false;
+	s_buffer.clear();
+	long const size = ftell( s_file );
+	rewind( s_file );
+	fwrite( &s_header, sizeof( s_header ), 1, s_file );
+	fclose( s_file );
+	s_file = NULL;
+
+	fprintf( stderr, "glcapture: %u frames (the first with the setup), %.0f calls, %.0f bytes of data, %ld bytes in all\n",
+		s_header.Frames, s_calls, s_bytes, size );
+	if( s_skipped )
+		fprintf( stderr, "glcapture: %u draws from client-side arrays were left out, the trace will not replay them\n", s_skipped );
+}
+
+int GLCapture::ParamCount( GLenum pname )
+{
+	switch( pname )
+	{
+	case GL_AMBIENT: case GL_DIFFUSE: case GL_SPECULAR: case GL_POSITION: case GL_EMISSION: case GL_AMBIENT_AND_DIFFUSE:
+	case GL_LIGHT_MODEL_AMBIENT: case GL_FOG_COLOR:
+		return 4;
+	case GL_SPOT_DIRECTION: case GL_COLOR_INDEXES:
+		return 3;
+	default:
+		return 1;
+	}
+}
+
+void GLCapture::Op( int Function )
+{
+	Put< unsigned char >( (unsigned char)Function );
+	s_calls += 1.0;
+}
+
+void GLCapture::PutArray( GLfloat const * Values, int Count )
+{
+	for( int u = 0; u < Count; ++u )
+		Put( Values[ u ] );
+}
+
+void GLCapture::PutPointer( GLvoid const * Pointer )
+{
+	Put< unsigned long long >( (size_t)Pointer );
+}
+
+void GLCapture::PutBlob( void const * Data, size_t Bytes )
+{
+	if( !Data )
+		Bytes = 0;
+	Put< unsigned long long >( Bytes );
+	s_buffer.insert( s_buffer.end(), (unsigned char const *)Data, (unsigned char const *)Data + Bytes );
+	s_bytes += (double)Bytes;
+}
+
+size_t GLCapture::ClientImageBytes( GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, bool Unpack )
+{
+	GLint alignment = 4, length = 0;
+	glGetIntegerv( Unpack ? GL_UNPACK_ALIGNMENT : GL_PACK_ALIGNMENT, &alignment );
+	glGetIntegerv( Unpack ? GL_UNPACK_ROW_LENGTH : GL_PACK_ROW_LENGTH, &length );
+	if( Width <= 0 || Height <= 0 )
+		return 0;
+
+	size_t const pixel = (size_t)GLTrace::ImageBytes( 1, 1, Format, Type );
+	size_t const row = ( ( length ? length : Width ) * pixel + alignment - 1 ) / alignment * alignment;
+	return row * ( Height - 1 ) + Width * pixel;
+}
+
+bool GLCapture::ClientArrays()
+{
+	static GLenum const arrays[ 4 ][ 3 ] =
+	{
+		{ GL_VERTEX_ARRAY, GL_VERTEX_ARRAY_BUFFER_BINDING, GL_VERTEX_ARRAY_POINTER },
+		{ GL_NORMAL_ARRAY, GL_NORMAL_ARRAY_BUFFER_BINDING, GL_NORMAL_ARRAY_POINTER },
+		{ GL_TEXTURE_COORD_ARRAY, GL_TEXTURE_COORD_ARRAY_BUFFER_BINDING, GL_TEXTURE_COORD_ARRAY_POINTER },
+		{ GL_COLOR_ARRAY, GL_COLOR_ARRAY_BUFFER_BINDING, GL_COLOR_ARRAY_POINTER }
+	};
+	for( int u = 0; u < 4; ++u )
+	{
+		GLint buffer = 0;
+		GLvoid * pointer = NULL;
+		if( !glIsEnabled( arrays[ u ][ 0 ] ) )
+			continue;
+		glGetIntegerv( arrays[ u ][ 1 ], &buffer );
+		glGetPointerv( arrays[ u ][ 2 ], &pointer );
+		//an enabled array with neither has nothing to read, so there is nothing to record and it replays the same way
+		if( !buffer && pointer )
+			return true;
+	}
+	return false;
+}
+
+void GLCapture::Begin( GLenum mode )
+{
+	Op( GLTrace::glBegin_CALL );
+	Put( mode );
+	glBegin( mode );
+}
+
+void GLCapture::End()
+{
+	Op( GLTrace::glEnd_CALL );
+	glEnd();
+}
+
+void GLCapture::Vertex3f( GLfloat x, GLfloat y, GLfloat z )
+{
+	Op( GLTrace::glVertex3f_CALL );
+	Put( x ); Put( y ); Put( z );
+	glVertex3f( x, y, z );
+}
+
+void GLCapture::Vertex3fv( GLfloat const * v )
+{
+	Op( GLTrace::glVertex3fv_CALL );
+	PutArray( v, 3 );
+	glVertex3fv( v );
+}
+
+void GLCapture::Normal3f( GLfloat nx, GLfloat ny, GLfloat nz )
+{
+	Op( GLTrace::glNormal3f_CALL );
+	Put( nx ); Put( ny ); Put( nz );
+	glNormal3f( nx, ny, nz );
+}
+
+void GLCapture::Normal3fv( GLfloat const * v )
+{
+	Op( GLTrace::glNormal3fv_CALL );
+	PutArray( v, 3 );
+	glNormal3fv( v );
+}
+
+void GLCapture::TexCoord2f( GLfloat s, GLfloat t )
+{
+	Op( GLTrace::glTexCoord2f_CALL );
+	Put( s ); Put( t );
+	glTexCoord2f( s, t );
+}
+
+void GLCapture::TexCoord2fv( GLfloat const * v )
+{
+	Op( GLTrace::glTexCoord2fv_CALL );
+	PutArray( v, 2 );
+	glTexCoord2fv( v );
+}
+
+void GLCapture::Color3f( GLfloat red, GLfloat green, GLfloat blue )
+{
+	Op( GLTrace::glColor3f_CALL );
+	Put( red ); Put( green ); Put( blue );
+	glColor3f( red, green, blue );
+}
+
+void GLCapture::Color3fv( GLfloat const * v )
+{
+	Op( GLTrace::glColor3fv_CALL );
+	PutArray( v, 3 );
+	glColor3fv( v );
+}
+
+void GLCapture::Color4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
+{
+	Op( GLTrace::glColor4f_CALL );
+	Put( red ); Put( green ); Put( blue ); Put( alpha );
+	glColor4f( red, green, blue, alpha );
+}
+
+void GLCapture::Color4fv( GLfloat const * v )
+{
+	Op( GLTrace::glColor4fv_CALL );
+	PutArray( v, 4 );
+	glColor4fv( v );
+}
+
+void GLCapture::MatrixMode( GLenum mode )
+{
+	Op( GLTrace::glMatrixMode_CALL );
+	Put( mode );
+	glMatrixMode( mode );
+}
+
+void GLCapture::LoadIdentity()
+{
+	Op( GLTrace::glLoadIdentity_CALL );
+	glLoadIdentity();
+}
+
+void GLCapture::LoadMatrixf( GLfloat const * m )
+{
+	Op( GLTrace::glLoadMatrixf_CALL );
+	PutArray( m, 16 );
+	glLoadMatrixf( m );
+}
+
+void GLCapture::MultMatrixf( GLfloat const * m )
+{
+	Op( GLTrace::glMultMatrixf_CALL );
+	PutArray( m, 16 );
+	glMultMatrixf( m );
+}
+
+void GLCapture::PushMatrix()
+{
+	Op( GLTrace::glPushMatrix_CALL );
+	glPushMatrix();
+}
+
+void GLCapture::PopMatrix()
+{
+	Op( GLTrace::glPopMatrix_CALL );
+	glPopMatrix();
+}
+
+void GLCapture::Translatef( GLfloat x, GLfloat y, GLfloat z )
+{
+	Op( GLTrace::glTranslatef_CALL );
+	Put( x ); Put( y ); Put( z );
+	glTranslatef( x, y, z );
+}
+
+void GLCapture::Rotatef( GLfloat angle, GLfloat x, GLfloat y, GLfloat z )
+{
+	Op( GLTrace::glRotatef_CALL );
+	Put( angle ); Put( x ); Put( y ); Put( z );
+	glRotatef( angle, x, y, z );
+}
+
+void GLCapture::Scalef( GLfloat x, GLfloat y, GLfloat z )
+{
+	Op( GLTrace::glScalef_CALL );
+	Put( x ); Put( y ); Put( z );
+	glScalef( x, y, z );
+}
+
+void GLCapture::Frustum( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar )
+{
+	Op( GLTrace::glFrustum_CALL );
+	Put( left ); Put( right ); Put( bottom ); Put( top ); Put( zNear ); Put( zFar );
+	glFrustum( left, right, bottom, top, zNear, zFar );
+}
+
+void GLCapture::Ortho( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar )
+{
+	Op( GLTrace::glOrtho_CALL );
+	Put( left ); Put( right ); Put( bottom ); Put( top ); Put( zNear ); Put( zFar );
+	glOrtho( left, right, bottom, top, zNear, zFar );
+}
+
+void GLCapture::LookAt( GLdouble eyeX, GLdouble eyeY, GLdouble eyeZ, GLdouble centerX, GLdouble centerY, GLdouble centerZ,
+	GLdouble upX, GLdouble upY, GLdouble upZ )
+{
+	Op( GLTrace::gluLookAt_CALL );
+	Put( eyeX ); Put( eyeY ); Put( eyeZ ); Put( centerX ); Put( centerY ); Put( centerZ );
+	Put( upX ); Put( upY ); Put( upZ );
+	gluLookAt( eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ );
+}
+
+void GLCapture::Perspective( GLdouble fovy, GLdouble aspect, GLdouble zNear, GLdouble zFar )
+{
+	Op( GLTrace::gluPerspective_CALL );
+	Put( fovy ); Put( aspect ); Put( zNear ); Put( zFar );
+	gluPerspective( fovy, aspect, zNear, zFar );
+}
+
+void GLCapture::Viewport( GLint x, GLint y, GLsizei width, GLsizei height )
+{
+	Op( GLTrace::glViewport_CALL );
+	Put( x ); Put( y ); Put( width ); Put( height );
+	glViewport( x, y, width, height );
+}
+
+void GLCapture::Enable( GLenum cap )
+{
+	Op( GLTrace::glEnable_CALL );
+	Put( cap );
+	glEnable( cap );
+}
+
+void GLCapture::Disable( GLenum cap )
+{
+	Op( GLTrace::glDisable_CALL );
+	Put( cap );
+	glDisable( cap );
+}
+
+void GLCapture::ShadeModel( GLenum mode )
+{
+	Op( GLTrace::glShadeModel_CALL );
+	Put( mode );
+	glShadeModel( mode );
+}
+
+void GLCapture::PolygonMode( GLenum face, GLenum mode )
+{
+	Op( GLTrace::glPolygonMode_CALL );
+	Put( face ); Put( mode );
+	glPolygonMode( face, mode );
+}
+
+void GLCapture::DepthFunc( GLenum func )
+{
+	Op( GLTrace::glDepthFunc_CALL );
+	Put( func );
+	glDepthFunc( func );
+}
+
+void GLCapture::BlendFunc( GLenum sfactor, GLenum dfactor )
+{
+	Op( GLTrace::glBlendFunc_CALL );
+	Put( sfactor ); Put( dfactor );
+	glBlendFunc( sfactor, dfactor );
+}
+
+void GLCapture::CullFace( GLenum mode )
+{
+	Op( GLTrace::glCullFace_CALL );
+	Put( mode );
+	glCullFace( mode );
+}
+
+void GLCapture::PushAttrib( GLbitfield mask )
+{
+	Op( GLTrace::glPushAttrib_CALL );
+	Put( mask );
+	glPushAttrib( mask );
+}
+
+void GLCapture::PopAttrib()
+{
+	Op( GLTrace::glPopAttrib_CALL );
+	glPopAttrib();
+}
+
+void GLCapture::PushClientAttrib( GLbitfield mask )
+{
+	Op( GLTrace::glPushClientAttrib_CALL );
+	Put( mask );
+	glPushClientAttrib( mask );
+}
+
+void GLCapture::PopClientAttrib()
+{
+	Op( GLTrace::glPopClientAttrib_CALL );
+	glPopClientAttrib();
+}
+
+void GLCapture::Lightf( GLenum light, GLenum pname, GLfloat param )
+{
+	Op( GLTrace::glLightf_CALL );
+	Put( light ); Put( pname ); Put( param );
+	glLightf( light, pname, param );
+}
+
+void GLCapture::Lightfv( GLenum light, GLenum pname, GLfloat const * params )
+{
+	Op( GLTrace::glLightfv_CALL );
+	Put( light ); Put( pname ); PutArray( params, ParamCount( pname ) );
+	glLightfv( light, pname, params );
+}
+
+void GLCapture::LightModelfv( GLenum pname, GLfloat const * params )
+{
+	Op( GLTrace::glLightModelfv_CALL );
+	Put( pname ); PutArray( params, ParamCount( pname ) );
+	glLightModelfv( pname, params );
+}
+
+void GLCapture::Materialf( GLenum face, GLenum pname, GLfloat param )
+{
+	Op( GLTrace::glMaterialf_CALL );
+	Put( face ); Put( pname ); Put( param );
+	glMaterialf( face, pname, param );
+}
+
+void GLCapture::Materialfv( GLenum face, GLenum pname, GLfloat const * params )
+{
+	Op( GLTrace::glMaterialfv_CALL );
+	Put( face ); Put( pname ); PutArray( params, ParamCount( pname ) );
+	glMaterialfv( face, pname, params );
+}
+
+void GLCapture::ColorMaterial( GLenum face, GLenum mode )
+{
+	Op( GLTrace::glColorMaterial_CALL );
+	Put( face ); Put( mode );
+	glColorMaterial( face, mode );
+}
+
+void GLCapture::Fogi( GLenum pname, GLint param )
+{
+	Op( GLTrace::glFogi_CALL );
+	Put( pname ); Put( param );
+	glFogi( pname, param );
+}
+
+void GLCapture::Fogf( GLenum pname, GLfloat param )
+{
+	Op( GLTrace::glFogf_CALL );
+	Put( pname ); Put( param );
+	glFogf( pname, param );
+}
+
+void GLCapture::Fogfv( GLenum pname, GLfloat const * params )
+{
+	Op( GLTrace::glFogfv_CALL );
+	Put( pname ); PutArray( params, ParamCount( pname ) );
+	glFogfv( pname, params );
+}
+
+void GLCapture::ClearColor( GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha )
+{
+	Op( GLTrace::glClearColor_CALL );
+	Put( red ); Put( green ); Put( blue ); Put( alpha );
+	glClearColor( red, green, blue, alpha );
+}
+
+void GLCapture::Clear( GLbitfield mask )
+{
+	Op( GLTrace::glClear_CALL );
+	Put( mask );
+	glClear( mask );
+}
+
+void GLCapture::Flush()
+{
+	Op( GLTrace::glFlush_CALL );
+	glFlush();
+}
+
+void GLCapture::Finish()
+{
+	Op( GLTrace::glFinish_CALL );
+	glFinish();
+}
+
+void GLCapture::NewList( GLuint list, GLenum mode )
+{
+	Op( GLTrace::glNewList_CALL );
+	Put( list ); Put( mode );
+	glNewList( list, mode );
+}
+
+void GLCapture::EndList()
+{
+	Op( GLTrace::glEndList_CALL );
+	glEndList();
+}
+
+void GLCapture::CallList( GLuint list )
+{
+	Op( GLTrace::glCallList_CALL );
+	Put( list );
+	glCallList( list );
+}
+
+void GLCapture::BindTexture( GLenum target, GLuint texture )
+{
+	Op( GLTrace::glBindTexture_CALL );
+	Put( target ); Put( texture );
+	glBindTexture( target, texture );
+}
+
+void GLCapture::TexParameteri( GLenum target, GLenum pname, GLint param )
+{
+	Op( GLTrace::glTexParameteri_CALL );
+	Put( target ); Put( pname ); Put( param );
+	glTexParameteri( target, pname, param );
+}
+
+void GLCapture::TexParameterf( GLenum target, GLenum pname, GLfloat param )
+{
+	Op( GLTrace::glTexParameterf_CALL );
+	Put( target ); Put( pname ); Put( param );
+	glTexParameterf( target, pname, param );
+}
+
+void GLCapture::TexEnvf( GLenum target, GLenum pname, GLfloat param )
+{
+	Op( GLTrace::glTexEnvf_CALL );
+	Put( target ); Put( pname ); Put( param );
+	glTexEnvf( target, pname, param );
+}
+
+void GLCapture::PixelStorei( GLenum pname, GLint param )
+{
+	Op( GLTrace::glPixelStorei_CALL );
+	Put( pname ); Put( param );
+	glPixelStorei( pname, param );
+}
+
+void GLCapture::EnableClientState( GLenum array )
+{
+	Op( GLTrace::glEnableClientState_CALL );
+	Put( array );
+	glEnableClientState( array );
+}
+
+void GLCapture::DisableClientState( GLenum array )
+{
+	Op( GLTrace::glDisableClientState_CALL );
+	Put( array );
+	glDisableClientState( array );
+}
+
+void GLCapture::VertexPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer )
+{
+	Op( GLTrace::glVertexPointer_CALL );
+	Put( size ); Put( type ); Put( stride ); PutPointer( pointer );
+	glVertexPointer( size, type, stride, pointer );
+}
+
+void GLCapture::NormalPointer( GLenum type, GLsizei stride, GLvoid const * pointer )
+{
+	Op( GLTrace::glNormalPointer_CALL );
+	Put( type ); Put( stride ); PutPointer( pointer );
+	glNormalPointer( type, stride, pointer );
+}
+
+void GLCapture::TexCoordPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer )
+{
+	Op( GLTrace::glTexCoordPointer_CALL );
+	Put( size ); Put( type ); Put( stride ); PutPointer( pointer );
+	glTexCoordPointer( size, type, stride, pointer );
+}
+
+void GLCapture::ColorPointer( GLint size, GLenum type, GLsizei stride, GLvoid const * pointer )
+{
+	Op( GLTrace::glColorPointer_CALL );
+	Put( size ); Put( type ); Put( stride ); PutPointer( pointer );
+	glColorPointer( size, type, stride, pointer );
+}
+
+void GLCapture::ActiveTexture( GLenum texture )
+{
+	Op( GLTrace::glActiveTexture_CALL );
+	Put( texture );
+	glActiveTexture( texture );
+}
+
+void GLCapture::ClientActiveTexture( GLenum texture )
+{
+	Op( GLTrace::glClientActiveTexture_CALL );
+	Put( texture );
+	glClientActiveTexture( texture );
+}
+
+void GLCapture::BindBuffer( GLenum target, GLuint buffer )
+{
+	Op( GLTrace::glBindBuffer_CALL );
+	Put( target ); Put( buffer );
+	glBindBuffer( target, buffer );
+}
+
+GLvoid * GLCapture::MapBuffer( GLenum target, GLenum access )
+{
+	Op( GLTrace::glMapBuffer_CALL );
+	Put( target ); Put( access );
+	return glMapBuffer( target, access );
+}
+
+GLboolean GLCapture::UnmapBuffer( GLenum target )
+{
+	Op( GLTrace::glUnmapBuffer_CALL );
+	Put( target );
+	return glUnmapBuffer( target );
+}
+
+GLuint GLCapture::GenLists( GLsizei range )
+{
+	GLuint const list = glGenLists( range );
+	Op( GLTrace::glGenLists_CALL );
+	Put( range ); Put( list );
+	return list;
+}
+
+void GLCapture::DeleteLists( GLuint list, GLsizei range )
+{
+	Op( GLTrace::glDeleteLists_CALL );
+	Put( list ); Put( range );
+	glDeleteLists( list, range );
+}
+
+void GLCapture::GenTextures( GLsizei n, GLuint * textures )
+{
+	glGenTextures( n, textures );
+	Op( GLTrace::glGenTextures_CALL );
+	Put( n );
+	for( GLsizei u = 0; u < n; ++u )
+		Put( textures[ u ] );
+}
+
+void GLCapture::DeleteTextures( GLsizei n, GLuint const * textures )
+{
+	Op( GLTrace::glDeleteTextures_CALL );
+	Put( n );
+	for( GLsizei u = 0; u < n; ++u )
+		Put( textures[ u ] );
+	glDeleteTextures( n, textures );
+}
+
+void GLCapture::TexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border,
+	GLenum format, GLenum type, GLvoid const * pixels )
+{
+	Op( GLTrace::glTexImage2D_CALL );
+	Put( target ); Put( level ); Put( internalformat ); Put( width ); Put( height ); Put( border ); Put( format ); Put( type );
+	PutBlob( pixels, ClientImageBytes( width, height, format, type, true ) );
+	glTexImage2D( target, level, internalformat, width, height, border, format, type, pixels );
+}
+
+void GLCapture::TexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, GLvoid const * pixels )
+{
+	Op( GLTrace::glTexSubImage2D_CALL );
+	Put( target ); Put( level ); Put( xoffset ); Put( yoffset ); Put( width ); Put( height ); Put( format ); Put( type );
+	PutBlob( pixels, ClientImageBytes( width, height, format, type, true ) );
+	glTexSubImage2D( target, level, xoffset, yoffset, width, height, format, type, pixels );
+}
+
+GLint GLCapture::Build2DMipmaps( GLenum target, GLint components, GLint width, GLint height, GLenum format, GLenum type,
+	void const * data )
+{
+	Op( GLTrace::gluBuild2DMipmaps_CALL );
+	Put( target ); Put( components ); Put( width ); Put( height ); Put( format ); Put( type );
+	PutBlob( data, ClientImageBytes( width, height, format, type, true ) );
+	return gluBuild2DMipmaps( target, components, width, height, format, type, data );
+}
+
+void GLCapture::ReadPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid * pixels )
+{
+	GLint buffer = 0;
+	glGetIntegerv( GL_PIXEL_PACK_BUFFER_BINDING, &buffer );
+	Op( GLTrace::glReadPixels_CALL );
+	Put( x ); Put( y ); Put( width ); Put( height ); Put( format ); Put( type );
+	//into a buffer at an offset, or into client memory of this size
+	Put< unsigned char >( buffer != 0 );
+	if( buffer )
+		PutPointer( pixels );
+	else
+		Put< unsigned long long >( ClientImageBytes( width, height, format, type, false ) );
+	glReadPixels( x, y, width, height, format, type, pixels );
+}
+
+void GLCapture::DrawArrays( GLenum mode, GLint first, GLsizei count )
+{
+	if( ClientArrays() )
+		++s_skipped;
+	else
+	{
+		Op( GLTrace::glDrawArrays_CALL );
+		Put( mode ); Put( first ); Put( count );
+	}
+	glDrawArrays( mode, first, count );
+}
+
+void GLCapture::DrawElements( GLenum mode, GLsizei count, GLenum type, GLvoid const * indices )
+{
+	GLint buffer = 0;
+	if( ClientArrays() )
+		++s_skipped;
+	else
+	{
+		glGetIntegerv( GL_ELEMENT_ARRAY_BUFFER_BINDING, &buffer );
+		Op( GLTrace::glDrawElements_CALL );
+		Put( mode ); Put( count ); Put( type );
+		//an offset into the bound index buffer, or the indices themselves
+		Put< unsigned char >( buffer != 0 );
+		if( buffer )
+			PutPointer( indices );
+		else
+			PutBlob( indices, count * (size_t)GLTrace::ImageBytes( 1, 1, GL_RED, type ) );
+	}
+	glDrawElements( mode, count, type, indices );
+}
+
+void GLCapture::DrawRangeElements( GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, GLvoid const * indices )
+{
+	GLint buffer = 0;
+	if( ClientArrays() )
+		++s_skipped;
+	else
+	{
+		glGetIntegerv( GL_ELEMENT_ARRAY_BUFFER_BINDING, &buffer );
+		Op( GLTrace::glDrawRangeElements_CALL );
+		Put( mode ); Put( start ); Put( end ); Put( count ); Put( type );
+		Put< unsigned char >( buffer != 0 );
+		if( buffer )
+			PutPointer( indices );
+		else
+			PutBlob( indices, count * (size_t)GLTrace::ImageBytes( 1, 1, GL_RED, type ) );
+	}
+	glDrawRangeElements( mode, start, end, count, type, indices );
+}
+
+void GLCapture::GenBuffers( GLsizei n, GLuint * buffers )
+{
+	glGenBuffers( n, buffers );
+	Op( GLTrace::glGenBuffers_CALL );
+	Put( n );
+	for( GLsizei u = 0; u < n; ++u )
+		Put( buffers[ u ] );
+}
+
+void GLCapture::DeleteBuffers( GLsizei n, GLuint const * buffers )
+{
+	Op( GLTrace::glDeleteBuffers_CALL );
+	Put( n );
+	for( GLsizei u = 0; u < n; ++u )
+		Put( buffers[ u ] );
+	glDeleteBuffers( n, buffers );
+}
+
+void GLCapture::BufferData( GLenum target, GLsizeiptr size, GLvoid const * data, GLenum usage )
+{
+	Op( GLTrace::glBufferData_CALL );
+	Put( target ); Put< unsigned long long >( size );
+	PutBlob( data, size );
+	Put( usage );
+	glBufferData( target, size, data, usage );
+}
+
+void GLCapture::BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, GLvoid const * data )
+{
+	Op( GLTrace::glBufferSubData_CALL );
+	Put( target ); Put< unsigned long long >( offset );
+	PutBlob( data, size );
+	glBufferSubData( target, offset, size, data );
+}
@@ -0,0 +1,813 @@
+#define GLTRACE_REAL_CALLS //the replay's own calls are what is being measured
+#include <glreplay.h>
+#include <gltrace.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	void Report( char const * Case, char const * Metric, double Value, char const * Unit )
+	{
+		printf( "replay case=%s %s=%g %s\n", Case, Metric, Value, Unit );
+	}
+	double Now()
+	{
+		return glutGetElapsedTimeNs() * 1e-9;
+	}
+}
+
+GLReplay * GLReplay::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-replay" ) )
+			continue;
+
+		if( i + 2 >= argc || atoi( argv[ i + 2 ] ) <= 0 )
+		{
+			printf( "-replay needs a trace from -capture and how many times to replay its frames\n" );
+			exit( 1 );
+		}
+		char const * const path = argv[ i + 1 ];
+		FILE * file = fopen( path, "rb" );
+		if( !file )
+		{
+			printf( "could not read the trace \"%s\"\n", path );
+			exit( 1 );
+		}
+		GLReplay * replay = new GLReplay( atoi( argv[ i + 2 ] ) );
+		bool read = fread( &replay->m_header, sizeof( replay->m_header ), 1, file ) == 1;
+		if( read )
+		{
+			long const start = ftell( file );
+			fseek( file, 0, SEEK_END );
+			long const size = ftell( file ) - start;
+			fseek( file, start, SEEK_SET );
+			replay->m_trace.resize( size > 0 ? size : 0 );
+			read = size > 0 && fread( &replay->m_trace[ 0 ], 1, size, file ) == (size_t)size;
+		}
+		fclose( file );
+		GLCapture::Header const & header = replay->m_header;
+		if( !read || memcmp( header.Magic, "GLCAPTUR", sizeof( header.Magic ) ) || header.Frames < 2 || header.Width <= 0 || header.Height <= 0 )
+		{
+			printf( "\"%s\" is not a whole trace\n", path );
+			exit( 1 );
+		}
+		if( header.Version != GLCapture::VERSION || header.Functions != GLTrace::FUNCTION_COUNT )
+		{
+			printf( "\"%s\" was captured by a build with other opcodes\n", path );
+			exit( 1 );
+		}
+
+		for( int j = i + 3; j <= argc; ++j )
+			argv[ j - 3 ] = argv[ j ];
+		argc -= 3;
+		return replay;
+	}
+	return NULL;
+}
+
+GLReplay::GLReplay( unsigned Passes ) : m_cursor( 0 ), m_passes( Passes ), m_corrupt( false )
+{
+	memset( &m_header, 0, sizeof( m_header ) );
+}
+
+bool GLReplay::Run()
+{
+	double const start = Now();
+	unsigned const setupcalls = Frame();
+	glFinish();
+	double const setup = Now() - start;
+
+	size_t const first = m_cursor;
+	double submit = 0.0, total = 0.0, calls = 0.0;
+	unsigned frames = 0;
+	for( unsigned pass = 0; pass < m_passes && !m_corrupt; ++pass )
+	{
+		m_cursor = first;
+		for( unsigned frame = 1; frame < m_header.Frames && !m_corrupt; ++frame )
+		{
+			double const begin = Now();
+			calls += Frame();
+			double const issued = Now();
+			glFinish();
+			double const end = Now();
+			glutSwapBuffers();
+			submit += issued - begin;
+			total += end - begin;
+			++frames;
+		}
+	}
+	if( m_corrupt )
+	{
+		printf( "the trace ends in the middle of a call or has an unknown opcode\n" );
+		return false;
+	}
+
+	Report( "setup", "calls", setupcalls, "" );
+	Report( "setup", "ms", setup * 1000.0, "ms" );
+	Report( "frames", "frames", frames, "" );
+	Report( "frames", "calls", calls / frames, "" );
+	Report( "frames", "submit_ms", submit * 1000.0 / frames, "ms" );
+	Report( "frames", "frame_ms", total * 1000.0 / frames, "ms" );
+	Report( "frames", "fps", frames / total, "fps" );
+	return true;
+}
+
+void GLReplay::GetArray( GLfloat * Values, int Count )
+{
+	for( int u = 0; u < Count; ++u )
+		Values[ u ] = Get< GLfloat >();
+}
+
+GLvoid const * GLReplay::GetPointer()
+{
+	return (GLvoid const *)(size_t)Get< unsigned long long >();
+}
+
+GLvoid const * GLReplay::GetBlob( size_t * Bytes )
+{
+	unsigned long long const bytes = Get< unsigned long long >();
+	if( m_corrupt || bytes > m_trace.size() - m_cursor )
+	{
+		m_corrupt = true;
+		return NULL;
+	}
+	GLvoid const * const data = bytes ? &m_trace[ m_cursor ] : NULL;
+	m_cursor += (size_t)bytes;
+	if( Bytes )
+		*Bytes = (size_t)bytes;
+	return data;
+}
+
+GLuint GLReplay::Translate( std::map< GLuint, GLuint > const & Names, GLuint Name )
+{
+	std::map< GLuint, GLuint >::const_iterator found = Names.find( Name );
+	return found == Names.end() ? Name : found->second;
+}
+
+void GLReplay::Generated( std::map< GLuint, GLuint > & Names, std::vector< GLuint > const & Recorded, std::vector< GLuint > const & Made )
+{
+	for( size_t u = 0; u < Recorded.size(); ++u )
+		Names[ Recorded[ u ] ] = Made[ u ];
+}
+
+unsigned GLReplay::Frame()
+{
+	for( unsigned calls = 0; ; ++calls )
+	{
+		unsigned char const opcode = Get< unsigned char >();
+		if( m_corrupt )
+			return calls;
+		switch( opcode )
+		{
+		case GLCapture::FRAME_END:
+			return calls;
+		case GLTrace::glBegin_CALL:
+		{
+			GLenum const mode = Get< GLenum >();
+			glBegin( mode );
+			break;
+		}
+		case GLTrace::glEnd_CALL:
+			glEnd();
+			break;
+		case GLTrace::glVertex3f_CALL:
+		{
+			GLfloat const x = Get< GLfloat >();
+			GLfloat const y = Get< GLfloat >();
+			GLfloat const z = Get< GLfloat >();
+			glVertex3f( x, y, z );
+			break;
+		}
+		case GLTrace::glVertex3fv_CALL:
+		{
+			GLfloat v[ 3 ];
+			GetArray( v, 3 );
+			glVertex3fv( v );
+			break;
+		}
+		case GLTrace::glNormal3f_CALL:
+		{
+			GLfloat const nx = Get< GLfloat >();
+			GLfloat const ny = Get< GLfloat >();
+			GLfloat const nz = Get< GLfloat >();
+			glNormal3f( nx, ny, nz );
+			break;
+		}
+		case GLTrace::glNormal3fv_CALL:
+		{
+			GLfloat v[ 3 ];
+			GetArray( v, 3 );
+			glNormal3fv( v );
+			break;
+		}
+		case GLTrace::glTexCoord2f_CALL:
+		{
+			GLfloat const s = Get< GLfloat >();
+			GLfloat const t = Get< GLfloat >();
+			glTexCoord2f( s, t );
+			break;
+		}
+		case GLTrace::glTexCoord2fv_CALL:
+		{
+			GLfloat v[ 2 ];
+			GetArray( v, 2 );
+			glTexCoord2fv( v );
+			break;
+		}
+		case GLTrace::glColor3f_CALL:
+		{
+			GLfloat const red = Get< GLfloat >();
+			GLfloat const green = Get< GLfloat >();
+			GLfloat const blue = Get< GLfloat >();
+			glColor3f( red, green, blue );
+			break;
+		}
+		case GLTrace::glColor3fv_CALL:
+		{
+			GLfloat v[ 3 ];
+			GetArray( v, 3 );
+			glColor3fv( v );
+			break;
+		}
+		case GLTrace::glColor4f_CALL:
+		{
+			GLfloat const red = Get< GLfloat >();
+			GLfloat const green = Get< GLfloat >();
+			GLfloat const blue = Get< GLfloat >();
+			GLfloat const alpha = Get< GLfloat >();
+			glColor4f( red, green, blue, alpha );
+			break;
+		}
+		case GLTrace::glColor4fv_CALL:
+		{
+			GLfloat v[ 4 ];
+			GetArray( v, 4 );
+			glColor4fv( v );
+			break;
+		}
+		case GLTrace::glMatrixMode_CALL:
+		{
+			GLenum const mode = Get< GLenum >();
+			glMatrixMode( mode );
+			break;
+		}
+		case GLTrace::glLoadIdentity_CALL:
+			glLoadIdentity();
+			break;
+		case GLTrace::glLoadMatrixf_CALL:
+		{
+			GLfloat m[ 16 ];
+			GetArray( m, 16 );
+			glLoadMatrixf( m );
+			break;
+		}
+		case GLTrace::glMultMatrixf_CALL:
+		{
+			GLfloat m[ 16 ];
+			GetArray( m, 16 );
+			glMultMatrixf( m );
+			break;
+		}
+		case GLTrace::glPushMatrix_CALL:
+			glPushMatrix();
+			break;
+		case GLTrace::glPopMatrix_CALL:
+			glPopMatrix();
+			break;
+		case GLTrace::glTranslatef_CALL:
+		{
+			GLfloat const x = Get< GLfloat >();
+			GLfloat const y = Get< GLfloat >();
+			GLfloat const z = Get< GLfloat >();
+			glTranslatef( x, y, z );
+			break;
+		}
+		case GLTrace::glRotatef_CALL:
+		{
+			GLfloat const angle = Get< GLfloat >();
+			GLfloat const x = Get< GLfloat >();
+			GLfloat const y = Get< GLfloat >();
+			GLfloat const z = Get< GLfloat >();
+			glRotatef( angle, x, y, z );
+			break;
+		}
+		case GLTrace::glScalef_CALL:
+		{
+			GLfloat const x = Get< GLfloat >();
+			GLfloat const y = Get< GLfloat >();
+			GLfloat const z = Get< GLfloat >();
+			glScalef( x, y, z );
+			break;
+		}
+		case GLTrace::glFrustum_CALL:
+		{
+			GLdouble const left = Get< GLdouble >();
+			GLdouble const right = Get< GLdouble >();
+			GLdouble const bottom = Get< GLdouble >();
+			GLdouble const top = Get< GLdouble >();
+			GLdouble const zNear = Get< GLdouble >();
+			GLdouble const zFar = Get< GLdouble >();
+			glFrustum( left, right, bottom, top, zNear, zFar );
+			break;
+		}
+		case GLTrace::glOrtho_CALL:
+		{
+			GLdouble const left = Get< GLdouble >();
+			GLdouble const right = Get< GLdouble >();
+			GLdouble const bottom = Get< GLdouble >();
+			GLdouble const top = Get< GLdouble >();
+			GLdouble const zNear = Get< GLdouble >();
+			GLdouble const zFar = Get< GLdouble >();
+			glOrtho( left, right, bottom, top, zNear, zFar );
+			break;
+		}
+		case GLTrace::gluLookAt_CALL:
+		{
+			GLdouble const eyeX = Get< GLdouble >();
+			GLdouble const eyeY = Get< GLdouble >();
+			GLdouble const eyeZ = Get< GLdouble >();
+			GLdouble const centerX = Get< GLdouble >();
+			GLdouble const centerY = Get< GLdouble >();
+			GLdouble const centerZ = Get< GLdouble >();
+			GLdouble const upX = Get< GLdouble >();
+			GLdouble const upY = Get< GLdouble >();
+			GLdouble const upZ = Get< GLdouble >();
+			gluLookAt( eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ );
+			break;
+		}
+		case GLTrace::gluPerspective_CALL:
+		{
+			GLdouble const fovy = Get< GLdouble >();
+			GLdouble const aspect = Get< GLdouble >();
+			GLdouble const zNear = Get< GLdouble >();
+			GLdouble const zFar = Get< GLdouble >();
+			gluPerspective( fovy, aspect, zNear, zFar );
+			break;
+		}
+		case GLTrace::glViewport_CALL:
+		{
+			GLint const x = Get< GLint >();
+			GLint const y = Get< GLint >();
+			GLsizei const width = Get< GLsizei >();
+			GLsizei const height = Get< GLsizei >();
+			glViewport( x, y, width, height );
+			break;
+		}
+		case GLTrace::glEnable_CALL:
+		{
+			GLenum const cap = Get< GLenum >();
+			glEnable( cap );
+			break;
+		}
+		case GLTrace::glDisable_CALL:
+		{
+			GLenum const cap = Get< GLenum >();
+			glDisable( cap );
+			break;
+		}
+		case GLTrace::glShadeModel_CALL:
+		{
+			GLenum const mode = Get< GLenum >();
+			glShadeModel( mode );
+			break;
+		}
+		case GLTrace::glPolygonMode_CALL:
+		{
+			GLenum const face = Get< GLenum >();
+			GLenum const mode = Get< GLenum >();
+			glPolygonMode( face, mode );
+			break;
+		}
+		case GLTrace::glDepthFunc_CALL:
+		{
+			GLenum const func = Get< GLenum >();
+			glDepthFunc( func );
+			break;
+		}
+		case GLTrace::glBlendFunc_CALL:
+		{
+			GLenum const sfactor = Get< GLenum >();
+			GLenum const dfactor = Get< GLenum >();
+			glBlendFunc( sfactor, dfactor );
+			break;
+		}
+		case GLTrace::glCullFace_CALL:
+		{
+			GLenum const mode = Get< GLenum >();
+			glCullFace( mode );
+			break;
+		}
+		case GLTrace::glPushAttrib_CALL:
+		{
+			GLbitfield const mask = Get< GLbitfield >();
+			glPushAttrib( mask );
+			break;
+		}
+		case GLTrace::glPopAttrib_CALL:
+			glPopAttrib();
+			break;
+		case GLTrace::glPushClientAttrib_CALL:
+		{
+			GLbitfield const mask = Get< GLbitfield >();
+			glPushClientAttrib( mask );
+			break;
+		}
+		case GLTrace::glPopClientAttrib_CALL:
+			glPopClientAttrib();
+			break;
+		case GLTrace::glLightf_CALL:
+		{
+			GLenum const light = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat const param = Get< GLfloat >();
+			glLightf( light, pname, param );
+			break;
+		}
+		case GLTrace::glLightfv_CALL:
+		{
+			GLenum const light = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat params[ 4 ];
+			GetArray( params, GLCapture::ParamCount( pname ) );
+			glLightfv( light, pname, params );
+			break;
+		}
+		case GLTrace::glLightModelfv_CALL:
+		{
+			GLenum const pname = Get< GLenum >();
+			GLfloat params[ 4 ];
+			GetArray( params, GLCapture::ParamCount( pname ) );
+			glLightModelfv( pname, params );
+			break;
+		}
+		case GLTrace::glMaterialf_CALL:
+		{
+			GLenum const face = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat const param = Get< GLfloat >();
+			glMaterialf( face, pname, param );
+			break;
+		}
+		case GLTrace::glMaterialfv_CALL:
+		{
+			GLenum const face = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat params[ 4 ];
+			GetArray( params, GLCapture::ParamCount( pname ) );
+			glMaterialfv( face, pname, params );
+			break;
+		}
+		case GLTrace::glColorMaterial_CALL:
+		{
+			GLenum const face = Get< GLenum >();
+			GLenum const mode = Get< GLenum >();
+			glColorMaterial( face, mode );
+			break;
+		}
+		case GLTrace::glFogi_CALL:
+		{
+			GLenum const pname = Get< GLenum >();
+			GLint const param = Get< GLint >();
+			glFogi( pname, param );
+			break;
+		}
+		case GLTrace::glFogf_CALL:
+		{
+			GLenum const pname = Get< GLenum >();
+			GLfloat const param = Get< GLfloat >();
+			glFogf( pname, param );
+			break;
+		}
+		case GLTrace::glFogfv_CALL:
+		{
+			GLenum const pname = Get< GLenum >();
+			GLfloat params[ 4 ];
+			GetArray( params, GLCapture::ParamCount( pname ) );
+			glFogfv( pname, params );
+			break;
+		}
+		case GLTrace::glClearColor_CALL:
+		{
+			GLclampf const red = Get< GLclampf >();
+			GLclampf const green = Get< GLclampf >();
+			GLclampf const blue = Get< GLclampf >();
+			GLclampf const alpha = Get< GLclampf >();
+			glClearColor( red, green, blue, alpha );
+			break;
+		}
+		case GLTrace::glClear_CALL:
+		{
+			GLbitfield const mask = Get< GLbitfield >();
+			glClear( mask );
+			break;
+		}
+		case GLTrace::glFlush_CALL:
+			glFlush();
+			break;
+		case GLTrace::glFinish_CALL:
+			glFinish();
+			break;
+		case GLTrace::glNewList_CALL:
+		{
+			GLuint const list = Translate( m_lists, Get< GLuint >() );
+			GLenum const mode = Get< GLenum >();
+			glNewList( list, mode );
+			break;
+		}
+		case GLTrace::glEndList_CALL:
+			glEndList();
+			break;
+		case GLTrace::glCallList_CALL:
+		{
+			GLuint const list = Translate( m_lists, Get< GLuint >() );
+			glCallList( list );
+			break;
+		}
+		case GLTrace::glBindTexture_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLuint const texture = Translate( m_textures, Get< GLuint >() );
+			glBindTexture( target, texture );
+			break;
+		}
+		case GLTrace::glTexParameteri_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLint const param = Get< GLint >();
+			glTexParameteri( target, pname, param );
+			break;
+		}
+		case GLTrace::glTexParameterf_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat const param = Get< GLfloat >();
+			glTexParameterf( target, pname, param );
+			break;
+		}
+		case GLTrace::glTexEnvf_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLenum const pname = Get< GLenum >();
+			GLfloat const param = Get< GLfloat >();
+			glTexEnvf( target, pname, param );
+			break;
+		}
+		case GLTrace::glPixelStorei_CALL:
+		{
+			GLenum const pname = Get< GLenum >();
+			GLint const param = Get< GLint >();
+			glPixelStorei( pname, param );
+			break;
+		}
+		case GLTrace::glEnableClientState_CALL:
+		{
+			GLenum const array = Get< GLenum >();
+			glEnableClientState( array );
+			break;
+		}
+		case GLTrace::glDisableClientState_CALL:
+		{
+			GLenum const array = Get< GLenum >();
+			glDisableClientState( array );
+			break;
+		}
+		case GLTrace::glVertexPointer_CALL:
+		{
+			GLint const size = Get< GLint >();
+			GLenum const type = Get< GLenum >();
+			GLsizei const stride = Get< GLsizei >();
+			GLvoid const * const pointer = GetPointer();
+			glVertexPointer( size, type, stride, pointer );
+			break;
+		}
+		case GLTrace::glNormalPointer_CALL:
+		{
+			GLenum const type = Get< GLenum >();
+			GLsizei const stride = Get< GLsizei >();
+			GLvoid const * const pointer = GetPointer();
+			glNormalPointer( type, stride, pointer );
+			break;
+		}
+		case GLTrace::glTexCoordPointer_CALL:
+		{
+			GLint const size = Get< GLint >();
+			GLenum const type = Get< GLenum >();
+			GLsizei const stride = Get< GLsizei >();
+			GLvoid const * const pointer = GetPointer();
+			glTexCoordPointer( size, type, stride, pointer );
+			break;
+		}
+		case GLTrace::glColorPointer_CALL:
+		{
+			GLint const size = Get< GLint >();
+			GLenum const type = Get< GLenum >();
+			GLsizei const stride = Get< GLsizei >();
+			GLvoid const * const pointer = GetPointer();
+			glColorPointer( size, type, stride, pointer );
+			break;
+		}
+		case GLTrace::glActiveTexture_CALL:
+		{
+			GLenum const texture = Get< GLenum >();
+			glActiveTexture( texture );
+			break;
+		}
+		case GLTrace::glClientActiveTexture_CALL:
+		{
+			GLenum const texture = Get< GLenum >();
+			glClientActiveTexture( texture );
+			break;
+		}
+		case GLTrace::glBindBuffer_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLuint const buffer = Translate( m_buffers, Get< GLuint >() );
+			glBindBuffer( target, buffer );
+			break;
+		}
+		case GLTrace::glMapBuffer_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLenum const access = Get< GLenum >();
+			glMapBuffer( target, access );
+			break;
+		}
+		case GLTrace::glUnmapBuffer_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			glUnmapBuffer( target );
+			break;
+		}
+		case GLTrace::glGenLists_CALL:
+		{
+			GLsizei const range = Get< GLsizei >();
+			GLuint const list = Get< GLuint >();
+			GLuint const made = glGenLists( range );
+			for( GLsizei u = 0; u < range; ++u )
+				m_lists[ list + u ] = made + u;
+			break;
+		}
+		case GLTrace::glDeleteLists_CALL:
+		{
+			GLuint const list = Get< GLuint >();
+			GLsizei const range = Get< GLsizei >();
+			for( GLsizei u = 0; u < range; ++u )
+				glDeleteLists( Translate( m_lists, list + u ), 1 );
+			break;
+		}
+		case GLTrace::glGenTextures_CALL:
+		case GLTrace::glGenBuffers_CALL:
+		{
+			GLsizei const n = Get< GLsizei >();
+			std::vector< GLuint > recorded( n > 0 ? n : 0 ), made( recorded.size() );
+			for( GLsizei u = 0; u < n; ++u )
+				recorded[ u ] = Get< GLuint >();
+			if( n <= 0 || m_corrupt )
+				break;
+			if( opcode == GLTrace::glGenTextures_CALL )
+			{
+				glGenTextures( n, &made[ 0 ] );
+				Generated( m_textures, recorded, made );
+			}
+			else
+			{
+				glGenBuffers( n, &made[ 0 ] );
+				Generated( m_buffers, recorded, made );
+			}
+			break;
+		}
+		case GLTrace::glDeleteTextures_CALL:
+		case GLTrace::glDeleteBuffers_CALL:
+		{
+			bool const textures = opcode == GLTrace::glDeleteTextures_CALL;
+			GLsizei const n = Get< GLsizei >();
+			std::vector< GLuint > names( n > 0 ? n : 0 );
+			for( GLsizei u = 0; u < n; ++u )
+				names[ u ] = Translate( textures ? m_textures : m_buffers, Get< GLuint >() );
+			if( n <= 0 || m_corrupt )
+				break;
+			if( textures )
+				glDeleteTextures( n, &names[ 0 ] );
+			else
+				glDeleteBuffers( n, &names[ 0 ] );
+			break;
+		}
+		case GLTrace::glTexImage2D_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLint const level = Get< GLint >();
+			GLint const internalformat = Get< GLint >();
+			GLsizei const width = Get< GLsizei >();
+			GLsizei const height = Get< GLsizei >();
+			GLint const border = Get< GLint >();
+			GLenum const format = Get< GLenum >();
+			GLenum const type = Get< GLenum >();
+			GLvoid const * const pixels = GetBlob();
+			if( !m_corrupt )
+				glTexImage2D( target, level, internalformat, width, height, border, format, type, pixels );
+			break;
+		}
+		case GLTrace::glTexSubImage2D_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLint const level = Get< GLint >();
+			GLint const xoffset = Get< GLint >();
+			GLint const yoffset = Get< GLint >();
+			GLsizei const width = Get< GLsizei >();
+			GLsizei const height = Get< GLsizei >();
+			GLenum const format = Get< GLenum >();
+			GLenum const type = Get< GLenum >();
+			GLvoid const * const pixels = GetBlob();
+			if( !m_corrupt )
+				glTexSubImage2D( target, level, xoffset, yoffset, width, height, format, type, pixels );
+			break;
+		}
+		case GLTrace::gluBuild2DMipmaps_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLint const components = Get< GLint >();
+			GLint const width = Get< GLint >();
+			GLint const height = Get< GLint >();
+			GLenum const format = Get< GLenum >();
+			GLenum const type = Get< GLenum >();
+			void const * const data = GetBlob();
+			if( !m_corrupt && data )
+				gluBuild2DMipmaps( target, components, width, height, format, type, data );
+			break;
+		}
+		case GLTrace::glReadPixels_CALL:
+		{
+			GLint const x = Get< GLint >();
+			GLint const y = Get< GLint >();
+			GLsizei const width = Get< GLsizei >();
+			GLsizei const height = Get< GLsizei >();
+			GLenum const format = Get< GLenum >();
+			GLenum const type = Get< GLenum >();
+			GLvoid * pixels;
+			if( Get< unsigned char >() )
+				pixels = (GLvoid *)GetPointer();
+			else
+			{
+				m_scratch.resize( (size_t)Get< unsigned long long >() + 1 );
+				pixels = &m_scratch[ 0 ];
+			}
+			if( !m_corrupt )
+				glReadPixels( x, y, width, height, format, type, pixels );
+			break;
+		}
+		case GLTrace::glDrawArrays_CALL:
+		{
+			GLenum const mode = Get< GLenum >();
+			GLint const first = Get< GLint >();
+			GLsizei const count = Get< GLsizei >();
+			glDrawArrays( mode, first, count );
+			break;
+		}
+		case GLTrace::glDrawElements_CALL:
+		case GLTrace::glDrawRangeElements_CALL:
+		{
+			bool const range = opcode == GLTrace::glDrawRangeElements_CALL;
+			GLenum const mode = Get< GLenum >();
+			GLuint const start = range ? Get< GLuint >() : 0;
+			GLuint const end = range ? Get< GLuint >() : 0;
+			GLsizei const count = Get< GLsizei >();
+			GLenum const type = Get< GLenum >();
+			GLvoid const * const indices = Get< unsigned char >() ? GetPointer() : GetBlob();
+			if( m_corrupt )
+				break;
+			if( range )
+				glDrawRangeElements( mode, start, end, count, type, indices );
+			else
+				glDrawElements( mode, count, type, indices );
+			break;
+		}
+		case GLTrace::glBufferData_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLsizeiptr const size = (GLsizeiptr)Get< unsigned long long >();
+			GLvoid const * const data = GetBlob();
+			GLenum const usage = Get< GLenum >();
+			if( !m_corrupt )
+				glBufferData( target, size, data, usage );
+			break;
+		}
+		case GLTrace::glBufferSubData_CALL:
+		{
+			GLenum const target = Get< GLenum >();
+			GLintptr const offset = (GLintptr)Get< unsigned long long >();
+			size_t size = 0;
+			GLvoid const * const data = GetBlob( &size );
+			if( !m_corrupt && data )
+				glBufferSubData( target, offset, (GLsizeiptr)size, data );
+			break;
+		}
+		default:
+			m_corrupt = true;
+			return calls;
+		}
+	}
+}
@@ -0,0 +1,169 @@
+#include <gltrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+	//orders functions by how often they were called, most first
+	struct MoreCalls
+	{
+		unsigned const * Calls;
+		MoreCalls( unsigned const * Counts ) : Calls( Counts ) {}
+		bool operator()( int Left, int Right ) const
+		{
+			return Calls[ Left ] != Calls[ Right ] ? Calls[ Left ] > Calls[ Right ] : Left < Right;
+		}
+	};
+}
+
+#define GLTRACE_NAME( Name ) #Name,
+
+GLTrace::Counters GLTrace::s_frame;
+GLTrace::Counters GLTrace::s_total;
+unsigned GLTrace::s_frames = 0;
+GLTrace::Mode GLTrace::s_mode = GLTrace::OFF_MODE;
+char const * const GLTrace::s_names[ GLTrace::FUNCTION_COUNT ] = { GLTRACE_FUNCTIONS( GLTRACE_NAME ) };
+
+void GLTrace::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-trace" ) )
+			continue;
+
+		if( i + 1 >= argc || ( strcmp( argv[ i + 1 ], "top" ) && strcmp( argv[ i + 1 ], "frames" ) ) )
+		{
+			printf( "-trace needs top (the %d most called GL functions on exit) or frames (a line per frame as well)\n", (int)TOP_COUNT );
+			exit( 1 );
+		}
+#ifndef GL_TRACE
+		printf( "-trace needs a build with GL_TRACE defined\n" );
+		exit( 1 );
+#endif
+		s_mode = strcmp( argv[ i + 1 ], "frames" ) ? TOP_MODE : FRAMES_MODE;
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return;
+	}
+}
+
+void GLTrace::EndFrame()
+{
+	unsigned calls = 0;
+	unsigned long long nanoseconds = 0;
+	double bytes = 0.0;
+	for( int f = 0; f < FUNCTION_COUNT; ++f )
+	{
+		calls += s_frame.Calls[ f ];
+		nanoseconds += s_frame.Nanoseconds[ f ];
+		bytes += s_frame.Bytes[ f ];
+		s_total.Calls[ f ] += s_frame.Calls[ f ];
+		s_total.Nanoseconds[ f ] += s_frame.Nanoseconds[ f ];
+		s_total.Bytes[ f ] += s_frame.Bytes[ f ];
+	}
+	++s_frames;
+
+	if( s_mode == FRAMES_MODE )
+	{
+		int order[ FUNCTION_COUNT ];
+		for( int f = 0; f < FUNCTION_COUNT; ++f )
+			order[ f ] = f;
+		std::partial_sort( order, order + 3, order + FUNCTION_COUNT, MoreCalls( s_frame.Calls ) );
+		fprintf( stderr, "gltrace frame=%u calls=%u gl_ms=%.3f uploaded=%.0f top=%s:%u,%s:%u,%s:%u\n", s_frames, calls,
+			Net( nanoseconds, calls ) * 1e-6, bytes, s_names[ order[ 0 ] ], s_frame.Calls[ order[ 0 ] ], s_names[ order[ 1 ] ],
+			s_frame.Calls[ order[ 1 ] ], s_names[ order[ 2 ] ], s_frame.Calls[ order[ 2 ] ] );
+	}
+	memset( &s_frame, 0, sizeof( s_frame ) );
+}
+
+void GLTrace::Finish()
+{
+	if( s_mode == OFF_MODE || !s_frames )
+		return;
+	s_mode = OFF_MODE;
+
+	int order[ FUNCTION_COUNT ];
+	unsigned calls = 0;
+	unsigned long long nanoseconds = 0;
+	double bytes = 0.0;
+	for( int f = 0; f < FUNCTION_COUNT; ++f )
+	{
+		order[ f ] = f;
+		calls += s_total.Calls[ f ];
+		nanoseconds += s_total.Nanoseconds[ f ];
+		bytes += s_total.Bytes[ f ];
+	}
+	std::sort( order, order + FUNCTION_COUNT, MoreCalls( s_total.Calls ) );
+
+	double const frames = s_frames;
+	fprintf( stderr, "gltrace: %u frames, per frame %.1f calls, %.3f ms inside GL, %.0f bytes uploaded\n", s_frames,
+		calls / frames, Net( nanoseconds, calls ) * 1e-6 / frames, bytes / frames );
+	fprintf( stderr, "%-24s %12s %10s %10s %8s %14s\n", "function", "calls", "calls/frm", "ms/frame", "ns/call", "bytes uploaded" );
+	for( int u = 0; u < TOP_COUNT && s_total.Calls[ order[ u ] ]; ++u )
+	{
+		int const f = order[ u ];
+		fprintf( stderr, "%-24s %12u %10.1f %10.4f %8.0f %14.0f\n", s_names[ f ], s_total.Calls[ f ], s_total.Calls[ f ] / frames,
+			Net( s_total.Nanoseconds[ f ], s_total.Calls[ f ] ) * 1e-6 / frames, Net( s_total.Nanoseconds[ f ], s_total.Calls[ f ] ) / s_total.Calls[ f ],
+			s_total.Bytes[ f ] );
+	}
+}
+
+GLTrace::Totals GLTrace::FrameTotals()
+{
+	Totals totals = { 0, 0.0, 0.0 };
+	unsigned long long nanoseconds = 0;
+	for( int f = 0; f < FUNCTION_COUNT; ++f )
+	{
+		totals.Calls += s_frame.Calls[ f ];
+		nanoseconds += s_frame.Nanoseconds[ f ];
+		totals.Bytes += s_frame.Bytes[ f ];
+	}
+	totals.Seconds = Net( nanoseconds, totals.Calls ) * 1e-9;
+	return totals;
+}
+
+double GLTrace::ClockNanoseconds()
+{
+	static double cost = -1.0;
+	if( cost < 0.0 )
+	{
+		enum { READS = 10000 };
+		unsigned long long const start = glutGetElapsedTimeNs();
+		for( int u = 0; u < READS; ++u )
+			glutGetElapsedTimeNs();
+		cost = (double)( glutGetElapsedTimeNs() - start ) / READS;
+	}
+	return cost;
+}
+
+double GLTrace::Net( unsigned long long Nanoseconds, unsigned Calls )
+{
+	double const net = Nanoseconds - ClockNanoseconds() * Calls;
+	return net > 0.0 ? net : 0.0;
+}
+
+double GLTrace::ImageBytes( int Width, int Height, GLenum Format, GLenum Type )
+{
+	double pixel;
+	switch( Type )
+	{
+	case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_4_4_4_4: case GL_UNSIGNED_SHORT_5_5_5_1:
+		pixel = 2.0;
+		break;
+	case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_2_10_10_10_REV:
+		pixel = 4.0;
+		break;
+	default:
+	{
+		double const component = Type == GL_SHORT || Type == GL_UNSIGNED_SHORT ? 2.0 :
+			Type == GL_INT || Type == GL_UNSIGNED_INT || Type == GL_FLOAT ? 4.0 : 1.0;
+		int const components = Format == GL_RGBA || Format == GL_BGRA ? 4 : Format == GL_RGB || Format == GL_BGR ? 3 :
+			Format == GL_LUMINANCE_ALPHA ? 2 : 1;
+		pixel = component * components;
+	}
+	}
+	return pixel * Width * Height;
+}
@@ -1,59 +1,25 @@
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include <mesh.h>
+#include <benchmark.h>
+#include <rasteriser.h>
+#include <recorder.h>
+#include <gltrace.h>
+#include <glreplay.h>
+#include <profiler.h>
+#include <frametimes.h>
+#include <perfcounters.h>
+#include <allocations.h>
+#include <vecmath.h>
 #include <stdexcept>
 #include <vector>
 #include <string>
-#include <map>
 #include <math.h>
 
 /*The bulk of the program*/
 class Program
 {
 private:
-	struct Vec3 //serve as position or color
-	{
-		union
-		{
-			struct
-			{
-				float x;
-				float y;
-				float z;
-			};
-			struct
-			{
-				float r;
-				float g;
-				float b;
-			};
-		};
-		Vec3() {}
-		Vec3( float x, float y, float z ) : x( x ), y( y ), z( z ) {}
-	};
-	struct Vec4 //serve as homogenous position or color, with alpha component
-	{
-		union
-		{
-			struct
-			{
-				float x;
-				float y;
-				float z;
-				float w;
-			};
-			struct
-			{
-				float r;
-				float g;
-				float b;
-				float a;
-			};
-		};
-		Vec4(){}
-		Vec4( float x, float y, float z, float w ) : 
-			x( x ), y( y ), z( z ), w( w ) {}
-			Vec4( Vec3 v, float w ) : x( v.x ), y( v.y ), z( v.z ), w( w ) {}
-	};
 	struct Vertex
 	{
 		Vec3 position;
@@ -93,6 +59,7 @@ private:
 	};
 	struct Texture
 	{
+		std::string Name; //the file it was loaded from
 		GLuint TexID;
 		unsigned Width;
 		unsigned Height;
@@ -170,6 +137,12 @@ private:
 		virtual void DrawFunc() = 0;
 		void Draw()
 		{
+			//set the material properties
+			glMaterialfv(GL_FRONT, GL_SPECULAR, &Material.specular.x );
+			glMaterialfv(GL_FRONT, GL_AMBIENT, &Material.ambience.x );
+			glMaterialfv(GL_FRONT, GL_DIFFUSE, &Material.diffuse.x );
+			glMaterialf(GL_FRONT, GL_SHININESS, 5.f ); 
+
 			//this is the fun part. All that work pays off here.
 			glPushMatrix();
 			glTranslatef( GetPosition().x, GetPosition().y, GetPosition().z );
@@ -190,11 +163,6 @@ private:
 		{
 			Vec4 full = Vec4( 1.f, 1.f, 1.f, 1.f );
 			SetLightComponent( LightComponent( full, full, full ) );
-			//set the material properties
-			glMaterialfv(GL_FRONT, GL_SPECULAR, &Material.specular.x );
-			glMaterialfv(GL_FRONT, GL_AMBIENT, &Material.ambience.x );
-			glMaterialfv(GL_FRONT, GL_DIFFUSE, &Material.diffuse.x );
-			glMaterialf(GL_FRONT, GL_SHININESS, 5.f ); 
 
 			//find the distance between our current position and the target point
 			float dst = sqrt( pow( Position_Target.x - Position.x, 2.f ) + 
@@ -225,14 +193,58 @@ private:
 	enum
 	{
 		//for display lists
-		FISH_BODY = 1,
-		FISH_TAIL,
-		WATERBUG_BODY,
-		WATERBUG_LIMB,
-		PARTICLE,
+		FISH_TAIL = 1,
 		SEABED,
-		BULB,
 	};
+	enum
+	{
+		//generated meshes, drawn from buffer objects (they can't go in display lists without losing their format)
+		MESH_BULB,
+		MESH_FISH_BODY,
+		MESH_WATERBUG_BODY,
+		MESH_WATERBUG_HEAD,
+		MESH_WATERBUG_LIMB,
+		MESH_PARTICLE,
+		MESH_COUNT
+	};
+	static Mesh m_meshes[ MESH_COUNT ]; //static so the entities below can draw them
+	struct ListGeometry //the triangles a display list draws, kept so they can be mirrored into a Rasteriser
+	{
+		std::vector< Mesh::Vertex > Vertices;
+		bool Textured;
+	};
+	static ListGeometry m_lists[ SEABED + 1 ]; //by list name
+	static void CallList( GLuint List )
+	{
+		glCallList( List );
+		ListGeometry const & list = m_lists[ List ];
+		if( Rasteriser::Capture )
+			Rasteriser::Capture->Draw( &list.Vertices[ 0 ], (unsigned)list.Vertices.size(), NULL, 0, list.Textured );
+	}
+	static void DrawFishBody()
+	{
+		glPushMatrix();
+		glTranslatef( 0.f, 0.f, 0.3f );
+		glScalef( 0.25f, 0.75f, 1.5f );
+		glColor3f( 1.f, 1.f, 1.f );
+		m_meshes[ MESH_FISH_BODY ].Draw();
+		glPopMatrix();
+	}
+	static void DrawWaterbugBody()
+	{
+		glPushMatrix();
+		glColor3f( 1.f, 1.f, 1.f );
+		m_meshes[ MESH_WATERBUG_BODY ].Draw();
+		glTranslatef( 0.f, 0.f, 2.f );
+		glScalef( 4.f / 12.f, 4.f / 12.f, 4.f / 12.f );
+		m_meshes[ MESH_WATERBUG_HEAD ].Draw();
+		glPopMatrix();
+	}
+	static void DrawWaterbugLimb()
+	{
+		glColor3f( 1.f, 1.f, 1.f );
+		m_meshes[ MESH_WATERBUG_LIMB ].Draw();
+	}
 	class Fish : public Object
 	{
 	private:
@@ -241,12 +253,12 @@ private:
 
 		void DrawFunc()
 		{
-			glCallList( FISH_BODY );
+			DrawFishBody();
 			//following operations displace our tail. We cannot call this in a single callList() due to variable rotations
 			glTranslatef( 0.f , 0.f, -1.f );
 			glScalef( 1.5f, 1.5f, 1.5f );
 			glRotatef( Tail_Theta, 0.f, 1.f, 0.f );
-			glCallList( FISH_TAIL );
+			CallList( FISH_TAIL );
 			
 			float PI = 2 * acos( 0.f );
 			Timer+= 2 * PI / 60.f;
@@ -281,7 +293,7 @@ private:
 			glRotatef( Angle, 0.f, 1.f, 0.f );
 			glRotatef( r1, 0.f, 0.f, 1.f );
 			glRotatef( r2, 0.f, 1.f, 0.f );
-			glCallList( WATERBUG_LIMB );
+			DrawWaterbugLimb();
 			glRotatef( -r2, 0.f, 1.f, 0.f );
 			glRotatef( -r1, 0.f, 0.f, 1.f );
 			
@@ -289,7 +301,7 @@ private:
 			glRotatef( -r1, 0.f, 0.f, 1.f );
 			glRotatef( r2, 0.f, 1.f, 0.f );
 			
-			glCallList( WATERBUG_LIMB );
+			DrawWaterbugLimb();
 			glPopMatrix();
 		}
 		void DrawLegs()
@@ -323,7 +335,7 @@ private:
 			glPushMatrix();
 			float scalefac = 1.f / 3.f;
 			glScalef( scalefac, scalefac, scalefac );
-			glCallList( WATERBUG_BODY );
+			DrawWaterbugBody();
 			DrawLegs();	//again, cannot call in a single display list due to variables
 			glPopMatrix();
 
@@ -345,7 +357,7 @@ private:
 		}
 		void DrawFunc()
 		{
-			glCallList( PARTICLE );
+			m_meshes[ MESH_PARTICLE ].Draw();
 		}
 	};
 	struct Camera //arrow key movement defined in void SpecialKey( int Key ), not in Camera class (see below)
@@ -449,9 +461,19 @@ private:
 	std::vector< Fish > m_fish;
 	std::vector< WaterBug > m_waterbugs;
 	std::vector< Particle > m_particles;
-	std::map< std::string, Texture > m_textures;
+	std::vector< Texture > m_textures; //a handful, searched by name every frame without building a string
+	Mesh::Format m_meshformat;
+	Mesh::Stats m_meshstats; //of the last frame
+	Benchmark * m_benchmark; //replaces the scene when set
+	Recorder * m_recorder; //records every frame when set
+	GLReplay * m_replay; //replaces the program with a captured trace when set
+	FrameTimes m_frametimes;
+	unsigned long long m_framestart; //when the frame's Advance began
+	bool m_overlay; //the frame time percentiles are drawn over the scene
 
 	static void DisplayFunc();
+	static void CloseFunc();
+	static void SceneFunc();
 	static void ReshapeFunc( int Width, int Height );
 	static void MouseFunc( int Button, int State, int posx, int posy );
 	static void KeyboardFunc( unsigned char Key, int, int );
@@ -459,175 +481,6 @@ private:
 	static void TimerFunc( int Val );
 	static void IdleFunc();
 
-	//the following are math functions used for this program
-	static Vec4 QuaternionMultiply( Vec4 q1, Vec4 q2 )
-	{
-		return Vec4( q1.x * q2.w + q1.y * q2.z - q1.z * q2.y + q1.w * q2.x,
-			-q1.x * q2.z + q1.y * q2.w + q1.z * q2.x + q1.w * q2.y,
-			q1.x * q2.y - q1.y * q2.x + q1.z * q2.w + q1.w * q2.z,
-			-q1.x * q2.x - q1.y * q2.y - q1.z * q2.z + q1.w * q2.w );
-	}
-	static float * QuaternionToMatrix( Vec4 quat )
-	{
-		//get a rotation matrix from our quaternion
-		static float m[ 16 ];
-		m[ 0*4 + 0 ] = m[ 1*4 + 1 ] = m[ 2*4 + 2 ] = m[ 3*4 + 3 ] = 1.f;
-		m[ 0*4 + 0 ] = 1.0f - 2.0f * (quat.y * quat.y + quat.z * quat.z);
-		m[ 0*4 + 1 ] = 2.0f * (quat.x *quat.y + quat.z * quat.w);
-		m[ 0*4 + 2 ] = 2.0f * (quat.x * quat.z - quat.y * quat.w);
-		m[ 1*4 + 0 ] = 2.0f * (quat.x * quat.y - quat.z * quat.w);
-		m[ 1*4 + 1 ] = 1.0f - 2.0f * (quat.x * quat.x + quat.z * quat.z);
-		m[ 1*4 + 2 ] = 2.0f * (quat.y *quat.z + quat.x *quat.w);
-		m[ 2*4 + 0 ] = 2.0f * (quat.x * quat.z + quat.y * quat.w);
-		m[ 2*4 + 1 ] = 2.0f * (quat.y *quat.z - quat.x *quat.w);
-		m[ 2*4 + 2 ] = 1.0f - 2.0f * (quat.x * quat.x + quat.y * quat.y);
-		return m;
-	}
-	static Vec4 QuaternionLerp( Vec4 quat1, Vec4 quat2, float t )
-	{
-		//Linear intERPolation
-		FLOAT dot, epsilon;
-		Vec4 out;
-		epsilon = 1.0f;
-		dot = quat1.x * quat2.x + quat1.y * quat2.y + quat1.z * quat2.z + quat1.w * quat2.w;
-		if ( dot < 0.0f ) epsilon = -1.0f;
-		out.x = ( 1.0f - t ) * quat1.x + epsilon * t * quat2.x;
-		out.y = ( 1.0f - t ) * quat1.y + epsilon * t * quat2.y;
-		out.z = ( 1.0f - t ) * quat1.z + epsilon * t * quat2.z;
-		out.w = ( 1.0f - t ) * quat1.w + epsilon * t * quat2.w;
-		return out;
-	}
-	static Vec4 QuaternionSlerp( Vec4 q0, Vec4 q1, float t )
-	{
-		//Spherical Linear intERPolation
-		float dot = q0.x*q1.x + q0.y*q1.y + q0.z*q1.z + q0.w*q1.w;
-
-		if( dot < -1.f ) dot = -1.f;
-		else if( dot > 1.f ) dot = 1.f;
-
-		float omega = acos( dot );
-
-		if( fabs( omega ) < 1e-10f )
-		  omega = 1e-10f;
-
-		float som = sin(omega);
-		float st0 = sin((1-t) * omega) / som;
-		float st1 = sin(t * omega) / som;
-    
-		return Vec4( q0.x*st0 + q1.x*st1,
-			q0.y*st0 + q1.y*st1,
-			q0.z*st0 + q1.z*st1,
-			q0.w*st0 + q1.w*st1);
-  }
-	static Vec4 QuaternionConjugate( Vec4 qu )
-	{
-		return Vec4( -qu.x, -qu.y, -qu.z, qu.w );
-	}
-	static Vec3 TransformCoord( float const * pm, Vec3 vec ) //transform a single point
-	{
-		Vec3 out;
-		float norm;
-
-		//norm is our 'w' component in the vector <x,y,z,w>, it's not really for normalizing
-		norm = pm[ 0*4 + 3 ] * vec.x + pm[ 1*4 + 3 ] * vec.y + pm[ 2*4 + 3 ] * vec.z + pm[ 3*4 + 3 ];
-
-		if ( norm )
-		{
-			//divide by 'w' component for homogenous space
-			out.x = ( pm[ 0*4 + 0 ] * vec.x + pm[ 1*4 + 0 ] * vec.y + pm[ 2*4 + 0 ] * vec.z + pm[ 3*4 + 0 ] ) / norm;
-			out.y = ( pm[ 0*4 + 1 ] * vec.x + pm[ 1*4 + 1 ] * vec.y + pm[ 2*4 + 1 ] * vec.z + pm[ 3*4 + 1 ] ) / norm;
-			out.z = ( pm[ 0*4 + 2 ] * vec.x + pm[ 1*4 + 2 ] * vec.y + pm[ 2*4 + 2 ] * vec.z + pm[ 3*4 + 2 ] ) / norm;
-		}
-		else
-		{
-			out.x = 0.0f;
-			out.y = 0.0f;
-			out.z = 0.0f;
-		}
-		return out;
-	}
-	static Vec3 CrossProduct( Vec3 vec1, Vec3 vec2 )
-	{
-		Vec3 vec_cross;
-		vec_cross.x = vec1.y * vec2.z - vec2.y * vec1.z;
-		vec_cross.y = vec1.z * vec2.x - vec2.z * vec1.x;
-		vec_cross.z = vec1.x * vec2.y - vec2.x * vec1.y;
-		return vec_cross;
-	}
-	static Vec3 Normalize( Vec3 vec )
-	{
-		float magnitude = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z );
-		vec.x /= magnitude;
-		vec.y /= magnitude;
-		vec.z /= magnitude;
-		return vec;
-	}
-	static Vec4 Normalize( Vec4 vec )
-	{
-		float magnitude = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
-		vec.x /= magnitude;
-		vec.y /= magnitude;
-		vec.z /= magnitude;
-		vec.w /= magnitude;
-		return vec;
-	}
-	static Vec4 Scale( Vec4 vec, float scalefac )
-	{
-		if( scalefac == 0.f )
-			return Vec4( 0.f, 0.f, 0.f, 0.f );
-		float mag = sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
-		vec.x *= scalefac / mag;
-		vec.y *= scalefac / mag;
-		vec.z *= scalefac / mag;
-		vec.w *= scalefac / mag;
-		return vec;
-	}
-	static float GetScale( Vec4 vec )
-	{
-		return sqrt( vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w );
-	}
-	static float DotProduct( Vec3 vec1, Vec3 vec2 )
-	{
-		//probably the easiest
-		vec1 = Normalize( vec1 );
-		vec2 = Normalize( vec2 );
-		return vec1.x * vec2.x + vec1.y * vec2.y + vec1.z * vec2.z;
-	}
-	static Vec4 QuaternionAxisAngle( Vec3 Axis, float Theta )
-	{
-		return Vec4( Axis.x * sin( Theta / 2.f ),
-			Axis.y * sin( Theta / 2.f ),
-			Axis.z * sin( Theta / 2.f ),
-			cos( Theta / 2.f ) );
-	}
-	static float ToRadians( float degrees )
-	{
-		return degrees * 2.f * acos( 0.f ) /180.f;
-	}
-	static Vec3 ToVec3( Vec4 vec )
-	{
-		return Vec3( vec.x, vec.y, vec.z );
-	}
-	static Vec4 CalculateRotation( Vec3 u, Vec3 v )
-	{
-		float norm_u_norm_v = sqrt( DotProduct( u, u ) * DotProduct( v, v ) );
-		float real_part = norm_u_norm_v + DotProduct( u, v );
-		Vec3 w;
-
-		if ( real_part < 1.e-6f * norm_u_norm_v )
-		{
-			/*If u and v are exactly opposite then rotate 180 degrees
-			 around an arbitrary orthogonal axis*/
-			real_part = 0.0f;
-			w = abs( u.x ) > abs( u.z ) ? Vec3( -u.y, u.x, 0.f )
-									: Vec3( 0.f, -u.z, u.y );
-		}
-		else
-			w = CrossProduct( u, v );
-
-		return Normalize( Vec4( w, real_part ) );
-	}
-
 	static void trajectories( int menuitem );
 	static void left_menu( int menuitem );
 	static void right_menu( int menuitem );
@@ -684,15 +537,19 @@ private:
 		m_camera.TrajectoryMode = Camera::FOLLOW_WATERBUG;
 	}
 
-	void LoadTexture( std::string const & FileName )
+	void LoadTexture( char const * FileName )
 	{
 		//check if it exists already
-		std::map< std::string, Texture >::iterator it;
-		if( (it = m_textures.find( FileName )) != m_textures.end() )
+		for( unsigned u = 0; u < m_textures.size(); ++u )
 		{
-			glBindTexture( GL_TEXTURE_2D, it->second.TexID );
-			return;
+			if( m_textures[ u ].Name == FileName )
+			{
+				glBindTexture( GL_TEXTURE_2D, m_textures[ u ].TexID );
+				return;
+			}
 		}
+		PROFILE_SCOPE( "LoadTexture" );
+		Allocations::Region const allocations( "LoadTexture" );
 
 		//allocate the resources to read it
 		FILE * pFile = NULL;
@@ -702,7 +559,7 @@ private:
 
 		try
 		{
-			if( !( pFile = fopen( FileName.c_str(), "rb" ) ) )
+			if( !( pFile = fopen( FileName, "rb" ) ) )
 				throw std::runtime_error( "Could not open file" );
 
 			fread( headerinfo, sizeof( headerinfo ), 1, pFile );
@@ -735,148 +592,207 @@ private:
 			//build the map
 			gluBuild2DMipmaps( GL_TEXTURE_2D, 3, texture.Width, texture.Height, GL_RGB, GL_UNSIGNED_BYTE, buffer );
 
-			m_textures[ FileName ] = texture;
+			texture.Name = FileName;
+			m_textures.push_back( texture );
 		}
 		catch( std::exception const & except )
 		{
-			printf( "Error loading texture: %s -- %s\n", FileName.c_str(), except.what() );
+			printf( "Error loading texture: %s -- %s\n", FileName, except.what() );
 		}
 		free( buffer );
 		if( pFile ) fclose( pFile );
 	}
 
-	void InitializeLists()
+	void OptimizeMesh( Mesh & mesh, char const * Name )
 	{
-		glMatrixMode( GL_MODELVIEW );
+		//report the post-transform cache behaviour before and after, for a typical 16 and 32 entry FIFO
+		unsigned const vertices = mesh.VertexCount();
+		float const before16 = mesh.ACMR( 16 ), before32 = mesh.ACMR( 32 );
+		mesh.Optimize();
+		printf( "%-16s %4u tris, %4u -> %4u verts, ACMR(16) %.3f -> %.3f, ACMR(32) %.3f -> %.3f\n",
+			Name, mesh.TriangleCount(), vertices, mesh.VertexCount(),
+			before16, mesh.ACMR( 16 ), before32, mesh.ACMR( 32 ) );
+	}
+	void InitializeMeshes()
+	{
+		m_meshes[ MESH_BULB ].AddSolidSphere( 1.f, 10, 10 );
+		m_meshes[ MESH_FISH_BODY ].AddSphere( 1.f, 20, 20 );
+		m_meshes[ MESH_WATERBUG_BODY ].AddCylinder( 0.5f, 0.5f, 2.f, 10, 3 );
+		m_meshes[ MESH_WATERBUG_HEAD ].AddDodecahedron();
+		m_meshes[ MESH_WATERBUG_LIMB ].AddCylinder( 0.2f, 0.2f, 2.f, 10, 3 );
+		m_meshes[ MESH_PARTICLE ].AddCube( 0.1f );
+
+		OptimizeMesh( m_meshes[ MESH_BULB ], "bulb" );
+		OptimizeMesh( m_meshes[ MESH_FISH_BODY ], "fish body" );
+		OptimizeMesh( m_meshes[ MESH_WATERBUG_BODY ], "waterbug body" );
+		OptimizeMesh( m_meshes[ MESH_WATERBUG_HEAD ], "waterbug head" );
+		OptimizeMesh( m_meshes[ MESH_WATERBUG_LIMB ], "waterbug limb" );
+		OptimizeMesh( m_meshes[ MESH_PARTICLE ], "particle" );
+
+		for( unsigned u = 0; u < MESH_COUNT; ++u )
+			m_meshes[ u ].Upload( m_meshformat );
+		ReportMeshMemory();
+	}
+	void ReportMeshMemory()
+	{
+		static char const * const names[ MESH_COUNT ] =
+			{ "bulb", "fish body", "waterbug body", "waterbug head", "waterbug limb", "particle" };
+		unsigned vertexbytes = 0, indexbytes = 0;
+		for( unsigned u = 0; u < MESH_COUNT; ++u )
+		{
+			Mesh const & mesh = m_meshes[ u ];
+			printf( "%-16s %-6s %4u verts * %2u B = %6u B vertices, %6u B indices\n", names[ u ],
+				mesh.GetFormat() == Mesh::PACKED_FORMAT ? "packed" : "float",
+				mesh.VertexCount(), mesh.VertexStride(), mesh.VertexBytes(), mesh.IndexBytes() );
+			vertexbytes += mesh.VertexBytes();
+			indexbytes += mesh.IndexBytes();
+		}
+		printf( "mesh buffers: %u B vertices, %u B indices\n", vertexbytes, indexbytes );
+		if( m_meshstats.Draws )
+			printf( "last frame: %u draws, %lu B vertices, %lu B indices (%.2f MB/s at 60 fps)\n",
+				m_meshstats.Draws, m_meshstats.VertexBytes, m_meshstats.IndexBytes,
+				60.f * ( m_meshstats.VertexBytes + m_meshstats.IndexBytes ) / ( 1024.f * 1024.f ) );
+	}
 
-		/*light bulb*/
-		glNewList( BULB, GL_COMPILE );
-		glutSolidSphere( 1.f, 10, 10 );
-		glEndList();
-		
-		/*Fish*/
+	static void AddListVertex( ListGeometry & List, Vec3 Position, Vec3 Normal, float s, float t )
+	{
+		Mesh::Vertex const vertex = { { Position.x, Position.y, Position.z }, { Normal.x, Normal.y, Normal.z }, { s, t } };
+		List.Vertices.push_back( vertex );
+	}
+	static void AddListTriangle( ListGeometry & List, Vec3 Normal, Vec3 a, Vec3 b, Vec3 c )
+	{
+		AddListVertex( List, a, Normal, 0.f, 0.f );
+		AddListVertex( List, b, Normal, 0.f, 0.f );
+		AddListVertex( List, c, Normal, 0.f, 0.f );
+	}
+	void CompileList( GLuint List )
+	{
+		ListGeometry const & list = m_lists[ List ];
 		glPushAttrib( GL_ALL_ATTRIB_BITS );
-		glNewList( FISH_BODY, GL_COMPILE );
-		glPushMatrix();
-		glTranslatef( 0.f, 0.f, 0.3f );
-		glScalef( 0.25f, 0.75f, 1.5f );
+		glNewList( List, GL_COMPILE );
 		glColor3f( 1.f, 1.f, 1.f );
-		GLUquadric* pSphereQuadric = gluNewQuadric();
-		gluQuadricDrawStyle( pSphereQuadric, GLU_FILL );
-		gluQuadricOrientation( pSphereQuadric, GLU_OUTSIDE );
-		gluQuadricTexture( pSphereQuadric, GL_TRUE );
-		gluQuadricNormals( pSphereQuadric, GLU_SMOOTH );
-		gluSphere( pSphereQuadric, 1.0, 20, 20 );
-		gluDeleteQuadric( pSphereQuadric );
-		glPopMatrix();
+		glBegin( GL_TRIANGLES );
+		for( unsigned u = 0; u < list.Vertices.size(); ++u )
+		{
+			Mesh::Vertex const & vertex = list.Vertices[ u ];
+			if( list.Textured )
+				glTexCoord2fv( vertex.TexCoord );
+			glNormal3fv( vertex.Normal );
+			glVertex3fv( vertex.Position );
+		}
+		glEnd();
 		glEndList();
+		glPopAttrib();
+	}
+	void InitializeLists()
+	{
+		PROFILE_SCOPE( "InitializeLists" );
+		glMatrixMode( GL_MODELVIEW );
+		InitializeMeshes();
 
-		glNewList( FISH_TAIL, GL_COMPILE );
-		glColor3f( 1.f, 1.f, 1.f );
-		glBegin( GL_TRIANGLES );
+		/*Fish*/
+		ListGeometry & tail = m_lists[ FISH_TAIL ];
+		tail.Textured = false;
 
 		//bottom panel
 		Vec3 n1 = Normalize( CrossProduct( Vec3( 0.15f, -0.5f, -0.5f ), Vec3( -0.15f, -0.5f, -0.5f ) ) );
-		glNormal3f( n1.x, n1.y, n1.z );
-		glVertex3f( 0.f, 0.f, 0.f );
-		glVertex3f( -0.15f, -0.5f, -0.5f );
-		glVertex3f( 0.15f, -0.5f, -0.5f );
+		AddListTriangle( tail, n1, Vec3( 0.f, 0.f, 0.f ), Vec3( -0.15f, -0.5f, -0.5f ), Vec3( 0.15f, -0.5f, -0.5f ) );
 
 		//top panel
 		Vec3 n2 = Normalize( CrossProduct( Vec3( 0.15f, 0.5f, -0.5f ), Vec3( -0.15f, 0.5f, -0.5f ) ) );
-		glNormal3f( n2.x, n2.y, n2.z );
-		glVertex3f( 0.f, 0.f, 0.f );
-		glVertex3f( -0.15f, 0.5f, -0.5f );
-		glVertex3f( 0.15f, 0.5f, -0.5f );
+		AddListTriangle( tail, n2, Vec3( 0.f, 0.f, 0.f ), Vec3( -0.15f, 0.5f, -0.5f ), Vec3( 0.15f, 0.5f, -0.5f ) );
 
 		//left panel
 		Vec3 n3 = Normalize( CrossProduct( Vec3( -0.15f, -0.5f, -0.5f ), Vec3( -0.15f, 0.5f, -0.5f ) ) );
-		glNormal3f( n3.x, n3.y, n3.z );
-		glVertex3f( 0.f, 0.f, 0.f );
-		glVertex3f( -0.15f, 0.5f, -0.5f );
-		glVertex3f( -0.15f, -0.5f, -0.5f );
+		AddListTriangle( tail, n3, Vec3( 0.f, 0.f, 0.f ), Vec3( -0.15f, 0.5f, -0.5f ), Vec3( -0.15f, -0.5f, -0.5f ) );
 
 		//right panel
 		Vec3 n4 = Normalize( CrossProduct( Vec3( 0.15f, -0.5f, -0.5f ), Vec3( 0.15f, 0.5f, -0.5f ) ) );
-		glNormal3f( n4.x, n4.y, n4.z );
-		glVertex3f( 0.f, 0.f, 0.f );
-		glVertex3f( 0.15f, 0.5f, -0.5f );
-		glVertex3f( 0.15f, -0.5f, -0.5f );
+		AddListTriangle( tail, n4, Vec3( 0.f, 0.f, 0.f ), Vec3( 0.15f, 0.5f, -0.5f ), Vec3( 0.15f, -0.5f, -0.5f ) );
 
 		//back panel
-		glNormal3f( 0.f, 0.f, -1.f );
-		glVertex3f( -0.15f, 0.5f, -0.5f );
-		glVertex3f( -0.15f, -0.5f, -0.5f );
-		glVertex3f( 0.15f, -0.5f, -0.5f );
-
-		glVertex3f( -0.15f, 0.5f, -0.5f );
-		glVertex3f( 0.15f, 0.5f, -0.5f );
-		glVertex3f( 0.15f, -0.5f, -0.5f );
-		glEnd();
-		glEndList();
-		glPopAttrib();
-
-		//WaterBug
-		glPushAttrib( GL_ALL_ATTRIB_BITS );
-		GLUquadric* pCylinderQuadric = gluNewQuadric();
-		gluQuadricDrawStyle( pCylinderQuadric, GLU_FILL );
-		gluQuadricOrientation( pCylinderQuadric, GLU_OUTSIDE );
-		gluQuadricTexture( pCylinderQuadric, GL_TRUE );
-		gluQuadricNormals( pCylinderQuadric, GLU_SMOOTH );
-		glNewList( WATERBUG_BODY, GL_COMPILE );
-		glPushMatrix();
-		glColor3f( 1.f, 1.f, 1.f );
-		gluCylinder( pCylinderQuadric, 0.5, 0.5, 2.0, 10, 3 );
-		glTranslatef( 0.f, 0.f, 2.f );
-		glScalef( 4.f / 12.f, 4.f / 12.f, 4.f / 12.f );
-		glutSolidDodecahedron();
-		glPopMatrix();
-		glEndList();
-
-		glNewList( WATERBUG_LIMB, GL_COMPILE );
-		glColor3f( 1.f, 1.f, 1.f );
-		gluCylinder( pCylinderQuadric, 0.2, 0.2, 2.0, 10, 3 );
-		glEndList();
-		gluDeleteQuadric( pCylinderQuadric );
-		glPopAttrib();
-
-		glNewList( PARTICLE, GL_COMPILE );
-		glutSolidCube( 0.1 );
-		glEndList();
-
-		//Seabed
-		glPushAttrib( GL_ALL_ATTRIB_BITS );
-		glNewList( SEABED, GL_COMPILE );
-		glPushMatrix();
+		Vec3 const back( 0.f, 0.f, -1.f );
+		AddListTriangle( tail, back, Vec3( -0.15f, 0.5f, -0.5f ), Vec3( -0.15f, -0.5f, -0.5f ), Vec3( 0.15f, -0.5f, -0.5f ) );
+		AddListTriangle( tail, back, Vec3( -0.15f, 0.5f, -0.5f ), Vec3( 0.15f, 0.5f, -0.5f ), Vec3( 0.15f, -0.5f, -0.5f ) );
+		CompileList( FISH_TAIL );
+
+		//Seabed, a strip of two triangles 20 units down
+		ListGeometry & seabed = m_lists[ SEABED ];
+		seabed.Textured = true;
 		const float scalefactor = 300.f;
 		const float scalefactor2 = sqrt( scalefactor );
-		glTranslatef( 0.f, -20.f, 0.f );
-		glColor3f( 1.f, 1.f, 1.f );
-		glNormal3f( 0.f, 1.f, 0.f );
-		glBegin( GL_TRIANGLE_STRIP );
-		glTexCoord2f( 0.f * scalefactor2 , 0.f * scalefactor2 );
-		glVertex3f( -0.5f * scalefactor, 0.f, -0.5f * scalefactor );
-		glTexCoord2f( 1.f * scalefactor2, 0.f );
-		glVertex3f( 0.5f * scalefactor, 0.f, -0.5f * scalefactor );
-		glTexCoord2f( 0.f, 1.f * scalefactor2 );
-		glVertex3f( -0.5f * scalefactor, 0.f, 0.5f * scalefactor );
-		glTexCoord2f( 1.f * scalefactor2, 1.f * scalefactor2 );
-		glVertex3f( 0.5f * scalefactor, 0.f, 0.5f * scalefactor );
-		glEnd();
-		glPopMatrix();
-		glEndList();
-		glPopAttrib();
+		Vec3 const up( 0.f, 1.f, 0.f );
+		Vec3 const corners[ 4 ] = { Vec3( -0.5f * scalefactor, -20.f, -0.5f * scalefactor ), Vec3( 0.5f * scalefactor, -20.f, -0.5f * scalefactor ),
+			Vec3( -0.5f * scalefactor, -20.f, 0.5f * scalefactor ), Vec3( 0.5f * scalefactor, -20.f, 0.5f * scalefactor ) };
+		static unsigned const strip[ 6 ] = { 0, 1, 2, 2, 1, 3 };
+		for( unsigned u = 0; u < 6; ++u )
+			AddListVertex( seabed, corners[ strip[ u ] ], up, ( strip[ u ] & 1 ) * scalefactor2, ( strip[ u ] >> 1 ) * scalefactor2 );
+		CompileList( SEABED );
 	}
 	void Advance() /*mostly drawing*/
 	{
-		
+		PROFILE_SCOPE( "Advance" );
+		m_framestart = glutGetElapsedTimeNs();
+		Allocations::BeginFrame();
+
 		/*Set-Up*/
 		glClearColor( m_board.FogColor.r, m_board.FogColor.g, m_board.FogColor.b, 0.0f );
 		glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 		glMatrixMode( GL_MODELVIEW );
 		glLoadIdentity();
-		
-		m_camera.Update( m_fish, m_waterbugs );
+		Mesh::FrameStats.Reset();
+
+		if( m_benchmark )
+		{
+			PROFILE_SCOPE( "Benchmark" );
+			if( !m_benchmark->Frame() )
+				glutLeaveMainLoop();
+			Present();
+			return;
+		}
+
+		DrawScene();
+		if( m_overlay )
+			m_frametimes.DrawOverlay();
+
+		/*Finishing*/
+		m_meshstats = Mesh::FrameStats;
+		glFlush();
+		Present();
+	}
+	void Present()
+	{
+		PROFILE_SCOPE( "Present" );
+		{
+			//closed before EndFrame, so this frame's report has the swap's allocations too
+			Allocations::Region const allocations( "Present" );
+			if( m_recorder )
+				m_recorder->Capture();
+			GLCapture::EndFrame();
+			GLTrace::EndFrame();
+			PerfCounters::EndFrame();
+			m_frametimes.Record( FrameTimes::CPU_TIME, glutGetElapsedTimeNs() - m_framestart );
+			PROFILE_SCOPE( "glutSwapBuffers" );
+			glutSwapBuffers();
+			m_frametimes.Swapped( glutGetElapsedTimeNs() );
+		}
+		Allocations::EndFrame();
+	}
+	void DrawScene()
+	{
+		PROFILE_SCOPE( "DrawScene" );
+		Allocations::Region const allocations( "DrawScene" );
+		//Update and Draw both call rand(), so they stay interleaved; only the updates count as simulation time and
+		//in the species' counter regions, which costs a counter read per object with -counters
+		unsigned long long simulation = 0;
+		{
+			PROFILE_SCOPE( "Camera" );
+			PerfCounters::Enter( PerfCounters::CAMERA_REGION );
+			unsigned long long const start = glutGetElapsedTimeNs();
+			m_camera.Update( m_fish, m_waterbugs );
+			simulation += glutGetElapsedTimeNs() - start;
+		}
+		PerfCounters::Enter( PerfCounters::DRAW_REGION );
 
 		gluLookAt( m_camera.eye.x, m_camera.eye.y, m_camera.eye.z,
 			m_camera.at.x, m_camera.at.y, m_camera.at.z,
@@ -900,36 +816,66 @@ private:
 
 		LoadTexture( "FishScales.bmp" );
 
-		for( unsigned u = 0; u < m_fish.size(); ++u )
-			m_fish[ u ].Update( m_board.LowerBounds, m_board.UpperBounds ), m_fish[ u ].Draw();
+		{
+			PROFILE_SCOPE( "Fish" );
+			for( unsigned u = 0; u < m_fish.size(); ++u )
+			{
+				PerfCounters::Enter( PerfCounters::FISH_REGION );
+				unsigned long long const start = glutGetElapsedTimeNs();
+				m_fish[ u ].Update( m_board.LowerBounds, m_board.UpperBounds );
+				simulation += glutGetElapsedTimeNs() - start;
+				PerfCounters::Enter( PerfCounters::DRAW_REGION );
+				m_fish[ u ].Draw();
+			}
+		}
 
 		LoadTexture( "Waterbug.bmp" );
 
-		for( unsigned u = 0; u < m_waterbugs.size(); ++u )
-			m_waterbugs[ u ].Update( m_board.LowerBounds, m_board.UpperBounds_Floor ), m_waterbugs[ u ].Draw();
+		{
+			PROFILE_SCOPE( "Waterbugs" );
+			for( unsigned u = 0; u < m_waterbugs.size(); ++u )
+			{
+				PerfCounters::Enter( PerfCounters::WATERBUG_REGION );
+				unsigned long long const start = glutGetElapsedTimeNs();
+				m_waterbugs[ u ].Update( m_board.LowerBounds, m_board.UpperBounds_Floor );
+				simulation += glutGetElapsedTimeNs() - start;
+				PerfCounters::Enter( PerfCounters::DRAW_REGION );
+				m_waterbugs[ u ].Draw();
+			}
+		}
 
-		for( unsigned u = 0; u < m_particles.size(); ++u )
-			m_particles[ u ].Update( m_board.LowerBounds, m_board.UpperBounds ), m_particles[ u ].Draw();
+		{
+			PROFILE_SCOPE( "Particles" );
+			for( unsigned u = 0; u < m_particles.size(); ++u )
+			{
+				PerfCounters::Enter( PerfCounters::PARTICLE_REGION );
+				unsigned long long const start = glutGetElapsedTimeNs();
+				m_particles[ u ].Update( m_board.LowerBounds, m_board.UpperBounds );
+				simulation += glutGetElapsedTimeNs() - start;
+				PerfCounters::Enter( PerfCounters::DRAW_REGION );
+				m_particles[ u ].Draw();
+			}
+		}
+		m_frametimes.Record( FrameTimes::SIM_TIME, simulation );
 
 		LoadTexture( "Seabed.bmp" );
 
+		PROFILE_SCOPE( "Seabed and bulb" );
 		//the seabed
-		glCallList( SEABED );
+		CallList( SEABED );
 
 		//the light bulb
 		glPushMatrix();
 		glTranslatef( m_light.position.x, m_light.position.y, m_light.position.z );
 		glDisable( GL_LIGHTING );
 		glDisable( GL_TEXTURE_2D );
-		glCallList( BULB );
+		m_meshes[ MESH_BULB ].Draw();
 		glEnable( GL_TEXTURE_2D );
 		glEnable( GL_LIGHTING );
 		glPopMatrix();
 
-		/*Finishing*/
 		glPopAttrib();
-		glFlush();
-		glutSwapBuffers();
+		PerfCounters::Leave();
 	}
 	void ReshapeWindow( int Width, int Height )
 	{
@@ -1001,6 +947,23 @@ private:
 		case 'B':
 			m_camera.Move( -1.f );
 			break;
+		case 'p':
+		case 'P':
+			//switch every mesh between packed and float vertices
+			m_meshformat = m_meshformat == Mesh::PACKED_FORMAT ? Mesh::FLOAT_FORMAT : Mesh::PACKED_FORMAT;
+			for( unsigned u = 0; u < MESH_COUNT; ++u )
+				m_meshes[ u ].Upload( m_meshformat );
+			ReportMeshMemory();
+			return;
+		case 'h':
+		case 'H':
+			m_overlay = !m_overlay;
+			return;
+		case 't':
+		case 'T':
+			//the profile so far, recording goes on
+			Profiler::Write();
+			return;
 		case 27:
 		case 'q':
 			glutDestroyWindow( WindowId );
@@ -1049,20 +1012,65 @@ private:
 	}
 
 public:
+	Program() : m_meshformat( Mesh::PACKED_FORMAT ), m_benchmark( NULL ), m_recorder( NULL ), m_replay( NULL ),
+		m_framestart( 0 ), m_overlay( false )
+	{
+		m_meshstats.Reset();
+	}
 	void RunProgram( int argc, char **argv )
 	{
+		Profiler::FromCommandLine( argc, argv );
+		Profiler::NameThread( "main" );
+
 		/*Initialize glut*/
-		glutInit( &argc, argv );
+		{
+			PROFILE_SCOPE( "glutInit" );
+			glutInit( &argc, argv );
+		}
+		m_benchmark = Benchmark::FromCommandLine( argc, argv );
+		Benchmark::SetScene( &SceneFunc );
+		m_recorder = Recorder::FromCommandLine( argc, argv );
+		GLTrace::FromCommandLine( argc, argv );
+		GLCapture::FromCommandLine( argc, argv );
+		m_replay = GLReplay::FromCommandLine( argc, argv );
+		m_frametimes.FromCommandLine( argc, argv );
+		PerfCounters::FromCommandLine( argc, argv );
+		Allocations::FromCommandLine( argc, argv );
 		glutInitDisplayMode( GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH );
-		glutInitWindowSize( m_board.m_width, m_board.m_height );
+		if( m_replay )
+			glutInitWindowSize( m_replay->GetWidth(), m_replay->GetHeight() );
+		else
+			glutInitWindowSize( m_board.m_width, m_board.m_height );
 		glutInitWindowPosition( 100, 100 );
-		WindowId = glutCreateWindow( "Assignment 4" );
+		{
+			PROFILE_SCOPE( "glutCreateWindow" );
+			WindowId = glutCreateWindow( "Assignment 4" );
+		}
+		/*entry points resolve on first use, so startup only pays for the ones the program calls*/
+		glewLazy = GL_TRUE;
+		GLenum glewerror;
+		{
+			PROFILE_SCOPE( "glewInit" );
+			glewerror = glewInit();
+		}
+		if( glewerror != GLEW_OK )
+			printf( "Error initializing GLEW -- %s\n", glewGetErrorString( glewerror ) );
+		if( m_replay )
+		{
+			//the trace is the whole workload, none of the program's own setup happens
+			bool const replayed = m_replay->Run();
+			delete m_replay;
+			if( !replayed )
+				exit( 1 );
+			return;
+		}
 		glutDisplayFunc( &DisplayFunc );
+		glutCloseFunc( &CloseFunc );
 		glutMouseFunc( &MouseFunc );
 		glutKeyboardFunc( &KeyboardFunc );
 		glutSpecialFunc( &SpecialFunc );
 		glutReshapeFunc( &ReshapeFunc );
-		glutTimerFunc( 16, &TimerFunc, 0 );
+		glutPeriodicTimerFunc( 16, &TimerFunc, 0, GLUT_TIMER_SKIP );
 		glutIdleFunc( &IdleFunc );
 
 		/*enable lighting, fog, depth test, and smooth shading*/
@@ -1126,11 +1134,16 @@ public:
 			m_particles.push_back( Particle( m_board.LowerBounds, m_board.UpperBounds ) );
 		glEnable( GL_TEXTURE_2D );
 
+		if( m_benchmark )
+			m_benchmark->Setup();
+
 		/*run the glut mainloop*/
 		glutMainLoop();
 	}
 };
 
+Mesh Program::m_meshes[ Program::MESH_COUNT ];
+Program::ListGeometry Program::m_lists[ Program::SEABED + 1 ];
 static Program glprogram; //global is necessary due to GLUT
 
 int main( int argc, char ** argv )
@@ -1142,6 +1155,20 @@ void Program::DisplayFunc()
 {
 	//glprogram.Advance();
 }
+void Program::CloseFunc()
+{
+	//the window's context is still current, so the frames in flight can be read back
+	if( glprogram.m_recorder )
+		glprogram.m_recorder->Finish();
+	GLCapture::Close();
+	GLTrace::Finish();
+	Profiler::Write();
+	glprogram.m_frametimes.Write();
+}
+void Program::SceneFunc()
+{
+	glprogram.DrawScene();
+}
 void Program::ReshapeFunc( int Width, int Height )
 {
 	glprogram.ReshapeWindow( Width, Height );
@@ -1161,7 +1188,6 @@ void Program::SpecialFunc( int Key, int, int )
 void Program::TimerFunc( int Val )
 {
 	glprogram.Advance();
-	glutTimerFunc( 16, &TimerFunc, 0 );
 }
 void Program::IdleFunc()
 {
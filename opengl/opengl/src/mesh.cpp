@@ -0,0 +1,571 @@
+#include <mesh.h>
+#include <rasteriser.h>
+#include <gltrace.h>
+#include <stdexcept>
+#include <algorithm>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <map>
+
+namespace
+{
+	float const PI = 3.14159265358979323846f;
+
+	//orders vertices bytewise so identical ones can be found when welding
+	struct VertexLess
+	{
+		bool operator()( Mesh::Vertex const & a, Mesh::Vertex const & b ) const
+		{
+			return memcmp( &a, &b, sizeof( Mesh::Vertex ) ) < 0;
+		}
+	};
+
+	//Tom Forsyth's "Linear-Speed Vertex Cache Optimisation" scoring, with his suggested constants
+	unsigned const ForsythCacheSize = 32;
+
+	float ForsythScore( int CachePosition, unsigned Valence )
+	{
+		if( !Valence )
+			return -1.f; //no triangles left that need this vertex
+		float score = 0.f;
+		if( CachePosition >= 0 )
+		{
+			if( CachePosition < 3 )
+				score = 0.75f; //used by the last triangle, deliberately lower so we don't just strip
+			else
+				score = pow( 1.f - ( CachePosition - 3 ) / (float)( ForsythCacheSize - 3 ), 1.5f );
+		}
+		//favour vertices with few triangles left, so lone triangles are not left behind
+		return score + 2.f / sqrt( (float)Valence );
+	}
+
+	GLushort FloatToHalf( float f )
+	{
+		//round to nearest, denormals flush to zero, which is plenty for texture coordinates
+		union { float f; GLuint u; } bits;
+		bits.f = f;
+		GLuint const sign = ( bits.u >> 16 ) & 0x8000;
+		int const exponent = (int)( ( bits.u >> 23 ) & 0xff ) - 127 + 15;
+		GLuint mantissa = bits.u & 0x7fffff;
+		if( exponent <= 0 )
+			return (GLushort)sign;
+		if( exponent >= 31 )
+			return (GLushort)( sign | 0x7c00 );
+		GLuint half = sign | ( exponent << 10 ) | ( mantissa >> 13 );
+		if( mantissa & 0x1000 )
+			++half; //carries into the exponent correctly
+		return (GLushort)half;
+	}
+
+	void PackSnorm8( float const * v, GLbyte * Out )
+	{
+		for( unsigned k = 0; k < 3; ++k )
+		{
+			float c = v[ k ] < -1.f ? -1.f : v[ k ] > 1.f ? 1.f : v[ k ];
+			Out[ k ] = (GLbyte)floor( c * 127.f + 0.5f );
+		}
+		Out[ 3 ] = 0;
+	}
+}
+
+Mesh::Stats Mesh::FrameStats = { 0, 0, 0 };
+
+Mesh::Mesh() : m_textured( false ), m_format( FLOAT_FORMAT ), m_vertexbuffer( 0 ), m_indexbuffer( 0 )
+{
+	for( unsigned k = 0; k < 3; ++k )
+		m_center[ k ] = 0.f, m_scale[ k ] = 1.f;
+}
+
+unsigned Mesh::AddVertex( float const * Position, float const * Normal, float s, float t )
+{
+	if( m_vertices.size() > 0xffff )
+		throw std::length_error( "Mesh has too many vertices for 16-bit indices" );
+	Vertex v;
+	memcpy( v.Position, Position, sizeof( v.Position ) );
+	memcpy( v.Normal, Normal, sizeof( v.Normal ) );
+	v.TexCoord[ 0 ] = s;
+	v.TexCoord[ 1 ] = t;
+	m_vertices.push_back( v );
+	return (unsigned)m_vertices.size() - 1;
+}
+
+void Mesh::AddTriangle( unsigned a, unsigned b, unsigned c )
+{
+	m_indices.push_back( (GLushort)a );
+	m_indices.push_back( (GLushort)b );
+	m_indices.push_back( (GLushort)c );
+}
+
+void Mesh::AddQuadStrip( unsigned First, unsigned Count )
+{
+	//quad i of a strip is v[2i], v[2i+1], v[2i+3], v[2i+2]
+	for( unsigned u = 0; u + 3 < Count; u += 2 )
+	{
+		AddTriangle( First + u, First + u + 1, First + u + 3 );
+		AddTriangle( First + u, First + u + 3, First + u + 2 );
+	}
+}
+
+void Mesh::AddFan( unsigned First, unsigned Count )
+{
+	for( unsigned u = 1; u + 1 < Count; ++u )
+		AddTriangle( First, First + u, First + u + 1 );
+}
+
+void Mesh::AddSphere( float Radius, int Slices, int Stacks )
+{
+	m_textured = true;
+	for( int j = 0; j < Stacks; ++j )
+	{
+		float rho0 = PI * j / Stacks;
+		float rho1 = PI * ( j + 1 ) / Stacks;
+		unsigned first = (unsigned)m_vertices.size();
+		for( int i = 0; i <= Slices; ++i )
+		{
+			float theta = i == Slices ? 0.f : 2.f * PI * i / Slices;
+			float n1[ 3 ] = { sin( theta ) * sin( rho1 ), cos( theta ) * sin( rho1 ), cos( rho1 ) };
+			float p1[ 3 ] = { n1[ 0 ] * Radius, n1[ 1 ] * Radius, n1[ 2 ] * Radius };
+			AddVertex( p1, n1, 1.f - (float)i / Slices, 1.f - (float)( j + 1 ) / Stacks );
+			float n0[ 3 ] = { sin( theta ) * sin( rho0 ), cos( theta ) * sin( rho0 ), cos( rho0 ) };
+			float p0[ 3 ] = { n0[ 0 ] * Radius, n0[ 1 ] * Radius, n0[ 2 ] * Radius };
+			AddVertex( p0, n0, 1.f - (float)i / Slices, 1.f - (float)j / Stacks );
+		}
+		AddQuadStrip( first, 2 * ( Slices + 1 ) );
+	}
+}
+
+void Mesh::AddCylinder( float BaseRadius, float TopRadius, float Height, int Slices, int Stacks )
+{
+	m_textured = true;
+	float delta = BaseRadius - TopRadius;
+	float length = sqrt( delta * delta + Height * Height );
+	float nz = delta / length;
+	float nxy = Height / length;
+	for( int j = 0; j < Stacks; ++j )
+	{
+		float z0 = j * Height / Stacks;
+		float z1 = ( j + 1 ) * Height / Stacks;
+		float r0 = BaseRadius - delta * ( (float)j / Stacks );
+		float r1 = BaseRadius - delta * ( (float)( j + 1 ) / Stacks );
+		unsigned first = (unsigned)m_vertices.size();
+		for( int i = 0; i <= Slices; ++i )
+		{
+			float theta = i == Slices ? 0.f : 2.f * PI * i / Slices;
+			float n[ 3 ] = { sin( theta ) * nxy, cos( theta ) * nxy, nz };
+			float p0[ 3 ] = { r0 * sin( theta ), r0 * cos( theta ), z0 };
+			float p1[ 3 ] = { r1 * sin( theta ), r1 * cos( theta ), z1 };
+			AddVertex( p0, n, 1.f - (float)i / Slices, (float)j / Stacks );
+			AddVertex( p1, n, 1.f - (float)i / Slices, (float)( j + 1 ) / Stacks );
+		}
+		AddQuadStrip( first, 2 * ( Slices + 1 ) );
+	}
+}
+
+void Mesh::AddSolidSphere( float Radius, int Slices, int Stacks )
+{
+	//same layout as freeglut: a fan on each pole and quad strips in between
+	std::vector< float > sint( Slices + 1 ), cost( Slices + 1 );
+	for( int j = 0; j < Slices; ++j )
+	{
+		sint[ j ] = sin( -2.f * PI * j / Slices );
+		cost[ j ] = cos( -2.f * PI * j / Slices );
+	}
+	sint[ Slices ] = sint[ 0 ], cost[ Slices ] = cost[ 0 ]; //exactly equal, so the seam welds
+	float z1 = cos( PI / Stacks ), r1 = sin( PI / Stacks );
+	float z0, r0;
+
+	float const top[ 3 ] = { 0.f, 0.f, 1.f };
+	float const toppos[ 3 ] = { 0.f, 0.f, Radius };
+	unsigned first = AddVertex( toppos, top, 0.f, 0.f );
+	for( int j = Slices; j >= 0; --j )
+	{
+		float n[ 3 ] = { cost[ j ] * r1, sint[ j ] * r1, z1 };
+		float p[ 3 ] = { n[ 0 ] * Radius, n[ 1 ] * Radius, n[ 2 ] * Radius };
+		AddVertex( p, n, 0.f, 0.f );
+	}
+	AddFan( first, Slices + 2 );
+
+	for( int i = 1; i < Stacks - 1; ++i )
+	{
+		z0 = z1, z1 = cos( PI * ( i + 1 ) / Stacks );
+		r0 = r1, r1 = sin( PI * ( i + 1 ) / Stacks );
+		first = (unsigned)m_vertices.size();
+		for( int j = 0; j <= Slices; ++j )
+		{
+			float n1[ 3 ] = { cost[ j ] * r1, sint[ j ] * r1, z1 };
+			float p1[ 3 ] = { n1[ 0 ] * Radius, n1[ 1 ] * Radius, n1[ 2 ] * Radius };
+			AddVertex( p1, n1, 0.f, 0.f );
+			float n0[ 3 ] = { cost[ j ] * r0, sint[ j ] * r0, z0 };
+			float p0[ 3 ] = { n0[ 0 ] * Radius, n0[ 1 ] * Radius, n0[ 2 ] * Radius };
+			AddVertex( p0, n0, 0.f, 0.f );
+		}
+		AddQuadStrip( first, 2 * ( Slices + 1 ) );
+	}
+
+	float const bottom[ 3 ] = { 0.f, 0.f, -1.f };
+	float const bottompos[ 3 ] = { 0.f, 0.f, -Radius };
+	first = AddVertex( bottompos, bottom, 0.f, 0.f );
+	for( int j = 0; j <= Slices; ++j )
+	{
+		float n[ 3 ] = { cost[ j ] * r1, sint[ j ] * r1, z1 };
+		float p[ 3 ] = { n[ 0 ] * Radius, n[ 1 ] * Radius, n[ 2 ] * Radius };
+		AddVertex( p, n, 0.f, 0.f );
+	}
+	AddFan( first, Slices + 2 );
+}
+
+void Mesh::AddDodecahedron()
+{
+	//the twelve pentagons of glutSolidDodecahedron, see freeglut_geometry.c for where the numbers come from
+	float const x = 0.61803398875f, z = 1.61803398875f;
+	float const a = 0.525731112119f, b = 0.850650808354f;
+	float const faces[ 12 ][ 6 ][ 3 ] =
+	{
+		{ { 0.f, a, b }, { 0.f, z, x }, { -1.f, 1.f, 1.f }, { -x, 0.f, z }, { x, 0.f, z }, { 1.f, 1.f, 1.f } },
+		{ { 0.f, a, -b }, { 0.f, z, -x }, { 1.f, 1.f, -1.f }, { x, 0.f, -z }, { -x, 0.f, -z }, { -1.f, 1.f, -1.f } },
+		{ { 0.f, -a, b }, { 0.f, -z, x }, { 1.f, -1.f, 1.f }, { x, 0.f, z }, { -x, 0.f, z }, { -1.f, -1.f, 1.f } },
+		{ { 0.f, -a, -b }, { 0.f, -z, -x }, { -1.f, -1.f, -1.f }, { -x, 0.f, -z }, { x, 0.f, -z }, { 1.f, -1.f, -1.f } },
+		{ { b, 0.f, a }, { x, 0.f, z }, { 1.f, -1.f, 1.f }, { z, -x, 0.f }, { z, x, 0.f }, { 1.f, 1.f, 1.f } },
+		{ { -b, 0.f, a }, { -x, 0.f, z }, { -1.f, 1.f, 1.f }, { -z, x, 0.f }, { -z, -x, 0.f }, { -1.f, -1.f, 1.f } },
+		{ { b, 0.f, -a }, { x, 0.f, -z }, { 1.f, 1.f, -1.f }, { z, x, 0.f }, { z, -x, 0.f }, { 1.f, -1.f, -1.f } },
+		{ { -b, 0.f, -a }, { -x, 0.f, -z }, { -1.f, -1.f, -1.f }, { -z, -x, 0.f }, { -z, x, 0.f }, { -1.f, 1.f, -1.f } },
+		{ { a, b, 0.f }, { z, x, 0.f }, { 1.f, 1.f, -1.f }, { 0.f, z, -x }, { 0.f, z, x }, { 1.f, 1.f, 1.f } },
+		{ { a, -b, 0.f }, { z, -x, 0.f }, { 1.f, -1.f, 1.f }, { 0.f, -z, x }, { 0.f, -z, -x }, { 1.f, -1.f, -1.f } },
+		{ { -a, b, 0.f }, { -z, x, 0.f }, { -1.f, 1.f, 1.f }, { 0.f, z, x }, { 0.f, z, -x }, { -1.f, 1.f, -1.f } },
+		{ { -a, -b, 0.f }, { -z, -x, 0.f }, { -1.f, -1.f, -1.f }, { 0.f, -z, -x }, { 0.f, -z, x }, { -1.f, -1.f, 1.f } },
+	};
+	for( unsigned f = 0; f < 12; ++f )
+	{
+		unsigned first = (unsigned)m_vertices.size();
+		for( unsigned v = 1; v < 6; ++v )
+			AddVertex( faces[ f ][ v ], faces[ f ][ 0 ], 0.f, 0.f );
+		AddFan( first, 5 );
+	}
+}
+
+void Mesh::AddCube( float Size )
+{
+	float const s = Size * 0.5f;
+	//normal followed by the four corners of each face, in glutSolidCube's order
+	float const faces[ 6 ][ 5 ][ 3 ] =
+	{
+		{ { 1.f, 0.f, 0.f }, { s, -s, s }, { s, -s, -s }, { s, s, -s }, { s, s, s } },
+		{ { 0.f, 1.f, 0.f }, { s, s, s }, { s, s, -s }, { -s, s, -s }, { -s, s, s } },
+		{ { 0.f, 0.f, 1.f }, { s, s, s }, { -s, s, s }, { -s, -s, s }, { s, -s, s } },
+		{ { -1.f, 0.f, 0.f }, { -s, -s, s }, { -s, s, s }, { -s, s, -s }, { -s, -s, -s } },
+		{ { 0.f, -1.f, 0.f }, { -s, -s, s }, { -s, -s, -s }, { s, -s, -s }, { s, -s, s } },
+		{ { 0.f, 0.f, -1.f }, { -s, -s, -s }, { -s, s, -s }, { s, s, -s }, { s, -s, -s } },
+	};
+	for( unsigned f = 0; f < 6; ++f )
+	{
+		unsigned first = (unsigned)m_vertices.size();
+		for( unsigned v = 1; v < 5; ++v )
+			AddVertex( faces[ f ][ v ], faces[ f ][ 0 ], 0.f, 0.f );
+		AddFan( first, 4 );
+	}
+}
+
+void Mesh::Optimize()
+{
+	Weld();
+	OptimizeVertexCache();
+	OptimizeVertexFetch();
+}
+
+void Mesh::Weld()
+{
+	//strips and fans emit shared vertices once per primitive, merge the exact duplicates
+	std::map< Vertex, GLushort, VertexLess > unique;
+	std::vector< Vertex > vertices;
+	std::vector< GLushort > remap( m_vertices.size() );
+	for( unsigned u = 0; u < m_vertices.size(); ++u )
+	{
+		std::map< Vertex, GLushort, VertexLess >::iterator it = unique.find( m_vertices[ u ] );
+		if( it == unique.end() )
+		{
+			it = unique.insert( std::make_pair( m_vertices[ u ], (GLushort)vertices.size() ) ).first;
+			vertices.push_back( m_vertices[ u ] );
+		}
+		remap[ u ] = it->second;
+	}
+	for( unsigned u = 0; u < m_indices.size(); ++u )
+		m_indices[ u ] = remap[ m_indices[ u ] ];
+
+	//welding can collapse the pole triangles of a sphere, drop them
+	std::vector< GLushort > indices;
+	for( unsigned u = 0; u < m_indices.size(); u += 3 )
+	{
+		GLushort a = m_indices[ u ], b = m_indices[ u + 1 ], c = m_indices[ u + 2 ];
+		if( a != b && b != c && a != c )
+			indices.push_back( a ), indices.push_back( b ), indices.push_back( c );
+	}
+	m_vertices.swap( vertices );
+	m_indices.swap( indices );
+}
+
+void Mesh::OptimizeVertexCache()
+{
+	unsigned const tris = TriangleCount();
+	unsigned const verts = VertexCount();
+	if( !tris )
+		return;
+
+	//triangles adjacent to each vertex, stored as one flat array with offsets
+	std::vector< unsigned > valence( verts, 0 ), offset( verts + 1, 0 ), adjacency( m_indices.size() );
+	for( unsigned u = 0; u < m_indices.size(); ++u )
+		++valence[ m_indices[ u ] ];
+	for( unsigned v = 0; v < verts; ++v )
+		offset[ v + 1 ] = offset[ v ] + valence[ v ];
+	std::vector< unsigned > fill( offset.begin(), offset.end() - 1 );
+	for( unsigned u = 0; u < m_indices.size(); ++u )
+		adjacency[ fill[ m_indices[ u ] ]++ ] = u / 3;
+
+	std::vector< int > cacheposition( verts, -1 );
+	std::vector< float > vertexscore( verts );
+	for( unsigned v = 0; v < verts; ++v )
+		vertexscore[ v ] = ForsythScore( -1, valence[ v ] );
+
+	std::vector< float > triscore( tris );
+	std::vector< bool > emitted( tris, false );
+	for( unsigned t = 0; t < tris; ++t )
+		triscore[ t ] = vertexscore[ m_indices[ t*3 ] ] + vertexscore[ m_indices[ t*3 + 1 ] ] + vertexscore[ m_indices[ t*3 + 2 ] ];
+
+	std::vector< GLushort > out;
+	out.reserve( m_indices.size() );
+	std::vector< unsigned > cache, next;
+	unsigned best = 0;
+	for( unsigned t = 1; t < tris; ++t )
+		if( triscore[ t ] > triscore[ best ] ) best = t;
+	unsigned scan = 0; //triangles before this index have all been emitted
+
+	while( true )
+	{
+		emitted[ best ] = true;
+		GLushort const * tri = &m_indices[ best * 3 ];
+		out.insert( out.end(), tri, tri + 3 );
+
+		//remove the triangle from its vertices' adjacency lists
+		for( unsigned k = 0; k < 3; ++k )
+		{
+			unsigned v = tri[ k ];
+			unsigned * begin = &adjacency[ offset[ v ] ];
+			unsigned * end = begin + valence[ v ];
+			std::swap( *std::find( begin, end, best ), *( end - 1 ) );
+			--valence[ v ];
+		}
+
+		//simulated LRU: the triangle's vertices move to the front
+		next.assign( tri, tri + 3 );
+		for( unsigned u = 0; u < cache.size(); ++u )
+			if( cache[ u ] != tri[ 0 ] && cache[ u ] != tri[ 1 ] && cache[ u ] != tri[ 2 ] )
+				next.push_back( cache[ u ] );
+		for( unsigned u = ForsythCacheSize; u < next.size(); ++u )
+			cacheposition[ next[ u ] ] = -1, vertexscore[ next[ u ] ] = ForsythScore( -1, valence[ next[ u ] ] );
+		if( next.size() > ForsythCacheSize )
+			next.resize( ForsythCacheSize );
+		cache.swap( next );
+
+		//rescore what is in the cache and pick the best candidate among its triangles
+		for( unsigned u = 0; u < cache.size(); ++u )
+			cacheposition[ cache[ u ] ] = (int)u, vertexscore[ cache[ u ] ] = ForsythScore( (int)u, valence[ cache[ u ] ] );
+		float bestscore = -1.f;
+		bool found = false;
+		for( unsigned u = 0; u < cache.size(); ++u )
+		{
+			unsigned v = cache[ u ];
+			for( unsigned a = 0; a < valence[ v ]; ++a )
+			{
+				unsigned t = adjacency[ offset[ v ] + a ];
+				float score = vertexscore[ m_indices[ t*3 ] ] + vertexscore[ m_indices[ t*3 + 1 ] ] + vertexscore[ m_indices[ t*3 + 2 ] ];
+				triscore[ t ] = score;
+				if( score > bestscore )
+					bestscore = score, best = t, found = true;
+			}
+		}
+
+		if( !found )
+		{
+			//the cache has nothing left to offer, continue with the next untouched triangle
+			while( scan < tris && emitted[ scan ] )
+				++scan;
+			if( scan == tris )
+				break;
+			best = scan;
+		}
+	}
+	m_indices.swap( out );
+}
+
+void Mesh::OptimizeVertexFetch()
+{
+	//renumber vertices in the order they are first referenced so fetches walk memory linearly
+	std::vector< int > remap( m_vertices.size(), -1 );
+	std::vector< Vertex > vertices;
+	vertices.reserve( m_vertices.size() );
+	for( unsigned u = 0; u < m_indices.size(); ++u )
+	{
+		int & index = remap[ m_indices[ u ] ];
+		if( index < 0 )
+		{
+			index = (int)vertices.size();
+			vertices.push_back( m_vertices[ m_indices[ u ] ] );
+		}
+		m_indices[ u ] = (GLushort)index;
+	}
+	m_vertices.swap( vertices ); //anything unreferenced is dropped
+}
+
+float Mesh::ACMR( unsigned CacheSize ) const
+{
+	if( m_indices.empty() )
+		return 0.f;
+	std::vector< unsigned > stamp( m_vertices.size(), 0 );
+	unsigned misses = 0;
+	for( unsigned u = 0; u < m_indices.size(); ++u )
+	{
+		//a FIFO cache hits if the vertex went in within the last CacheSize misses
+		unsigned & s = stamp[ m_indices[ u ] ];
+		if( !s || misses - s + 1 > CacheSize )
+			s = ++misses;
+	}
+	return (float)misses / TriangleCount();
+}
+
+void Mesh::Pack( std::vector< PackedVertex > & Out )
+{
+	float lower[ 3 ], upper[ 3 ];
+	for( unsigned k = 0; k < 3; ++k )
+		lower[ k ] = upper[ k ] = m_vertices.empty() ? 0.f : m_vertices[ 0 ].Position[ k ];
+	for( unsigned u = 0; u < m_vertices.size(); ++u )
+		for( unsigned k = 0; k < 3; ++k )
+		{
+			lower[ k ] = std::min( lower[ k ], m_vertices[ u ].Position[ k ] );
+			upper[ k ] = std::max( upper[ k ], m_vertices[ u ].Position[ k ] );
+		}
+	for( unsigned k = 0; k < 3; ++k )
+	{
+		m_center[ k ] = 0.5f * ( lower[ k ] + upper[ k ] );
+		float const extent = 0.5f * ( upper[ k ] - lower[ k ] );
+		m_scale[ k ] = extent > 0.f ? extent / 32767.f : 1.f;
+	}
+
+	Out.resize( m_vertices.size() );
+	for( unsigned u = 0; u < m_vertices.size(); ++u )
+	{
+		Vertex const & v = m_vertices[ u ];
+		PackedVertex & p = Out[ u ];
+		//GL transforms normals by the inverse transpose of the decode scale, so pre-multiply by the scale to cancel it out
+		float n[ 3 ];
+		float length = 0.f;
+		for( unsigned k = 0; k < 3; ++k )
+		{
+			p.Position[ k ] = (GLshort)floor( ( v.Position[ k ] - m_center[ k ] ) / m_scale[ k ] + 0.5f );
+			n[ k ] = v.Normal[ k ] * m_scale[ k ];
+			length += n[ k ] * n[ k ];
+		}
+		length = sqrt( length );
+		for( unsigned k = 0; k < 3; ++k )
+			n[ k ] = length > 0.f ? n[ k ] / length : 0.f;
+		p.Position[ 3 ] = 0;
+		PackSnorm8( n, p.Normal );
+		p.TexCoord[ 0 ] = FloatToHalf( v.TexCoord[ 0 ] );
+		p.TexCoord[ 1 ] = FloatToHalf( v.TexCoord[ 1 ] );
+	}
+}
+
+void Mesh::Upload( Format VertexFormat )
+{
+	if( !GLEW_VERSION_1_5 || m_indices.empty() )
+		return; //no buffer objects, Draw() keeps using client arrays
+	if( VertexFormat == PACKED_FORMAT && !( GLEW_VERSION_3_0 || GLEW_ARB_half_float_vertex ) )
+	{
+		printf( "Packed vertices need half float texcoords, using floats\n" );
+		VertexFormat = FLOAT_FORMAT;
+	}
+
+	if( !m_vertexbuffer )
+		glGenBuffers( 1, &m_vertexbuffer );
+	if( !m_indexbuffer )
+		glGenBuffers( 1, &m_indexbuffer );
+	m_format = VertexFormat;
+
+	glBindBuffer( GL_ARRAY_BUFFER, m_vertexbuffer );
+	if( m_format == PACKED_FORMAT )
+	{
+		std::vector< PackedVertex > packed;
+		Pack( packed );
+		glBufferData( GL_ARRAY_BUFFER, packed.size() * sizeof( PackedVertex ), &packed[ 0 ], GL_STATIC_DRAW );
+	}
+	else
+		glBufferData( GL_ARRAY_BUFFER, m_vertices.size() * sizeof( Vertex ), &m_vertices[ 0 ], GL_STATIC_DRAW );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indexbuffer );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, IndexBytes(), &m_indices[ 0 ], GL_STATIC_DRAW );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+
+void Mesh::Draw() const
+{
+	if( m_indices.empty() )
+		return;
+
+	//with buffers bound the pointers are offsets into them
+	char const * base = m_vertexbuffer ? NULL : (char const *)&m_vertices[ 0 ];
+	GLushort const * indices = m_indexbuffer ? NULL : &m_indices[ 0 ];
+	glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+	if( m_vertexbuffer )
+	{
+		glBindBuffer( GL_ARRAY_BUFFER, m_vertexbuffer );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indexbuffer );
+	}
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_NORMAL_ARRAY );
+	if( m_textured )
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+	if( m_format == PACKED_FORMAT )
+	{
+		glVertexPointer( 3, GL_SHORT, sizeof( PackedVertex ), base + offsetof( PackedVertex, Position ) );
+		glNormalPointer( GL_BYTE, sizeof( PackedVertex ), base + offsetof( PackedVertex, Normal ) );
+		if( m_textured )
+			glTexCoordPointer( 2, GL_HALF_FLOAT, sizeof( PackedVertex ), base + offsetof( PackedVertex, TexCoord ) );
+		//decode the positions, the normals were pre-scaled in Pack() and GL_NORMALIZE restores their length
+		glPushMatrix();
+		glTranslatef( m_center[ 0 ], m_center[ 1 ], m_center[ 2 ] );
+		glScalef( m_scale[ 0 ], m_scale[ 1 ], m_scale[ 2 ] );
+		glPushAttrib( GL_ENABLE_BIT ); //puts GL_NORMALIZE back as the caller had it, without asking the driver
+		glEnable( GL_NORMALIZE );
+	}
+	else
+	{
+		glVertexPointer( 3, GL_FLOAT, sizeof( Vertex ), base + offsetof( Vertex, Position ) );
+		glNormalPointer( GL_FLOAT, sizeof( Vertex ), base + offsetof( Vertex, Normal ) );
+		if( m_textured )
+			glTexCoordPointer( 2, GL_FLOAT, sizeof( Vertex ), base + offsetof( Vertex, TexCoord ) );
+	}
+
+	glDrawElements( GL_TRIANGLES, (GLsizei)m_indices.size(), GL_UNSIGNED_SHORT, indices );
+
+	if( m_format == PACKED_FORMAT )
+	{
+		glPopAttrib();
+		glPopMatrix();
+	}
+	if( m_vertexbuffer )
+	{
+		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	}
+	glPopClientAttrib();
+
+	if( Rasteriser::Capture )
+		Rasteriser::Capture->Draw( &m_vertices[ 0 ], VertexCount(), &m_indices[ 0 ], (unsigned)m_indices.size(), m_textured );
+
+	//the vertices are in first-use order, so each one is fetched about once per draw
+	++FrameStats.Draws;
+	FrameStats.VertexBytes += VertexBytes();
+	FrameStats.IndexBytes += IndexBytes();
+}
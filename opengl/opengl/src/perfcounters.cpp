@@ -0,0 +1,211 @@
+#include <perfcounters.h>
+#include <GL/freeglut.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace
+{
+	enum { MAX_COUNTERS = 8 };
+
+	struct Event
+	{
+		unsigned Type;
+		unsigned long long Config;
+		char const * Name;
+	};
+
+#ifdef __linux__
+	//the fixed counters and four general purpose ones, what every x86 PMU can count at once
+	Event const HardwareEvents[] =
+	{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, "cache_references" },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache_misses" },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, "branches" },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch_misses" }
+	};
+	Event const SoftwareEvents[] =
+	{
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task_clock_ns" },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page_faults" },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context_switches" },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, "migrations" }
+	};
+#endif
+
+	char const * const RegionNames[ PerfCounters::REGION_COUNT ] = { "camera", "fish", "waterbugs", "particles", "draw" };
+
+	int Descriptors[ MAX_COUNTERS ];
+	char const * Names[ MAX_COUNTERS ];
+	int Counters = 0; //0 when only the time is taken
+	unsigned Interval = 0;
+	unsigned Frames = 0;
+
+	int Current = PerfCounters::REGION_COUNT; //the region being counted, REGION_COUNT for none
+	unsigned long long Last[ MAX_COUNTERS ]; //the readings Current started at
+	unsigned long long LastEnabled, LastRunning, LastTime;
+	double Totals[ PerfCounters::REGION_COUNT ][ MAX_COUNTERS ];
+	double Times[ PerfCounters::REGION_COUNT ];
+
+#ifdef __linux__
+	int OpenEvent( Event const & Which, int Group )
+	{
+		perf_event_attr attr;
+		memset( &attr, 0, sizeof( attr ) );
+		attr.size = sizeof( attr );
+		attr.type = Which.Type;
+		attr.config = Which.Config;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		//the program's own work, which is all a paranoid kernel lets an unprivileged process see anyway
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		//this thread on any CPU
+		return (int)syscall( SYS_perf_event_open, &attr, 0, -1, Group, 0 );
+	}
+
+	//opens what it can of the group, the leader first; returns how many opened, with errno from the leader if none
+	int OpenGroup( Event const * Events, int Count )
+	{
+		int opened = 0;
+		for( int e = 0; e < Count && opened < MAX_COUNTERS; ++e )
+		{
+			int const fd = OpenEvent( Events[ e ], opened ? Descriptors[ 0 ] : -1 );
+			if( fd < 0 )
+			{
+				if( !opened )
+					return 0;
+				continue; //a member the PMU does not have, the rest are still worth counting
+			}
+			Descriptors[ opened ] = fd;
+			Names[ opened++ ] = Events[ e ].Name;
+		}
+		return opened;
+	}
+#endif
+
+	//the group's values, scaled up if the kernel had to share the counters and ran the group part of the time
+	void Read( unsigned long long * Values, unsigned long long & Enabled, unsigned long long & Running )
+	{
+		Enabled = Running = 0;
+#ifdef __linux__
+		unsigned long long buffer[ 3 + MAX_COUNTERS ];
+		if( Counters && read( Descriptors[ 0 ], buffer, sizeof( buffer ) ) >= (long)( 3 * sizeof( buffer[ 0 ] ) ) )
+		{
+			Enabled = buffer[ 1 ];
+			Running = buffer[ 2 ];
+			for( int c = 0; c < Counters; ++c )
+				Values[ c ] = c < (int)buffer[ 0 ] ? buffer[ 3 + c ] : 0;
+			return;
+		}
+#endif
+		memset( Values, 0, sizeof( unsigned long long ) * MAX_COUNTERS );
+	}
+
+	int Find( char const * Name )
+	{
+		for( int c = 0; c < Counters; ++c )
+		{
+			if( !strcmp( Names[ c ], Name ) )
+				return c;
+		}
+		return -1;
+	}
+
+	//a ratio of two counters as a line item, if both were opened
+	void ReportRatio( int Region, char const * Name, char const * Numerator, char const * Denominator, double Scale )
+	{
+		int const n = Find( Numerator ), d = Find( Denominator );
+		if( n >= 0 && d >= 0 && Totals[ Region ][ d ] > 0.0 )
+			fprintf( stderr, " %s=%.3f", Name, Totals[ Region ][ n ] / Totals[ Region ][ d ] * Scale );
+	}
+}
+
+bool PerfCounters::s_enabled = false;
+
+void PerfCounters::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-counters" ) )
+			continue;
+
+		int const frames = i + 1 < argc ? atoi( argv[ i + 1 ] ) : 0;
+		if( frames <= 0 )
+		{
+			printf( "-counters needs how many frames to report the regions' counters over\n" );
+			exit( 1 );
+		}
+		Interval = (unsigned)frames;
+
+#ifdef __linux__
+		Counters = OpenGroup( HardwareEvents, sizeof( HardwareEvents ) / sizeof( HardwareEvents[ 0 ] ) );
+		if( !Counters )
+		{
+			int const hardware = errno;
+			Counters = OpenGroup( SoftwareEvents, sizeof( SoftwareEvents ) / sizeof( SoftwareEvents[ 0 ] ) );
+			if( Counters )
+				fprintf( stderr, "counters: no hardware counters (%s), counting software events\n", strerror( hardware ) );
+			else
+				fprintf( stderr, "counters: perf_event_open failed (%s), timing the regions only\n", strerror( errno ) );
+		}
+#else
+		fprintf( stderr, "counters: perf_event_open is Linux only, timing the regions only\n" );
+#endif
+		s_enabled = true;
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return;
+	}
+}
+
+void PerfCounters::Switch( int Next )
+{
+	unsigned long long values[ MAX_COUNTERS ], enabled, running;
+	Read( values, enabled, running );
+	unsigned long long const now = glutGetElapsedTimeNs();
+
+	if( Current < REGION_COUNT )
+	{
+		double const scale = running > LastRunning ? (double)( enabled - LastEnabled ) / ( running - LastRunning ) : 0.0;
+		for( int c = 0; c < Counters; ++c )
+			Totals[ Current ][ c ] += ( values[ c ] - Last[ c ] ) * scale;
+		Times[ Current ] += (double)( now - LastTime );
+	}
+
+	Current = Next;
+	memcpy( Last, values, sizeof( Last ) );
+	LastEnabled = enabled;
+	LastRunning = running;
+	LastTime = now;
+}
+
+void PerfCounters::Frame()
+{
+	if( ++Frames < Interval )
+		return;
+
+	double const frames = Frames;
+	for( int r = 0; r < REGION_COUNT; ++r )
+	{
+		fprintf( stderr, "counters region=%s frames=%u ms=%.4f", RegionNames[ r ], Frames, Times[ r ] * 1e-6 / frames );
+		for( int c = 0; c < Counters; ++c )
+			fprintf( stderr, " %s=%.0f", Names[ c ], Totals[ r ][ c ] / frames );
+		ReportRatio( r, "ipc", "instructions", "cycles", 1.0 );
+		ReportRatio( r, "cache_miss_pct", "cache_misses", "cache_references", 100.0 );
+		ReportRatio( r, "branch_miss_pct", "branch_misses", "branches", 100.0 );
+		fprintf( stderr, "\n" );
+	}
+
+	Frames = 0;
+	memset( Totals, 0, sizeof( Totals ) );
+	memset( Times, 0, sizeof( Times ) );
+}
@@ -0,0 +1,254 @@
+#include <profiler.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define PROFILER_THREAD_LOCAL __declspec( thread )
+#else
+#include <time.h>
+#define PROFILER_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+	struct Event
+	{
+		char const * Name;
+		unsigned long long Start;
+		unsigned long long End;
+	};
+
+	/*one thread's events, overwritten oldest first. Only the owning thread writes Events and Count, publishing each
+	 event by bumping Count after it; a reader copies the ring between two reads of Count and keeps what the owner
+	 cannot have been overwriting meanwhile*/
+	struct Ring
+	{
+		Event Events[ Profiler::RING_SIZE ];
+		unsigned long volatile Count; //events ever recorded, by every thread that has owned the ring
+		long volatile Owned;
+		char const * volatile Name;
+		unsigned Id;
+		Ring * Next;
+	};
+
+	Ring * volatile Rings = NULL;
+	long volatile RingCount = 0;
+	unsigned long long Epoch = 0; //the trace's time zero, when -profile was read
+	PROFILER_THREAD_LOCAL Ring * ThreadRing = NULL;
+
+	void Barrier()
+	{
+#ifdef _WIN32
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	//orders the event's stores before the count's, all the writer needs, and cheaper than a full barrier on x86
+	void Publish( unsigned long volatile * Count, unsigned long Value )
+	{
+#ifdef _WIN32
+		*Count = Value; //microsoft's volatile stores release
+#else
+		__atomic_store_n( Count, Value, __ATOMIC_RELEASE );
+#endif
+	}
+
+	bool Claim( long volatile * Owned )
+	{
+#ifdef _WIN32
+		return !InterlockedCompareExchange( Owned, 1, 0 );
+#else
+		return !__sync_val_compare_and_swap( Owned, 0, 1 );
+#endif
+	}
+
+	//a ring some thread has given up, or a new one pushed onto the list
+	Ring * ClaimRing()
+	{
+		for( Ring * ring = Rings; ring; ring = ring->Next )
+		{
+			if( !ring->Owned && Claim( &ring->Owned ) )
+				return ring;
+		}
+
+		Ring * const ring = new Ring;
+		ring->Count = 0;
+		ring->Owned = 1;
+		ring->Name = NULL;
+#ifdef _WIN32
+		ring->Id = (unsigned)InterlockedIncrement( &RingCount );
+		do
+			ring->Next = Rings;
+		while( InterlockedCompareExchangePointer( (PVOID volatile *)&Rings, ring, ring->Next ) != ring->Next );
+#else
+		ring->Id = (unsigned)__sync_add_and_fetch( &RingCount, 1 );
+		do
+			ring->Next = Rings;
+		while( !__sync_bool_compare_and_swap( &Rings, ring->Next, ring ) );
+#endif
+		return ring;
+	}
+
+	Ring * CurrentRing()
+	{
+		if( !ThreadRing )
+			ThreadRing = ClaimRing();
+		return ThreadRing;
+	}
+
+	//the events of a ring its owner cannot be in the middle of overwriting, oldest first
+	void Snapshot( Ring const & Source, std::vector< Event > & Events )
+	{
+		unsigned long const count = Source.Count;
+		Barrier();
+		unsigned long const first = count > Profiler::RING_SIZE ? count - Profiler::RING_SIZE : 0;
+		Events.resize( count - first );
+		for( unsigned long u = first; u < count; ++u )
+			Events[ u - first ] = Source.Events[ u & ( Profiler::RING_SIZE - 1 ) ];
+		Barrier();
+		//the owner may since have overwritten everything up to the event it is now writing
+		unsigned long const after = Source.Count;
+		unsigned long const valid = after + 1 > Profiler::RING_SIZE ? after + 1 - Profiler::RING_SIZE : 0;
+		if( valid > first )
+			Events.erase( Events.begin(), Events.begin() + std::min< unsigned long >( valid - first, (unsigned long)Events.size() ) );
+	}
+
+	//chrome wants microseconds, kept to the nanosecond
+	double Microseconds( unsigned long long Nanoseconds )
+	{
+		return Nanoseconds * 1e-3;
+	}
+}
+
+bool Profiler::s_enabled = false;
+char Profiler::s_path[ 512 ] = "";
+
+void Profiler::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-profile" ) )
+			continue;
+
+		if( i + 1 >= argc || strlen( argv[ i + 1 ] ) >= sizeof( s_path ) )
+		{
+			printf( "-profile needs the path of the JSON trace to write\n" );
+			exit( 1 );
+		}
+#ifndef PROFILE
+		printf( "-profile needs a build with PROFILE defined\n" );
+		exit( 1 );
+#endif
+		strcpy( s_path, argv[ i + 1 ] );
+		Epoch = Now();
+		s_enabled = true;
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return;
+	}
+}
+
+void Profiler::NameThread( char const * Name )
+{
+	//a ring is only worth its memory when something will be recorded into it
+	if( s_enabled )
+		CurrentRing()->Name = Name;
+}
+
+void Profiler::EndThread()
+{
+	if( !ThreadRing )
+		return;
+	Barrier();
+	ThreadRing->Owned = 0;
+	ThreadRing = NULL;
+}
+
+void Profiler::Record( char const * Name, unsigned long long Start, unsigned long long End )
+{
+	Ring * const ring = CurrentRing();
+	unsigned long const count = ring->Count;
+	Event & event = ring->Events[ count & ( RING_SIZE - 1 ) ];
+	event.Name = Name;
+	event.Start = Start;
+	event.End = End;
+	Publish( &ring->Count, count + 1 );
+}
+
+unsigned long Profiler::ThreadScopes()
+{
+	return ThreadRing ? ThreadRing->Count : 0;
+}
+
+bool Profiler::Write()
+{
+	if( !s_path[ 0 ] )
+		return false;
+	FILE * const file = fopen( s_path, "w" );
+	if( !file )
+	{
+		fprintf( stderr, "profile: could not open %s\n", s_path );
+		return false;
+	}
+
+	unsigned long events = 0, lost = 0;
+	unsigned threads = 0;
+	std::vector< Event > snapshot;
+	fprintf( file, "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"opengl\"}}" );
+	for( Ring * ring = Rings; ring; ring = ring->Next )
+	{
+		char const * const name = ring->Name;
+		if( name )
+			fprintf( file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", ring->Id, name );
+		else
+			fprintf( file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", ring->Id, ring->Id );
+
+		Snapshot( *ring, snapshot );
+		lost += ring->Count - (unsigned long)snapshot.size();
+		for( size_t u = 0; u < snapshot.size(); ++u )
+		{
+			//anything timed before -profile was read starts at zero
+			unsigned long long const start = snapshot[ u ].Start > Epoch ? snapshot[ u ].Start - Epoch : 0;
+			unsigned long long const end = snapshot[ u ].End > Epoch ? snapshot[ u ].End - Epoch : 0;
+			fprintf( file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", snapshot[ u ].Name, ring->Id,
+				Microseconds( start ), Microseconds( end - start ) );
+		}
+		events += (unsigned long)snapshot.size();
+		++threads;
+	}
+	fprintf( file, "\n],\"displayTimeUnit\":\"ns\"}\n" );
+	bool const written = !ferror( file );
+	fclose( file );
+
+	if( written )
+		fprintf( stderr, "profile: %lu scopes from %u threads written to %s, %lu older ones overwritten\n", events, threads, s_path, lost );
+	else
+		fprintf( stderr, "profile: could not write %s\n", s_path );
+	return written;
+}
+
+unsigned long long Profiler::Now()
+{
+	//glutGetElapsedTimeNs starts over at glutInit, which is one of the things timed
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	if( !frequency.QuadPart )
+		QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &counter );
+	//split so counter * 1e9 cannot overflow
+	return (unsigned long long)( counter.QuadPart / frequency.QuadPart ) * 1000000000 +
+		(unsigned long long)( counter.QuadPart % frequency.QuadPart ) * 1000000000 / frequency.QuadPart;
+#else
+	timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (unsigned long long)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
@@ -0,0 +1,636 @@
+#include <rasteriser.h>
+#include <profiler.h>
+#include <GL/freeglut.h>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+#ifdef _WIN32
+#include <process.h> //freeglut has brought in windows.h
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define RASTERISER_SSE2
+#endif
+
+namespace
+{
+	//window coordinates are snapped to this many subpixels, as the hardware does
+	double const SubPixels = 256.0;
+
+	double Now()
+	{
+		return glutGetElapsedTimeNs() * 1e-9;
+	}
+
+	long AtomicIncrement( long volatile * Value )
+	{
+#ifdef _WIN32
+		return InterlockedIncrement( Value );
+#else
+		return __sync_add_and_fetch( Value, 1 );
+#endif
+	}
+
+	float Clamp( float f )
+	{
+		return f < 0.f ? 0.f : f > 1.f ? 1.f : f;
+	}
+
+	int Wrap( int i, int Size )
+	{
+		i %= Size;
+		return i < 0 ? i + Size : i;
+	}
+
+	//pixel bounds, clamped in double since a triangle crossing the near plane can project a long way out
+	int ClampToInt( double d, int Lower, int Upper )
+	{
+		return d < Lower ? Lower : d > Upper ? Upper : (int)d;
+	}
+
+	void Transform( float const * m, float const * v, float * Out ) //column major, v has w = 1
+	{
+		for( int r = 0; r < 4; ++r )
+			Out[ r ] = m[ 0*4 + r ] * v[ 0 ] + m[ 1*4 + r ] * v[ 1 ] + m[ 2*4 + r ] * v[ 2 ] + m[ 3*4 + r ] * v[ 3 ];
+	}
+
+	void Normalize( float * v )
+	{
+		float const length = sqrt( v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ] );
+		if( length > 0.f )
+			v[ 0 ] /= length, v[ 1 ] /= length, v[ 2 ] /= length;
+	}
+}
+
+Rasteriser * Rasteriser::Capture = NULL;
+
+struct Rasteriser::Worker
+{
+	Rasteriser * Self;
+	long volatile * Next;
+	unsigned long Fragments;
+
+	void Run()
+	{
+		//+4 so the 4-wide depth load at the end of the last row stays inside
+		PROFILE_SCOPE( "Rasteriser::Shade" );
+		std::vector< float > depth( TILE_SIZE * TILE_SIZE + 4 );
+		unsigned const tiles = (unsigned)Self->m_bins.size();
+		for( ;; )
+		{
+			unsigned const tile = (unsigned)AtomicIncrement( Next ) - 1;
+			if( tile >= tiles )
+				break;
+			Fragments += Self->ShadeTile( tile, &depth[ 0 ] );
+		}
+	}
+#ifdef _WIN32
+	static unsigned __stdcall Main( void * Param )
+	{
+		Profiler::NameThread( "rasteriser" );
+		static_cast< Worker * >( Param )->Run();
+		Profiler::EndThread();
+		return 0;
+	}
+#else
+	static void * Main( void * Param )
+	{
+		Profiler::NameThread( "rasteriser" );
+		static_cast< Worker * >( Param )->Run();
+		Profiler::EndThread();
+		return NULL;
+	}
+#endif
+};
+
+void Rasteriser::Texture::Sample( float s, float t, float Lod, float * Rgb ) const
+{
+	//GL_LINEAR when magnified and GL_LINEAR_MIPMAP_NEAREST when minified, with no offset between the two
+	size_t level = 0;
+	if( Lod > 0.5f )
+		level = std::min( (size_t)ceil( Lod + 0.5f ) - 1, Levels.size() - 1 );
+	Level const & image = Levels[ level ];
+
+	float const u = s * image.Width - 0.5f, v = t * image.Height - 0.5f;
+	float const fu = floor( u ), fv = floor( v );
+	float const a = u - fu, b = v - fv;
+	int const i0 = Wrap( (int)fu, image.Width ), i1 = Wrap( (int)fu + 1, image.Width );
+	int const j0 = Wrap( (int)fv, image.Height ), j1 = Wrap( (int)fv + 1, image.Height );
+	unsigned char const * const row0 = &image.Texels[ j0 * image.Width * 3 ];
+	unsigned char const * const row1 = &image.Texels[ j1 * image.Width * 3 ];
+	for( int c = 0; c < 3; ++c )
+	{
+		float const bottom = row0[ i0 * 3 + c ] + ( row0[ i1 * 3 + c ] - row0[ i0 * 3 + c ] ) * a;
+		float const top = row1[ i0 * 3 + c ] + ( row1[ i1 * 3 + c ] - row1[ i0 * 3 + c ] ) * a;
+		Rgb[ c ] = ( bottom + ( top - bottom ) * b ) * ( 1.f / 255.f );
+	}
+}
+
+Rasteriser::Rasteriser() : m_width( 0 ), m_height( 0 ), m_tilesx( 0 ), m_tilesy( 0 )
+{
+	memset( m_projection, 0, sizeof( m_projection ) );
+	memset( m_clear, 0, sizeof( m_clear ) );
+	memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+unsigned Rasteriser::CoreCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	return info.dwNumberOfProcessors;
+#else
+	long const cores = sysconf( _SC_NPROCESSORS_ONLN );
+	return cores > 0 ? (unsigned)cores : 1;
+#endif
+}
+
+void Rasteriser::Begin()
+{
+	//the program's viewport always starts at the window's corner
+	GLint viewport[ 4 ];
+	float clear[ 4 ];
+	glGetIntegerv( GL_VIEWPORT, viewport );
+	glGetFloatv( GL_PROJECTION_MATRIX, m_projection );
+	glGetFloatv( GL_COLOR_CLEAR_VALUE, clear );
+	for( int c = 0; c < 4; ++c )
+		m_clear[ c ] = (unsigned char)( Clamp( clear[ c ] ) * 255.f + 0.5f );
+
+	m_width = viewport[ 2 ];
+	m_height = viewport[ 3 ];
+	m_tilesx = ( m_width + TILE_SIZE - 1 ) / TILE_SIZE;
+	m_tilesy = ( m_height + TILE_SIZE - 1 ) / TILE_SIZE;
+	m_color.resize( m_width * m_height * 4 );
+	m_bins.resize( m_tilesx * m_tilesy );
+	for( size_t u = 0; u < m_bins.size(); ++u )
+		m_bins[ u ].clear(); //keeping their capacity from the last frame
+	m_triangles.clear();
+	memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+Rasteriser::Texture const * Rasteriser::FetchTexture( GLuint Name )
+{
+	std::map< GLuint, Texture >::iterator it = m_textures.find( Name );
+	if( it != m_textures.end() )
+		return it->second.Levels.empty() ? NULL : &it->second;
+
+	//the levels gluBuild2DMipmaps made, after it rescaled the image to powers of two
+	Texture & texture = m_textures[ Name ];
+	GLint alignment;
+	glGetIntegerv( GL_PACK_ALIGNMENT, &alignment );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	for( GLint level = 0; ; ++level )
+	{
+		Texture::Level image;
+		glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &image.Width );
+		glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &image.Height );
+		if( image.Width <= 0 || image.Height <= 0 )
+			break;
+		image.Texels.resize( image.Width * image.Height * 3 );
+		glGetTexImage( GL_TEXTURE_2D, level, GL_RGB, GL_UNSIGNED_BYTE, &image.Texels[ 0 ] );
+		texture.Levels.push_back( image );
+		if( image.Width == 1 && image.Height == 1 )
+			break;
+	}
+	glPixelStorei( GL_PACK_ALIGNMENT, alignment );
+	return texture.Levels.empty() ? NULL : &texture;
+}
+
+void Rasteriser::Draw( Mesh::Vertex const * Vertices, unsigned VertexCount, GLushort const * Indices, unsigned IndexCount, bool Textured )
+{
+	//the state this draw sees, as GL holds it
+	float modelview[ 16 ], color[ 4 ], texcoord[ 4 ], sceneambient[ 4 ];
+	float light[ 4 ][ 4 ], material[ 4 ][ 4 ], shininess, attenuation[ 3 ];
+	enum { AMBIENT, DIFFUSE, SPECULAR, POSITION, EMISSION = POSITION };
+	glGetFloatv( GL_MODELVIEW_MATRIX, modelview );
+	glGetFloatv( GL_CURRENT_COLOR, color );
+	glGetFloatv( GL_CURRENT_TEXTURE_COORDS, texcoord ); //for meshes without their own
+	bool const lighting = glIsEnabled( GL_LIGHTING ) == GL_TRUE;
+	bool const light0 = lighting && glIsEnabled( GL_LIGHT0 );
+	if( lighting )
+	{
+		glGetFloatv( GL_LIGHT_MODEL_AMBIENT, sceneambient );
+		glGetLightfv( GL_LIGHT0, GL_AMBIENT, light[ AMBIENT ] );
+		glGetLightfv( GL_LIGHT0, GL_DIFFUSE, light[ DIFFUSE ] );
+		glGetLightfv( GL_LIGHT0, GL_SPECULAR, light[ SPECULAR ] );
+		glGetLightfv( GL_LIGHT0, GL_POSITION, light[ POSITION ] ); //already in eye space
+		glGetLightfv( GL_LIGHT0, GL_CONSTANT_ATTENUATION, &attenuation[ 0 ] );
+		glGetLightfv( GL_LIGHT0, GL_LINEAR_ATTENUATION, &attenuation[ 1 ] );
+		glGetLightfv( GL_LIGHT0, GL_QUADRATIC_ATTENUATION, &attenuation[ 2 ] );
+		glGetMaterialfv( GL_FRONT, GL_AMBIENT, material[ AMBIENT ] );
+		glGetMaterialfv( GL_FRONT, GL_DIFFUSE, material[ DIFFUSE ] );
+		glGetMaterialfv( GL_FRONT, GL_SPECULAR, material[ SPECULAR ] );
+		glGetMaterialfv( GL_FRONT, GL_EMISSION, material[ EMISSION ] );
+		glGetMaterialfv( GL_FRONT, GL_SHININESS, &shininess );
+		if( glIsEnabled( GL_COLOR_MATERIAL ) ) //tracking GL_AMBIENT_AND_DIFFUSE, the default
+		{
+			memcpy( material[ AMBIENT ], color, sizeof( color ) );
+			memcpy( material[ DIFFUSE ], color, sizeof( color ) );
+		}
+	}
+	Triangle state;
+	state.Image = NULL;
+	if( glIsEnabled( GL_TEXTURE_2D ) )
+	{
+		GLint name;
+		glGetIntegerv( GL_TEXTURE_BINDING_2D, &name );
+		state.Image = FetchTexture( name );
+	}
+	state.Fog = glIsEnabled( GL_FOG ) == GL_TRUE;
+	if( state.Fog )
+	{
+		float start, fogcolor[ 4 ];
+		glGetFloatv( GL_FOG_START, &start );
+		glGetFloatv( GL_FOG_END, &state.FogEnd );
+		glGetFloatv( GL_FOG_COLOR, fogcolor );
+		memcpy( state.FogColor, fogcolor, sizeof( state.FogColor ) );
+		state.FogScale = 1.f / ( state.FogEnd - start );
+	}
+
+	double const start = Now();
+	float scene[ 3 ], ambient[ 3 ], diffuse[ 3 ], specular[ 3 ];
+	for( int c = 0; lighting && c < 3; ++c )
+	{
+		scene[ c ] = material[ EMISSION ][ c ] + sceneambient[ c ] * material[ AMBIENT ][ c ];
+		ambient[ c ] = light[ AMBIENT ][ c ] * material[ AMBIENT ][ c ];
+		diffuse[ c ] = light[ DIFFUSE ][ c ] * material[ DIFFUSE ][ c ];
+		specular[ c ] = light[ SPECULAR ][ c ] * material[ SPECULAR ][ c ];
+	}
+
+	//normals go through the inverse transpose of the modelview, which is its cofactor matrix over the determinant;
+	//GL_NORMALIZE takes care of the length, so only the determinant's sign is needed
+	float const * m = modelview;
+	float normal[ 9 ] =
+	{
+		m[ 5 ] * m[ 10 ] - m[ 9 ] * m[ 6 ], m[ 9 ] * m[ 2 ] - m[ 1 ] * m[ 10 ], m[ 1 ] * m[ 6 ] - m[ 5 ] * m[ 2 ],
+		m[ 8 ] * m[ 6 ] - m[ 4 ] * m[ 10 ], m[ 0 ] * m[ 10 ] - m[ 8 ] * m[ 2 ], m[ 4 ] * m[ 2 ] - m[ 0 ] * m[ 6 ],
+		m[ 4 ] * m[ 9 ] - m[ 8 ] * m[ 5 ], m[ 8 ] * m[ 1 ] - m[ 0 ] * m[ 9 ], m[ 0 ] * m[ 5 ] - m[ 4 ] * m[ 1 ]
+	};
+	if( m[ 0 ] * normal[ 0 ] + m[ 4 ] * normal[ 1 ] + m[ 8 ] * normal[ 2 ] < 0.f )
+		for( int k = 0; k < 9; ++k )
+			normal[ k ] = -normal[ k ];
+
+	m_transformed.resize( VertexCount );
+	for( unsigned u = 0; u < VertexCount; ++u )
+	{
+		Mesh::Vertex const & in = Vertices[ u ];
+		ClipVertex & out = m_transformed[ u ];
+		float const position[ 4 ] = { in.Position[ 0 ], in.Position[ 1 ], in.Position[ 2 ], 1.f };
+		float eye[ 4 ];
+		Transform( modelview, position, eye );
+		Transform( m_projection, eye, out.Position );
+
+		float * const rgb = out.Attributes;
+		if( lighting )
+		{
+			memcpy( rgb, scene, sizeof( scene ) );
+			float n[ 3 ];
+			for( int r = 0; r < 3; ++r )
+				n[ r ] = normal[ r * 3 + 0 ] * in.Normal[ 0 ] + normal[ r * 3 + 1 ] * in.Normal[ 1 ] + normal[ r * 3 + 2 ] * in.Normal[ 2 ];
+			Normalize( n );
+
+			float l[ 3 ], att = 1.f;
+			float const * const lp = light[ POSITION ];
+			if( lp[ 3 ] != 0.f )
+			{
+				for( int k = 0; k < 3; ++k )
+					l[ k ] = lp[ k ] / lp[ 3 ] - eye[ k ] / eye[ 3 ];
+				float const d = sqrt( l[ 0 ] * l[ 0 ] + l[ 1 ] * l[ 1 ] + l[ 2 ] * l[ 2 ] );
+				att = 1.f / ( attenuation[ 0 ] + attenuation[ 1 ] * d + attenuation[ 2 ] * d * d );
+			}
+			else
+				memcpy( l, lp, sizeof( l ) );
+			Normalize( l );
+
+			//an infinite viewer, so the half vector is against +z
+			float const ndotl = n[ 0 ] * l[ 0 ] + n[ 1 ] * l[ 1 ] + n[ 2 ] * l[ 2 ];
+			float h[ 3 ] = { l[ 0 ], l[ 1 ], l[ 2 ] + 1.f };
+			Normalize( h );
+			float const ndoth = n[ 0 ] * h[ 0 ] + n[ 1 ] * h[ 1 ] + n[ 2 ] * h[ 2 ];
+			float const diffusefac = ndotl > 0.f ? ndotl : 0.f;
+			float const specularfac = ndotl > 0.f && ndoth > 0.f ? pow( ndoth, shininess ) : 0.f;
+			for( int c = 0; light0 && c < 3; ++c )
+				rgb[ c ] += att * ( ambient[ c ] + diffusefac * diffuse[ c ] + specularfac * specular[ c ] );
+			for( int c = 0; c < 3; ++c )
+				rgb[ c ] = Clamp( rgb[ c ] );
+		}
+		else
+			memcpy( rgb, color, 3 * sizeof( float ) );
+
+		out.Attributes[ PLANE_S - PLANE_R ] = Textured ? in.TexCoord[ 0 ] : texcoord[ 0 ];
+		out.Attributes[ PLANE_T - PLANE_R ] = Textured ? in.TexCoord[ 1 ] : texcoord[ 1 ];
+		out.Attributes[ PLANE_FOG - PLANE_R ] = fabs( eye[ 2 ] / eye[ 3 ] );
+	}
+
+	if( !Indices )
+		IndexCount = VertexCount;
+	for( unsigned u = 0; u + 2 < IndexCount; u += 3 )
+	{
+		unsigned const a = Indices ? Indices[ u ] : u, b = Indices ? Indices[ u + 1 ] : u + 1, c = Indices ? Indices[ u + 2 ] : u + 2;
+		DrawTriangle( m_transformed[ a ], m_transformed[ b ], m_transformed[ c ], state );
+	}
+	m_stats.Triangles += IndexCount / 3;
+	m_stats.SetupSeconds += Now() - start;
+}
+
+void Rasteriser::DrawTriangle( ClipVertex const & a, ClipVertex const & b, ClipVertex const & c, Triangle const & State )
+{
+	//only the near plane is clipped against, that keeps w positive; the rest is left to the bounds and the depth test
+	ClipVertex const * const in[ 3 ] = { &a, &b, &c };
+	ClipVertex clipped[ 2 ];
+	ClipVertex const * out[ 4 ];
+	int count = 0, made = 0;
+	for( int i = 0; i < 3; ++i )
+	{
+		ClipVertex const & from = *in[ i ], & to = *in[ ( i + 1 ) % 3 ];
+		float const dfrom = from.Position[ 2 ] + from.Position[ 3 ], dto = to.Position[ 2 ] + to.Position[ 3 ];
+		if( dfrom >= 0.f )
+			out[ count++ ] = &from;
+		if( ( dfrom >= 0.f ) != ( dto >= 0.f ) )
+		{
+			float const t = dfrom / ( dfrom - dto );
+			ClipVertex & v = clipped[ made++ ];
+			for( int k = 0; k < 4; ++k )
+				v.Position[ k ] = from.Position[ k ] + ( to.Position[ k ] - from.Position[ k ] ) * t;
+			for( int k = 0; k < VERTEX_ATTRIBUTES; ++k )
+				v.Attributes[ k ] = from.Attributes[ k ] + ( to.Attributes[ k ] - from.Attributes[ k ] ) * t;
+			out[ count++ ] = &v;
+		}
+	}
+	if( count < 3 )
+		return;
+	SetupTriangle( out, State );
+	if( count == 4 )
+	{
+		ClipVertex const * const second[ 3 ] = { out[ 0 ], out[ 2 ], out[ 3 ] };
+		SetupTriangle( second, State );
+	}
+}
+
+void Rasteriser::SetupTriangle( ClipVertex const * const * Vertices, Triangle const & State )
+{
+	double x[ 3 ], y[ 3 ], values[ 3 ][ PLANE_COUNT ];
+	for( int i = 0; i < 3; ++i )
+	{
+		ClipVertex const & v = *Vertices[ i ];
+		double const q = 1.0 / v.Position[ 3 ];
+		x[ i ] = floor( ( v.Position[ 0 ] * q * 0.5 + 0.5 ) * m_width * SubPixels + 0.5 ) / SubPixels;
+		y[ i ] = floor( ( v.Position[ 1 ] * q * 0.5 + 0.5 ) * m_height * SubPixels + 0.5 ) / SubPixels;
+		values[ i ][ PLANE_Z ] = v.Position[ 2 ] * q * 0.5 + 0.5;
+		values[ i ][ PLANE_Q ] = q;
+		for( int k = 0; k < VERTEX_ATTRIBUTES; ++k )
+			values[ i ][ PLANE_R + k ] = v.Attributes[ k ] * q;
+	}
+
+	//nothing is culled, so both windings are made counter-clockwise
+	double area = ( x[ 1 ] - x[ 0 ] ) * ( y[ 2 ] - y[ 0 ] ) - ( x[ 2 ] - x[ 0 ] ) * ( y[ 1 ] - y[ 0 ] );
+	if( !( area != 0.0 ) )
+		return;
+	int order[ 3 ] = { 0, 1, 2 };
+	if( area < 0.0 )
+		order[ 1 ] = 2, order[ 2 ] = 1, area = -area;
+
+	Triangle tri = State;
+	tri.MinX = ClampToInt( ceil( std::min( x[ 0 ], std::min( x[ 1 ], x[ 2 ] ) ) - 0.5 ), 0, m_width );
+	tri.MaxX = ClampToInt( floor( std::max( x[ 0 ], std::max( x[ 1 ], x[ 2 ] ) ) - 0.5 ), -1, m_width - 1 );
+	tri.MinY = ClampToInt( ceil( std::min( y[ 0 ], std::min( y[ 1 ], y[ 2 ] ) ) - 0.5 ), 0, m_height );
+	tri.MaxY = ClampToInt( floor( std::max( y[ 0 ], std::max( y[ 1 ], y[ 2 ] ) ) - 0.5 ), -1, m_height - 1 );
+	if( tri.MinX > tri.MaxX || tri.MinY > tri.MaxY )
+		return;
+
+	//the edge opposite each vertex; with y up, left edges go down and top edges go left
+	tri.TopLeft = 0;
+	for( int k = 0; k < 3; ++k )
+	{
+		int const i = order[ ( k + 1 ) % 3 ], j = order[ ( k + 2 ) % 3 ];
+		double const A = y[ i ] - y[ j ], B = x[ j ] - x[ i ];
+		tri.Edge[ k ][ 0 ] = A;
+		tri.Edge[ k ][ 1 ] = B;
+		tri.Edge[ k ][ 2 ] = -( A * x[ i ] + B * y[ i ] );
+		if( A > 0.0 || ( A == 0.0 && B < 0.0 ) )
+			tri.TopLeft |= 1 << k;
+	}
+
+	int const i0 = order[ 0 ], i1 = order[ 1 ], i2 = order[ 2 ];
+	for( int p = 0; p < PLANE_COUNT; ++p )
+	{
+		double const d1 = values[ i1 ][ p ] - values[ i0 ][ p ], d2 = values[ i2 ][ p ] - values[ i0 ][ p ];
+		double const gx = ( d1 * ( y[ i2 ] - y[ i0 ] ) - d2 * ( y[ i1 ] - y[ i0 ] ) ) / area;
+		double const gy = ( d2 * ( x[ i1 ] - x[ i0 ] ) - d1 * ( x[ i2 ] - x[ i0 ] ) ) / area;
+		tri.Plane[ p ][ 0 ] = gx;
+		tri.Plane[ p ][ 1 ] = gy;
+		tri.Plane[ p ][ 2 ] = values[ i0 ][ p ] - gx * x[ i0 ] - gy * y[ i0 ];
+	}
+
+	unsigned const index = (unsigned)m_triangles.size();
+	m_triangles.push_back( tri );
+	++m_stats.Binned;
+	for( int ty = tri.MinY / TILE_SIZE; ty <= tri.MaxY / TILE_SIZE; ++ty )
+		for( int tx = tri.MinX / TILE_SIZE; tx <= tri.MaxX / TILE_SIZE; ++tx )
+		{
+			//skip tiles wholly outside an edge, by testing the pixel centre furthest inside it
+			bool outside = false;
+			for( int k = 0; k < 3 && !outside; ++k )
+			{
+				double const cx = tx * TILE_SIZE + ( tri.Edge[ k ][ 0 ] > 0.0 ? TILE_SIZE - 0.5 : 0.5 );
+				double const cy = ty * TILE_SIZE + ( tri.Edge[ k ][ 1 ] > 0.0 ? TILE_SIZE - 0.5 : 0.5 );
+				outside = tri.Edge[ k ][ 0 ] * cx + tri.Edge[ k ][ 1 ] * cy + tri.Edge[ k ][ 2 ] < 0.0;
+			}
+			if( !outside )
+				m_bins[ ty * m_tilesx + tx ].push_back( index );
+		}
+}
+
+double Rasteriser::Render( unsigned Threads )
+{
+	PROFILE_SCOPE( "Rasteriser::Render" );
+	if( !Threads )
+		Threads = CoreCount();
+	double const start = Now();
+
+	long volatile next = 0;
+	std::vector< Worker > workers( Threads );
+	for( unsigned u = 0; u < Threads; ++u )
+	{
+		workers[ u ].Self = this;
+		workers[ u ].Next = &next;
+		workers[ u ].Fragments = 0;
+	}
+	//a thread that fails to start just leaves its share to the others
+#ifdef _WIN32
+	std::vector< HANDLE > threads;
+	for( unsigned u = 1; u < Threads; ++u )
+	{
+		uintptr_t const thread = _beginthreadex( NULL, 0, &Worker::Main, &workers[ u ], 0, NULL );
+		if( thread )
+			threads.push_back( (HANDLE)thread );
+	}
+	workers[ 0 ].Run();
+	for( size_t u = 0; u < threads.size(); ++u )
+	{
+		WaitForSingleObject( threads[ u ], INFINITE );
+		CloseHandle( threads[ u ] );
+	}
+#else
+	std::vector< pthread_t > threads;
+	for( unsigned u = 1; u < Threads; ++u )
+	{
+		pthread_t thread;
+		if( !pthread_create( &thread, NULL, &Worker::Main, &workers[ u ] ) )
+			threads.push_back( thread );
+	}
+	workers[ 0 ].Run();
+	for( size_t u = 0; u < threads.size(); ++u )
+		pthread_join( threads[ u ], NULL );
+#endif
+
+	m_stats.Fragments = 0;
+	for( unsigned u = 0; u < Threads; ++u )
+		m_stats.Fragments += workers[ u ].Fragments;
+	return Now() - start;
+}
+
+unsigned long Rasteriser::ShadeTile( unsigned Tile, float * Depth )
+{
+	int const left = Tile % m_tilesx * TILE_SIZE, bottom = Tile / m_tilesx * TILE_SIZE;
+	int const right = std::min( left + TILE_SIZE, m_width ) - 1, top = std::min( bottom + TILE_SIZE, m_height ) - 1;
+	for( int y = bottom; y <= top; ++y )
+	{
+		unsigned char * color = &m_color[ ( y * m_width + left ) * 4 ];
+		float * depth = Depth + ( y - bottom ) * TILE_SIZE;
+		for( int x = left; x <= right; ++x, color += 4 )
+			memcpy( color, m_clear, 4 ), *depth++ = 1.f;
+	}
+
+	unsigned long fragments = 0;
+	std::vector< unsigned > const & bin = m_bins[ Tile ];
+	for( size_t u = 0; u < bin.size(); ++u )
+	{
+		Triangle const & tri = m_triangles[ bin[ u ] ];
+		int const x0 = std::max( left, tri.MinX ), x1 = std::min( right, tri.MaxX );
+		int const y0 = std::max( bottom, tri.MinY ), y1 = std::min( top, tri.MaxY );
+		for( int y = y0; y <= y1; ++y )
+			fragments += ShadeSpan( tri, x0, x1, y, Depth + ( y - bottom ) * TILE_SIZE + ( x0 - left ) );
+	}
+	return fragments;
+}
+
+unsigned long Rasteriser::ShadeSpan( Triangle const & Tri, int x0, int x1, int y, float * Depth )
+{
+	//everything is evaluated at the span's first pixel centre in double, the planes of a triangle that was
+	//clipped can be a long way from it, then stepped across the span in float
+	double const px = x0 + 0.5, py = y + 0.5;
+	float edge[ 3 ], edgestep[ 3 ], base[ PLANE_COUNT ], step[ PLANE_COUNT ];
+	for( int k = 0; k < 3; ++k )
+	{
+		edge[ k ] = (float)( Tri.Edge[ k ][ 0 ] * px + Tri.Edge[ k ][ 1 ] * py + Tri.Edge[ k ][ 2 ] );
+		edgestep[ k ] = (float)Tri.Edge[ k ][ 0 ];
+	}
+	for( int p = 0; p < PLANE_COUNT; ++p )
+	{
+		base[ p ] = (float)( Tri.Plane[ p ][ 0 ] * px + Tri.Plane[ p ][ 1 ] * py + Tri.Plane[ p ][ 2 ] );
+		step[ p ] = (float)Tri.Plane[ p ][ 0 ];
+	}
+
+	unsigned char * const color = &m_color[ ( y * m_width + x0 ) * 4 ];
+	int const count = x1 - x0 + 1;
+	unsigned long fragments = 0;
+#ifdef RASTERISER_SSE2
+	//four pixels at a time: the edge functions, the depth range and the depth test give a coverage mask, and only
+	//the pixels left in it are shaded
+	__m128 const lanes = _mm_setr_ps( 0.f, 1.f, 2.f, 3.f ), zero = _mm_setzero_ps(), one = _mm_set1_ps( 1.f );
+	__m128 e[ 3 ], a[ 3 ], owns[ 3 ];
+	for( int k = 0; k < 3; ++k )
+	{
+		e[ k ] = _mm_set1_ps( edge[ k ] );
+		a[ k ] = _mm_set1_ps( edgestep[ k ] );
+		owns[ k ] = _mm_castsi128_ps( _mm_set1_epi32( Tri.TopLeft >> k & 1 ? -1 : 0 ) );
+	}
+	__m128 const z0 = _mm_set1_ps( base[ PLANE_Z ] ), dz = _mm_set1_ps( step[ PLANE_Z ] );
+	for( int i = 0; i < count; i += 4 )
+	{
+		__m128 const xs = _mm_add_ps( lanes, _mm_set1_ps( (float)i ) );
+		__m128 const z = _mm_add_ps( z0, _mm_mul_ps( dz, xs ) );
+		__m128 mask = _mm_and_ps( _mm_cmpge_ps( z, zero ), _mm_cmple_ps( z, one ) );
+		for( int k = 0; k < 3; ++k )
+		{
+			__m128 const ek = _mm_add_ps( e[ k ], _mm_mul_ps( a[ k ], xs ) );
+			mask = _mm_and_ps( mask, _mm_or_ps( _mm_cmpgt_ps( ek, zero ), _mm_and_ps( _mm_cmpeq_ps( ek, zero ), owns[ k ] ) ) );
+		}
+		mask = _mm_and_ps( mask, _mm_cmplt_ps( z, _mm_loadu_ps( Depth + i ) ) );
+		int bits = _mm_movemask_ps( mask );
+		if( count - i < 4 )
+			bits &= ( 1 << ( count - i ) ) - 1;
+		if( !bits )
+			continue;
+
+		float zs[ 4 ];
+		_mm_storeu_ps( zs, z );
+		for( int lane = 0; lane < 4; ++lane )
+			if( bits >> lane & 1 )
+			{
+				Depth[ i + lane ] = zs[ lane ];
+				ShadePixel( Tri, base, step, (float)( i + lane ), color + ( i + lane ) * 4 );
+				++fragments;
+			}
+	}
+#else
+	for( int i = 0; i < count; ++i )
+	{
+		float const fi = (float)i;
+		bool inside = true;
+		for( int k = 0; k < 3; ++k )
+		{
+			float const e = edge[ k ] + edgestep[ k ] * fi;
+			inside = inside && ( e > 0.f || ( e == 0.f && ( Tri.TopLeft >> k & 1 ) ) );
+		}
+		float const z = base[ PLANE_Z ] + step[ PLANE_Z ] * fi;
+		if( !inside || z < 0.f || z > 1.f || !( z < Depth[ i ] ) )
+			continue;
+		Depth[ i ] = z;
+		ShadePixel( Tri, base, step, fi, color + i * 4 );
+		++fragments;
+	}
+#endif
+	return fragments;
+}
+
+void Rasteriser::ShadePixel( Triangle const & Tri, float const * Base, float const * Step, float i, unsigned char * Out )
+{
+	float const w = 1.f / ( Base[ PLANE_Q ] + Step[ PLANE_Q ] * i );
+	float rgb[ 3 ];
+	for( int c = 0; c < 3; ++c )
+		rgb[ c ] = ( Base[ PLANE_R + c ] + Step[ PLANE_R + c ] * i ) * w;
+
+	if( Tri.Image )
+	{
+		//GL_MODULATE, with the mip level from the screen space derivatives of s and t; the interpolated value is
+		//P / Q for linear P and Q, so its derivative is ( P' - value * Q' ) / Q
+		float const s = ( Base[ PLANE_S ] + Step[ PLANE_S ] * i ) * w;
+		float const t = ( Base[ PLANE_T ] + Step[ PLANE_T ] * i ) * w;
+		float const qy = (float)Tri.Plane[ PLANE_Q ][ 1 ];
+		float const width = (float)Tri.Image->Levels[ 0 ].Width, height = (float)Tri.Image->Levels[ 0 ].Height;
+		float const dudx = ( Step[ PLANE_S ] - s * Step[ PLANE_Q ] ) * w * width;
+		float const dvdx = ( Step[ PLANE_T ] - t * Step[ PLANE_Q ] ) * w * height;
+		float const dudy = ( (float)Tri.Plane[ PLANE_S ][ 1 ] - s * qy ) * w * width;
+		float const dvdy = ( (float)Tri.Plane[ PLANE_T ][ 1 ] - t * qy ) * w * height;
+		float const rho = std::max( dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy );
+		float texel[ 3 ];
+		Tri.Image->Sample( s, t, 0.5f * log( rho ) * 1.44269504f, texel ); //log2 of the square root
+		for( int c = 0; c < 3; ++c )
+			rgb[ c ] *= texel[ c ];
+	}
+	if( Tri.Fog )
+	{
+		float const distance = ( Base[ PLANE_FOG ] + Step[ PLANE_FOG ] * i ) * w;
+		float const f = Clamp( ( Tri.FogEnd - distance ) * Tri.FogScale );
+		for( int c = 0; c < 3; ++c )
+			rgb[ c ] = f * rgb[ c ] + ( 1.f - f ) * Tri.FogColor[ c ];
+	}
+	for( int c = 0; c < 3; ++c )
+		Out[ c ] = (unsigned char)( Clamp( rgb[ c ] ) * 255.f + 0.5f );
+	Out[ 3 ] = 255;
+}
@@ -0,0 +1,461 @@
+#include <recorder.h>
+#include <GL/freeglut.h>
+#include <profiler.h>
+#include <gltrace.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+#ifdef _WIN32
+#include <process.h> //freeglut has brought in windows.h
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	double Now()
+	{
+		return glutGetElapsedTimeNs() * 1e-9;
+	}
+
+	//a PPM pattern may hold one %d, with an optional width, and nothing else for printf to trip over
+	bool ValidPattern( char const * Path )
+	{
+		char const * percent = strchr( Path, '%' );
+		if( !percent )
+			return true;
+		char const * p = percent + 1;
+		while( *p >= '0' && *p <= '9' )
+			++p;
+		return *p == 'd' && !strchr( p, '%' );
+	}
+}
+
+struct Recorder::Shared
+{
+	Recorder * Self;
+#ifdef _WIN32
+	CRITICAL_SECTION Lock;
+	CONDITION_VARIABLE Wake;
+	HANDLE Thread;
+#else
+	pthread_mutex_t Lock;
+	pthread_cond_t Wake;
+	pthread_t Thread;
+#endif
+	bool Running;
+	bool Stopping;
+	bool Failed; //the writer could not write, everything after is dropped
+	std::vector< std::vector< unsigned char > > Buffers; //QUEUE_SIZE frames
+	std::vector< int > Free;
+	std::deque< int > Queued;
+	std::vector< unsigned char > Planes; //the writer's Y4M conversion
+	Stats Counts;
+
+	void Enter()
+	{
+#ifdef _WIN32
+		EnterCriticalSection( &Lock );
+#else
+		pthread_mutex_lock( &Lock );
+#endif
+	}
+	void Leave()
+	{
+#ifdef _WIN32
+		LeaveCriticalSection( &Lock );
+#else
+		pthread_mutex_unlock( &Lock );
+#endif
+	}
+	void Signal()
+	{
+#ifdef _WIN32
+		WakeConditionVariable( &Wake );
+#else
+		pthread_cond_signal( &Wake );
+#endif
+	}
+	void Wait() //with the lock held
+	{
+#ifdef _WIN32
+		SleepConditionVariableCS( &Wake, &Lock, INFINITE );
+#else
+		pthread_cond_wait( &Wake, &Lock );
+#endif
+	}
+	void Run()
+	{
+		Enter();
+		for( ;; )
+		{
+			while( Queued.empty() && !Stopping )
+				Wait();
+			if( Queued.empty() )
+				break;
+			int const buffer = Queued.front();
+			Queued.pop_front();
+			unsigned const number = Counts.Written; //only this thread changes it
+			bool const failed = Failed;
+			Leave();
+
+			bool written;
+			{
+				PROFILE_SCOPE( "Recorder::Write" );
+				written = !failed && Self->Write( &Buffers[ buffer ][ 0 ], number );
+			}
+
+			Enter();
+			if( written )
+				++Counts.Written;
+			else
+			{
+				if( !Failed )
+					fprintf( stderr, "recording stopped, could not write frame %u\n", number );
+				Failed = true;
+				++Counts.Dropped;
+			}
+			Free.push_back( buffer );
+		}
+		Leave();
+	}
+#ifdef _WIN32
+	static unsigned __stdcall Main( void * Param )
+	{
+		Profiler::NameThread( "recorder" );
+		static_cast< Shared * >( Param )->Run();
+		Profiler::EndThread();
+		return 0;
+	}
+#else
+	static void * Main( void * Param )
+	{
+		Profiler::NameThread( "recorder" );
+		static_cast< Shared * >( Param )->Run();
+		Profiler::EndThread();
+		return NULL;
+	}
+#endif
+};
+
+Recorder * Recorder::FromCommandLine( int & argc, char ** argv )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( argv[ i ], "-record" ) )
+			continue;
+
+		if( i + 1 >= argc )
+		{
+			printf( "-record needs a path: a .y4m file or - (stdout) for a Y4M stream, anything else for a PPM sequence\n" );
+			exit( 1 );
+		}
+		char const * const path = argv[ i + 1 ];
+		size_t const length = strlen( path );
+		Format const format = !strcmp( path, "-" ) || ( length > 4 && !strcmp( path + length - 4, ".y4m" ) ) ? Y4M_FORMAT : PPM_FORMAT;
+		Recorder * recorder = new Recorder( path, format );
+		if( !recorder->IsOpen() )
+		{
+			printf( "could not record to \"%s\"\n", path );
+			exit( 1 );
+		}
+
+		for( int j = i + 2; j <= argc; ++j )
+			argv[ j - 2 ] = argv[ j ];
+		argc -= 2;
+		return recorder;
+	}
+	return NULL;
+}
+
+Recorder::Recorder( char const * Path, Format OutputFormat ) : m_format( OutputFormat ), m_file( NULL ),
+	m_width( 0 ), m_height( 0 ), m_finished( false ), m_oldest( 0 ), m_pending( 0 ), m_shared( new Shared )
+{
+	memset( m_buffers, 0, sizeof( m_buffers ) );
+	memset( m_issued, 0, sizeof( m_issued ) );
+	m_path[ 0 ] = 0;
+	if( strlen( Path ) + sizeof( "%05d.ppm" ) <= sizeof( m_path ) )
+		strcpy( m_path, Path );
+
+	m_shared->Self = this;
+	m_shared->Running = m_shared->Stopping = m_shared->Failed = false;
+	memset( &m_shared->Counts, 0, sizeof( m_shared->Counts ) );
+#ifdef _WIN32
+	InitializeCriticalSection( &m_shared->Lock );
+	InitializeConditionVariable( &m_shared->Wake );
+#else
+	pthread_mutex_init( &m_shared->Lock, NULL );
+	pthread_cond_init( &m_shared->Wake, NULL );
+#endif
+
+	if( m_format == PPM_FORMAT )
+	{
+		if( !ValidPattern( m_path ) )
+			m_path[ 0 ] = 0;
+		else if( m_path[ 0 ] && !strchr( m_path, '%' ) )
+			strcat( m_path, "%05d.ppm" );
+	}
+	else if( !strcmp( Path, "-" ) )
+	{
+		//the stream gets stdout's descriptor to itself, and whatever the program prints goes to stderr instead
+		fflush( stdout );
+#ifdef _WIN32
+		int const fd = _dup( 1 );
+		_dup2( 2, 1 );
+		_setmode( fd, _O_BINARY );
+		m_file = fd < 0 ? NULL : _fdopen( fd, "wb" );
+#else
+		int const fd = dup( 1 );
+		dup2( 2, 1 );
+		m_file = fd < 0 ? NULL : fdopen( fd, "wb" );
+#endif
+	}
+	else if( m_path[ 0 ] )
+		m_file = fopen( m_path, "wb" );
+}
+
+Recorder::~Recorder()
+{
+	Finish();
+#ifdef _WIN32
+	DeleteCriticalSection( &m_shared->Lock );
+#else
+	pthread_mutex_destroy( &m_shared->Lock );
+	pthread_cond_destroy( &m_shared->Wake );
+#endif
+	delete m_shared;
+}
+
+Recorder::Stats Recorder::GetStats() const
+{
+	m_shared->Enter();
+	Stats const stats = m_shared->Counts;
+	m_shared->Leave();
+	return stats;
+}
+
+void Recorder::Start( int Width, int Height )
+{
+	m_width = Width;
+	m_height = Height;
+	m_shared->Buffers.resize( QUEUE_SIZE );
+	for( int u = 0; u < QUEUE_SIZE; ++u )
+	{
+		m_shared->Buffers[ u ].resize( Width * Height * 4 );
+		m_shared->Free.push_back( u );
+	}
+
+	if( GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object )
+	{
+		glGenBuffers( RING_SIZE, m_buffers );
+		for( int u = 0; u < RING_SIZE; ++u )
+		{
+			glBindBuffer( GL_PIXEL_PACK_BUFFER, m_buffers[ u ] );
+			glBufferData( GL_PIXEL_PACK_BUFFER, Width * Height * 4, NULL, GL_STREAM_READ );
+		}
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	}
+	else
+		printf( "No pixel buffer objects, recorded frames are read back synchronously\n" );
+
+#ifdef _WIN32
+	uintptr_t const thread = _beginthreadex( NULL, 0, &Shared::Main, m_shared, 0, NULL );
+	m_shared->Thread = (HANDLE)thread;
+	m_shared->Running = thread != 0;
+#else
+	m_shared->Running = !pthread_create( &m_shared->Thread, NULL, &Shared::Main, m_shared );
+#endif
+	if( !m_shared->Running )
+		printf( "Could not start the recording thread\n" );
+}
+
+void Recorder::Capture()
+{
+	if( m_finished || !IsOpen() )
+		return;
+	PROFILE_SCOPE( "Recorder::Capture" );
+
+	//the program's viewport always covers the window
+	GLint viewport[ 4 ];
+	glGetIntegerv( GL_VIEWPORT, viewport );
+	if( !m_width )
+		Start( viewport[ 2 ], viewport[ 3 ] );
+	if( viewport[ 2 ] != m_width || viewport[ 3 ] != m_height || !m_shared->Running )
+	{
+		Submit( -1, 0.0, 0.0 );
+		return;
+	}
+
+	if( !m_buffers[ 0 ] )
+	{
+		double const start = Now();
+		int const buffer = Acquire();
+		if( buffer >= 0 )
+			glReadPixels( 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, &m_shared->Buffers[ buffer ][ 0 ] );
+		double const elapsed = Now() - start;
+		Submit( buffer, elapsed, elapsed );
+		return;
+	}
+
+	//the slot about to be reused was read RING_SIZE - 1 frames ago
+	if( m_pending == RING_SIZE )
+		Collect();
+	unsigned const slot = ( m_oldest + m_pending ) % RING_SIZE;
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, m_buffers[ slot ] );
+	glReadPixels( 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	m_issued[ slot ] = Now();
+	++m_pending;
+}
+
+void Recorder::Collect()
+{
+	unsigned const slot = m_oldest;
+	m_oldest = ( m_oldest + 1 ) % RING_SIZE;
+	--m_pending;
+
+	double const start = Now();
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, m_buffers[ slot ] );
+	void const * pixels = glMapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY );
+	double const mapped = Now();
+	int buffer = -1;
+	if( pixels )
+	{
+		buffer = Acquire();
+		if( buffer >= 0 )
+			memcpy( &m_shared->Buffers[ buffer ][ 0 ], pixels, m_width * m_height * 4 );
+		glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+	}
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	Submit( buffer, mapped - m_issued[ slot ], mapped - start );
+}
+
+int Recorder::Acquire()
+{
+	m_shared->Enter();
+	int buffer = -1;
+	if( !m_shared->Free.empty() )
+	{
+		buffer = m_shared->Free.back();
+		m_shared->Free.pop_back();
+	}
+	m_shared->Leave();
+	return buffer;
+}
+
+void Recorder::Submit( int Buffer, double Latency, double Stall )
+{
+	m_shared->Enter();
+	Stats & counts = m_shared->Counts;
+	if( Buffer >= 0 )
+	{
+		++counts.Captured;
+		counts.Latency += Latency;
+		counts.MaxLatency = Latency > counts.MaxLatency ? Latency : counts.MaxLatency;
+		counts.Stall += Stall;
+		m_shared->Queued.push_back( Buffer );
+		m_shared->Signal();
+	}
+	else
+		++counts.Dropped;
+	m_shared->Leave();
+}
+
+void Recorder::Finish()
+{
+	if( m_finished )
+		return;
+	m_finished = true;
+
+	while( m_pending )
+		Collect();
+	if( m_shared->Running )
+	{
+		m_shared->Enter();
+		m_shared->Stopping = true;
+		m_shared->Signal();
+		m_shared->Leave();
+#ifdef _WIN32
+		WaitForSingleObject( m_shared->Thread, INFINITE );
+		CloseHandle( m_shared->Thread );
+#else
+		pthread_join( m_shared->Thread, NULL );
+#endif
+		m_shared->Running = false;
+	}
+	if( m_buffers[ 0 ] )
+		glDeleteBuffers( RING_SIZE, m_buffers );
+	memset( m_buffers, 0, sizeof( m_buffers ) );
+	if( m_file )
+		fclose( m_file );
+	m_file = NULL;
+
+	//stdout may be the stream
+	Stats const stats = GetStats();
+	fprintf( stderr, "recorded %u of %u frames, %u dropped, readback latency %.2f ms mean %.2f ms max, %.3f ms mean map stall\n",
+		stats.Written, stats.Captured, stats.Dropped, stats.Captured ? stats.Latency * 1000.0 / stats.Captured : 0.0,
+		stats.MaxLatency * 1000.0, stats.Captured ? stats.Stall * 1000.0 / stats.Captured : 0.0 );
+}
+
+bool Recorder::Write( unsigned char const * Pixels, unsigned Number )
+{
+	int const width = m_width, height = m_height;
+	std::vector< unsigned char > & planes = m_shared->Planes;
+	if( m_format == PPM_FORMAT )
+	{
+		char name[ sizeof( m_path ) + 16 ];
+		sprintf( name, m_path, Number );
+		FILE * file = fopen( name, "wb" );
+		if( !file )
+			return false;
+		fprintf( file, "P6\n%d %d\n255\n", width, height );
+		planes.resize( width * 3 );
+		for( int y = height - 1; y >= 0; --y ) //GL's rows are bottom first
+		{
+			unsigned char const * in = Pixels + y * width * 4;
+			for( int x = 0; x < width; ++x )
+				memcpy( &planes[ x * 3 ], in + x * 4, 3 );
+			fwrite( &planes[ 0 ], 3, width, file );
+		}
+		bool const written = !ferror( file );
+		return !fclose( file ) && written;
+	}
+
+	if( !Number && fprintf( m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, (int)FRAME_RATE ) < 0 )
+		return false;
+
+	//full range BT.601 as JPEG has it, in 8.8 fixed point, with chroma from the average of each 2x2 block
+	int const chromawidth = ( width + 1 ) / 2, chromaheight = ( height + 1 ) / 2;
+	planes.resize( width * height + 2 * chromawidth * chromaheight );
+	unsigned char * y = &planes[ 0 ];
+	unsigned char * cb = y + width * height;
+	unsigned char * cr = cb + chromawidth * chromaheight;
+	for( int row = 0; row < height; ++row )
+	{
+		unsigned char const * in = Pixels + ( height - 1 - row ) * width * 4;
+		for( int x = 0; x < width; ++x, in += 4 )
+			*y++ = (unsigned char)( ( 77 * in[ 0 ] + 150 * in[ 1 ] + 29 * in[ 2 ] + 128 ) >> 8 );
+	}
+	for( int row = 0; row < chromaheight; ++row )
+	{
+		unsigned char const * in0 = Pixels + ( height - 1 - 2 * row ) * width * 4;
+		unsigned char const * in1 = 2 * row + 1 < height ? in0 - width * 4 : in0;
+		for( int x = 0; x < chromawidth; ++x )
+		{
+			int const left = 2 * x * 4, right = 2 * x + 1 < width ? left + 4 : left;
+			int rgb[ 3 ];
+			for( int c = 0; c < 3; ++c )
+				rgb[ c ] = ( in0[ left + c ] + in0[ right + c ] + in1[ left + c ] + in1[ right + c ] + 2 ) >> 2;
+			int const u = ( -43 * rgb[ 0 ] - 85 * rgb[ 1 ] + 128 * rgb[ 2 ] + ( 128 << 8 ) + 128 ) >> 8;
+			int const v = ( 128 * rgb[ 0 ] - 107 * rgb[ 1 ] - 21 * rgb[ 2 ] + ( 128 << 8 ) + 128 ) >> 8;
+			*cb++ = (unsigned char)( u > 255 ? 255 : u );
+			*cr++ = (unsigned char)( v > 255 ? 255 : v );
+		}
+	}
+	fputs( "FRAME\n", m_file );
+	return fwrite( &planes[ 0 ], 1, planes.size(), m_file ) == planes.size();
+}
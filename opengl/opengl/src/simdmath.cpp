@@ -0,0 +1,62 @@
+#include <simdmath.h>
+
+float const Simd::PI = 3.14159265358979f;
+
+void Simd::TransformCoords( Mat4 const & m, Vec3 const * In, Vec3 * Out, int Count )
+{
+	//a point at a time, as a column per coordinate already has the matrix work in whole registers
+	Register const c0 = m.Column( 0 ), c1 = m.Column( 1 ), c2 = m.Column( 2 ), c3 = m.Column( 3 );
+	for( int i = 0; i < Count; ++i )
+	{
+		Register const p = In[ i ].Get();
+		Register const out = Add( Add( Multiply( c0, Shuffle< 0, 0, 0, 0 >( p ) ), Multiply( c1, Shuffle< 1, 1, 1, 1 >( p ) ) ),
+			Add( Multiply( c2, Shuffle< 2, 2, 2, 2 >( p ) ), c3 ) );
+		Register const w = Shuffle< 3, 3, 3, 3 >( out );
+		Out[ i ] = First( w ) ? Vec3( Divide( out, w ) ) : Vec3( 0.f, 0.f, 0.f );
+	}
+}
+
+void Simd::Normalize( Vec3 const * In, Vec3 * Out, int Count )
+{
+	int i = 0;
+	for( ; i + 4 <= Count; i += 4 )
+	{
+		Register x = In[ i ].Get(), y = In[ i + 1 ].Get(), z = In[ i + 2 ].Get(), w = In[ i + 3 ].Get();
+		Transpose( x, y, z, w );
+		Register const length = SquareRoot( Add( Add( Multiply( x, x ), Multiply( y, y ) ), Multiply( z, z ) ) );
+		x = Divide( x, length );
+		y = Divide( y, length );
+		z = Divide( z, length );
+		Transpose( x, y, z, w );
+		Out[ i ] = Vec3( x );
+		Out[ i + 1 ] = Vec3( y );
+		Out[ i + 2 ] = Vec3( z );
+		Out[ i + 3 ] = Vec3( w );
+	}
+	for( ; i < Count; ++i )
+		Out[ i ] = Normalize( In[ i ] );
+}
+
+void Simd::Multiply( Quat const * A, Quat const * B, Quat * Out, int Count )
+{
+	int i = 0;
+	for( ; i + 4 <= Count; i += 4 )
+	{
+		Register ax = A[ i ].Get(), ay = A[ i + 1 ].Get(), az = A[ i + 2 ].Get(), aw = A[ i + 3 ].Get();
+		Register bx = B[ i ].Get(), by = B[ i + 1 ].Get(), bz = B[ i + 2 ].Get(), bw = B[ i + 3 ].Get();
+		Transpose( ax, ay, az, aw );
+		Transpose( bx, by, bz, bw );
+		//QuaternionMultiply's sums, four products each
+		Register x = Add( Subtract( Add( Multiply( ax, bw ), Multiply( ay, bz ) ), Multiply( az, by ) ), Multiply( aw, bx ) );
+		Register y = Add( Add( Subtract( Multiply( ay, bw ), Multiply( ax, bz ) ), Multiply( az, bx ) ), Multiply( aw, by ) );
+		Register z = Add( Add( Subtract( Multiply( ax, by ), Multiply( ay, bx ) ), Multiply( az, bw ) ), Multiply( aw, bz ) );
+		Register w = Subtract( Subtract( Subtract( Multiply( aw, bw ), Multiply( ax, bx ) ), Multiply( ay, by ) ), Multiply( az, bz ) );
+		Transpose( x, y, z, w );
+		Out[ i ] = Quat( x );
+		Out[ i + 1 ] = Quat( y );
+		Out[ i + 2 ] = Quat( z );
+		Out[ i + 3 ] = Quat( w );
+	}
+	for( ; i < Count; ++i )
+		Out[ i ] = Multiply( A[ i ], B[ i ] );
+}